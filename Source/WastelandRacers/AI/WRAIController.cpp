@@ -1,6 +1,11 @@
 #include "WRAIController.h"
 #include "WastelandRacers/Vehicles/WRKart.h"
 #include "WastelandRacers/Weapons/WRWeaponComponent.h"
+#include "WastelandRacers/Core/WRGameplayProfiler.h"
+#include "WastelandRacers/Gameplay/WRRaceManager.h"
+#include "WastelandRacers/AI/WRRacingLineData.h"
+#include "WastelandRacers/Gameplay/WRRaceWorldSubsystem.h"
+#include "WastelandRacers/Tracks/WRShortcutSystem.h"
 #include "Engine/Engine.h"
 #include "NavigationSystem.h"
 
@@ -13,148 +18,327 @@ void AWRAIController::BeginPlay()
 {
 	Super::BeginPlay();
 	ControlledKart = Cast<AWRKart>(GetPawn());
+	RandomStream = FWRGameplayRandom::MakeStream(this);
+
+	// Driven in one batch with every other AI kart
+	if (UWRAIDrivingSubsystem* Driving = UWRAIDrivingSubsystem::GetInstance(this))
+	{
+		Driving->RegisterController(this);
+		SetActorTickEnabled(false);
+	}
+}
+
+void AWRAIController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UWRAIDrivingSubsystem* Driving = UWRAIDrivingSubsystem::GetInstance(this))
+	{
+		Driving->UnregisterController(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AWRAIController::OnPossess(APawn* InPawn)
+{
+	Super::OnPossess(InPawn);
+
+	// Karts spawned after BeginPlay are only known once possessed
+	ControlledKart = Cast<AWRKart>(InPawn);
 }
 
 void AWRAIController::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+	// Only reached without a driving subsystem; drive as a batch of one
+	WR_PROFILE_SCOPE(AI);
+
 	if (!ControlledKart)
 		return;
 
-	UpdateMovement(DeltaTime);
-	UpdateWeaponUsage(DeltaTime);
-	UpdateDrifting(DeltaTime);
+	TArray<float> HumanRaceDistances;
+	TArray<FVector> HumanLocations;
+	FWRAILOD::GatherHumanKarts(GetWorld(), RaceManager, HumanRaceDistances, HumanLocations);
+	if (!AdvanceLOD(DeltaTime, FWRAILOD::GetDistanceToNearestHuman(ControlledKart, RaceManager, HumanRaceDistances, HumanLocations)))
+		return;
 
-	if (bEnableRubberBanding)
-	{
-		ApplyRubberBanding();
-	}
+	SoloOvertakingBatch.GatherTraffic(RaceManager);
+	SoloOvertakingBatch.SetNum(1);
+	GatherOvertakingState(SoloOvertakingBatch, 0);
+	SoloOvertakingBatch.Plan(0, 1);
+	ApplyOvertakingOutputs(SoloOvertakingBatch, 0);
+
+	SoloBatch.SetNum(1);
+	GatherDrivingState(SoloBatch, 0);
+	SoloBatch.Solve(0, 1);
+	ApplyDrivingOutputs(SoloBatch, 0);
+
+	FWRAIThinkBatch::GatherRaceDistances(RaceManager, SoloThinkBatch.RaceDistances);
+	SoloThinkBatch.SetNum(1);
+	GatherThinkState(SoloThinkBatch, 0);
+	SoloThinkBatch.Think(0, 1);
+	ApplyThinkOutputs(SoloThinkBatch, 0);
 }
 
-void AWRAIController::UpdateMovement(float DeltaTime)
+bool AWRAIController::AdvanceLOD(float DeltaTime, float DistanceToHuman)
 {
-	// Find next waypoint/target
-	CurrentTarget = FindNextWaypoint();
+	LODElapsed += DeltaTime;
+	LODTier = FWRAILOD::SelectTier(LODTier, DistanceToHuman, ControlledKart && ControlledKart->WasRecentlyRendered(0.1f));
+	return LODElapsed >= FWRAILOD::GetUpdateInterval(LODTier);
+}
 
-	// Calculate steering input
-	float SteeringInput = CalculateSteeringInput(CurrentTarget);
-	ControlledKart->SetSteeringInput(SteeringInput);
+void AWRAIController::GatherOvertakingState(FWRAIOvertakingBatch& Batch, int32 Index)
+{
+	// Lanes are planned around the racing line only; on shortcuts or without a line the offset eases out
+	const UWRRacingLineData* Line = GetActiveRacingLine();
+	const bool bPlan = bEnableOvertaking && ControlledKart && RaceManager && Line && Line->IsValid() && !bOnShortcut;
+	const float Distance = bPlan ? RaceManager->GetKartTrackDistance(ControlledKart) : -1.0f;
 
-	// Calculate throttle input
-	float ThrottleInput = CalculateThrottleInput();
-	ControlledKart->SetThrottleInput(ThrottleInput);
+	Batch.TrafficIndex[Index] = Distance >= 0.0f ? RaceManager->GetKartIndex(ControlledKart) : INDEX_NONE;
+	Batch.DeltaTime[Index] = LODElapsed;
+	Batch.LookAhead[Index] = LookAheadDistance;
+	Batch.HalfWidth[Index] = Line ? Line->HalfWidth : 0.0f;
+	Batch.LateralBias[Index] = OvertakeBias;
 
-	// Simple brake logic
-	float DistanceToTarget = FVector::Dist(ControlledKart->GetActorLocation(), CurrentTarget);
-	if (DistanceToTarget < 300.0f && FMath::Abs(SteeringInput) > 0.7f)
-	{
-		ControlledKart->SetBrakeInput(0.3f);
-	}
-	else
+	const float Scale = Distance >= 0.0f ? Line->LapLength / FMath::Max(RaceManager->GetTrackLength(), 1.0f) : 0.0f;
+	for (int32 k = 0; k < FWRAIOvertakingBatch::NumLookAheads; k++)
 	{
-		ControlledKart->SetBrakeInput(0.0f);
+		float LateralOffset = 0.0f, TargetSpeed;
+		if (Distance >= 0.0f)
+		{
+			Line->Sample((Distance + LookAheadDistance * FWRAIOvertakingBatch::LookAheadFractions[k]) * Scale, LateralOffset, TargetSpeed);
+		}
+		Batch.LineOffsets[Index * FWRAIOvertakingBatch::NumLookAheads + k] = LateralOffset;
 	}
 }
 
-void AWRAIController::UpdateWeaponUsage(float DeltaTime)
+void AWRAIController::ApplyOvertakingOutputs(const FWRAIOvertakingBatch& Batch, int32 Index)
 {
-	WeaponCooldown -= DeltaTime;
+	OvertakeBias = Batch.NewLateralBias[Index];
+}
 
-	if (WeaponCooldown <= 0.0f && ShouldUseWeapon())
-	{
-		UWRWeaponComponent* WeaponComponent = ControlledKart->FindComponentByClass<UWRWeaponComponent>();
-		if (WeaponComponent && WeaponComponent->HasWeapon())
-		{
-			WeaponComponent->FireWeapon();
-			WeaponCooldown = FMath::RandRange(2.0f, 5.0f) / (Difficulty + 0.1f);
-		}
-	}
+void AWRAIController::GatherDrivingState(FWRAIDrivingBatch& Batch, int32 Index)
+{
+	// One transform read per kart per tick; everything else is derived from it
+	const FTransform Transform = ControlledKart ? ControlledKart->GetActorTransform() : FTransform::Identity;
+	const FVector Location = Transform.GetLocation();
+	const FVector Right = Transform.GetUnitAxis(EAxis::Y);
+
+	CurrentTarget = ControlledKart ? FindNextWaypoint(Location, Transform.GetUnitAxis(EAxis::X)) : Location;
+
+	Batch.LocationX[Index] = Location.X;
+	Batch.LocationY[Index] = Location.Y;
+	Batch.RightX[Index] = Right.X;
+	Batch.RightY[Index] = Right.Y;
+	Batch.Speed[Index] = ControlledKart ? ControlledKart->GetCurrentSpeed() : 0.0f;
+	Batch.TargetX[Index] = CurrentTarget.X;
+	Batch.TargetY[Index] = CurrentTarget.Y;
+	Batch.TargetSpeed[Index] = CurrentTargetSpeed;
+	Batch.Difficulty[Index] = Difficulty;
+	Batch.SteeringNoise[Index] = RandomStream.FRandRange(-0.2f, 0.2f);
+	Batch.ThrottleNoise[Index] = RandomStream.FRandRange(-0.1f, 0.1f);
 }
 
-void AWRAIController::UpdateDrifting(float DeltaTime)
+void AWRAIController::ApplyDrivingOutputs(const FWRAIDrivingBatch& Batch, int32 Index)
 {
-	if (bIsDrifting)
+	ThinkDeltaTime = LODElapsed;
+	LODElapsed = 0.0f;
+
+	if (!ControlledKart)
+		return;
+
+	LastSteering = Batch.Steering[Index];
+	ControlledKart->SetSteeringInput(Batch.Steering[Index]);
+	ControlledKart->SetThrottleInput(Batch.Throttle[Index]);
+	ControlledKart->SetBrakeInput(Batch.Brake[Index]);
+}
+
+void AWRAIController::GatherThinkState(FWRAIThinkBatch& Batch, int32 Index)
+{
+	const UWRWeaponComponent* WeaponComponent = ControlledKart ? ControlledKart->FindComponentByClass<UWRWeaponComponent>() : nullptr;
+	const int32 Standing = ControlledKart ? ControlledKart->GetPosition() - 1 : INDEX_NONE;
+
+	Batch.StandingIndex[Index] = Batch.RaceDistances.IsValidIndex(Standing) ? Standing : INDEX_NONE;
+	Batch.DeltaTime[Index] = ThinkDeltaTime;
+	Batch.Steering[Index] = LastSteering;
+	Batch.Difficulty[Index] = Difficulty;
+	Batch.WeaponUseChance[Index] = WeaponUseChance;
+	Batch.WeaponRange[Index] = WeaponRange;
+	Batch.DriftChance[Index] = DriftChance;
+	Batch.WeaponCooldown[Index] = WeaponCooldown;
+	Batch.DriftTimer[Index] = DriftTimer;
+	Batch.DriftDuration[Index] = DriftDuration;
+	Batch.HasWeapon[Index] = WeaponComponent && WeaponComponent->CanFire() ? 1 : 0;
+	Batch.IsDrifting[Index] = bIsDrifting ? 1 : 0;
+
+	// Always four draws, so the stream advances the same whatever is decided
+	Batch.FireRoll[Index] = RandomStream.FRand();
+	Batch.CooldownRoll[Index] = RandomStream.FRand();
+	Batch.DriftRoll[Index] = RandomStream.FRand();
+	Batch.DriftDurationRoll[Index] = RandomStream.FRand();
+}
+
+void AWRAIController::ApplyThinkOutputs(const FWRAIThinkBatch& Batch, int32 Index)
+{
+	WeaponCooldown = Batch.NewWeaponCooldown[Index];
+	DriftTimer = Batch.NewDriftTimer[Index];
+	DriftDuration = Batch.NewDriftDuration[Index];
+
+	if (!ControlledKart)
+		return;
+
+	if (Batch.FireWeapon[Index])
 	{
-		DriftTimer += DeltaTime;
-		if (DriftTimer > FMath::RandRange(1.0f, 3.0f))
+		UWRWeaponComponent* WeaponComponent = ControlledKart->FindComponentByClass<UWRWeaponComponent>();
+		if (WeaponComponent && WeaponComponent->CanFire())
 		{
-			ControlledKart->StopDrift();
-			bIsDrifting = false;
-			DriftTimer = 0.0f;
+			WeaponComponent->FireWeapon();
 		}
 	}
-	else if (ShouldStartDrift())
+
+	if (Batch.DriftAction[Index] == FWRAIThinkBatch::DriftStart)
 	{
 		ControlledKart->StartDrift();
 		bIsDrifting = true;
-		DriftTimer = 0.0f;
+	}
+	else if (Batch.DriftAction[Index] == FWRAIThinkBatch::DriftStop)
+	{
+		ControlledKart->StopDrift();
+		bIsDrifting = false;
 	}
 }
 
-void AWRAIController::ApplyRubberBanding()
+UWRRacingLineData* AWRAIController::GetActiveRacingLine() const
 {
-	// Get player kart position (simplified - would need proper race manager integration)
-	// Apply speed boost if far behind, or slight slowdown if far ahead
-	int32 AIPosition = ControlledKart->GetPosition();
-	
-	if (AIPosition > 4) // Behind
+	if (RacingLine)
 	{
-		// Apply slight speed boost
-		float BoostAmount = RubberBandStrength * (AIPosition - 4) * 0.1f;
-		ControlledKart->ActivateBoost(BoostAmount);
+		return RacingLine;
 	}
+	return RaceManager ? RaceManager->GetRacingLine() : nullptr;
 }
 
-FVector AWRAIController::FindNextWaypoint() const
+FVector AWRAIController::FindNextWaypoint(const FVector& CurrentLocation, const FVector& ForwardDirection)
 {
-	// Simplified waypoint finding - in a real implementation,
-	// this would use a proper track waypoint system
-	FVector ForwardDirection = ControlledKart->GetActorForwardVector();
-	FVector CurrentLocation = ControlledKart->GetActorLocation();
-	
-	// Look ahead for the next target point
+	CurrentTargetSpeed = -1.0f;
+
+	if (!RaceManager)
+	{
+		if (UWRRaceWorldSubsystem* RaceWorld = UWRRaceWorldSubsystem::GetInstance(this))
+		{
+			RaceManager = RaceWorld->GetRaceManager();
+		}
+	}
+
+	const float Distance = RaceManager ? RaceManager->GetKartTrackDistance(ControlledKart) : -1.0f;
+
+	FVector ShortcutTarget;
+	if (RaceManager && FollowRouteGraph(CurrentLocation, Distance, ShortcutTarget))
+	{
+		return ShortcutTarget;
+	}
+
+	// Aim at the baked racing line LookAheadDistance further along the centre-line
+	const UWRRacingLineData* Line = GetActiveRacingLine();
+	if (Line && Line->IsValid() && Distance >= 0.0f)
+	{
+		const FWRTrackProgress& Track = RaceManager->GetTrackProgress();
+		// The bake measured the spline itself; the progress table is a polyline and slightly shorter
+		const float Scale = Line->LapLength / FMath::Max(Track.GetLapLength(), 1.0f);
+
+		float LateralOffset, TargetSpeed;
+		Line->Sample(Distance * Scale, LateralOffset, TargetSpeed);
+		CurrentTargetSpeed = TargetSpeed * FMath::Lerp(MinTargetSpeedScale, 1.0f, Difficulty);
+
+		const float TargetDistance = Distance + LookAheadDistance;
+		Line->Sample(TargetDistance * Scale, LateralOffset, TargetSpeed);
+
+		// Shifted into the lane planned around traffic ahead, without leaving the track
+		const float EdgeOffset = FMath::Max(Line->HalfWidth, FMath::Abs(LateralOffset));
+		const float Offset = FMath::Clamp(LateralOffset + OvertakeBias, -EdgeOffset, EdgeOffset);
+
+		FVector Centre, Direction;
+		Track.GetPointAtDistance(TargetDistance, Centre, Direction);
+		return Centre + FVector::CrossProduct(FVector::UpVector, Direction).GetSafeNormal() * Offset;
+	}
+
+	// No racing line: look straight ahead
 	return CurrentLocation + (ForwardDirection * LookAheadDistance);
 }
 
-bool AWRAIController::ShouldUseWeapon() const
+void AWRAIController::LeaveShortcut()
 {
-	// Use weapon based on difficulty and random chance
-	float RandomValue = FMath::RandRange(0.0f, 1.0f);
-	float AdjustedChance = WeaponUseChance * (0.5f + Difficulty * 0.5f);
-	
-	return RandomValue < AdjustedChance;
+	if (bShortcutBoost && ControlledKart)
+	{
+		ControlledKart->SetBoosting(false);
+	}
+	bShortcutBoost = false;
+	bOnShortcut = false;
+	RouteEdge = INDEX_NONE;
 }
 
-bool AWRAIController::ShouldStartDrift() const
+bool AWRAIController::FollowRouteGraph(const FVector& CurrentLocation, float TrackDistance, FVector& OutTarget)
 {
-	// Start drift on corners based on difficulty
-	float SteeringAmount = FMath::Abs(CalculateSteeringInput(CurrentTarget));
-	float RandomValue = FMath::RandRange(0.0f, 1.0f);
-	float AdjustedChance = DriftChance * Difficulty;
-	
-	return SteeringAmount > 0.6f && RandomValue < AdjustedChance;
-}
+	const FWRRouteGraph& Graph = RaceManager->GetRouteGraph();
+	if (!Graph.IsValid() || Graph.GetNumForks() == 0)
+	{
+		RouteFork = INDEX_NONE;
+		LeaveShortcut();
+		return false;
+	}
 
-float AWRAIController::CalculateSteeringInput(const FVector& TargetLocation) const
-{
-	FVector ToTarget = (TargetLocation - ControlledKart->GetActorLocation()).GetSafeNormal();
-	FVector Forward = ControlledKart->GetActorForwardVector();
-	FVector Right = ControlledKart->GetActorRightVector();
+	if (!bOnShortcut)
+	{
+		const int32 Fork = TrackDistance >= 0.0f ? Graph.FindNextFork(TrackDistance) : INDEX_NONE;
+		const float ToFork = Fork != INDEX_NONE ? Graph.GetDistanceToFork(TrackDistance, Fork) : TNumericLimits<float>::Max();
+		if (ToFork > LookAheadDistance * 2.0f)
+		{
+			RouteFork = INDEX_NONE;
+			return false;
+		}
 
-	float DotProduct = FVector::DotProduct(ToTarget, Right);
-	
-	// Add some AI imperfection based on difficulty
-	float Imperfection = (1.0f - Difficulty) * FMath::RandRange(-0.2f, 0.2f);
-	
-	return FMath::Clamp(DotProduct + Imperfection, -1.0f, 1.0f);
-}
+		// Decided once per approach from the precomputed table
+		if (Fork != RouteFork)
+		{
+			RouteFork = Fork;
+			const bool bBoostAvailable = ControlledKart->IsBoosting() || ControlledKart->GetBoostPercentage() > 0.25f;
+			RouteEdge = Graph.ChooseEdge(Fork, ControlledKart->GetCurrentSpeed(), bBoostAvailable, Difficulty);
 
-float AWRAIController::CalculateThrottleInput() const
-{
-	// Full throttle with slight variation based on difficulty
-	float BaseThrottle = 0.8f + (Difficulty * 0.2f);
-	float Variation = FMath::RandRange(-0.1f, 0.1f);
-	
-	return FMath::Clamp(BaseThrottle + Variation, 0.0f, 1.0f);
+			const AWRShortcutSystem* ShortcutSystem = RaceManager->GetShortcutSystem();
+			const int32 ShortcutIndex = Graph.GetEdge(RouteEdge).ShortcutIndex;
+			if (ShortcutIndex != INDEX_NONE && !(ShortcutSystem && ShortcutSystem->IsShortcutKnown(ShortcutIndex)))
+			{
+				RouteEdge = INDEX_NONE;
+			}
+		}
+
+		if (RouteEdge == INDEX_NONE || !Graph.GetEdge(RouteEdge).IsShortcut() || ToFork > LookAheadDistance)
+		{
+			return false;
+		}
+
+		bOnShortcut = true;
+		ShortcutState = FWRTrackProgressState();
+		if (Graph.GetEdge(RouteEdge).bRequiresBoost && !ControlledKart->IsBoosting())
+		{
+			ControlledKart->SetBoosting(true);
+			bShortcutBoost = true;
+		}
+	}
+
+	// Shortcut paths are pre-sampled like the centre-line, so following one is the same lookup
+	const FWRTrackProgress& Path = Graph.GetEdge(RouteEdge).Path;
+	const float PathDistance = Path.ProjectPoint(CurrentLocation, ShortcutState);
+
+	FVector PathPoint, PathDirection;
+	Path.GetPointAtDistance(PathDistance, PathPoint, PathDirection);
+
+	// Rejoin the centre-line at the end of the path, or after being knocked well off it
+	if (PathDistance >= Path.GetLapLength() - LookAheadDistance * 0.25f || FVector::DistSquared(PathPoint, CurrentLocation) > FMath::Square(1500.0f))
+	{
+		LeaveShortcut();
+		return false;
+	}
+
+	Path.GetPointAtDistance(FMath::Min(PathDistance + LookAheadDistance, Path.GetLapLength()), OutTarget, PathDirection);
+	return true;
 }
@@ -2,6 +2,8 @@
 
 #include "CoreMinimal.h"
 #include "AIController.h"
+#include "WastelandRacers/AI/WRAIDrivingSubsystem.h"
+#include "WastelandRacers/AI/WRAILOD.h"
 #include "WRAIController.generated.h"
 
 UCLASS()
@@ -13,7 +15,9 @@ public:
 	AWRAIController();
 
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void Tick(float DeltaTime) override;
+	virtual void OnPossess(APawn* InPawn) override;
 
 	UFUNCTION(BlueprintCallable, Category = "AI")
 	void SetDifficulty(float NewDifficulty) { Difficulty = FMath::Clamp(NewDifficulty, 0.0f, 1.0f); }
@@ -21,6 +25,27 @@ public:
 	UFUNCTION(BlueprintPure, Category = "AI")
 	float GetDifficulty() const { return Difficulty; }
 
+	// Read by AWRRaceManager, which rubber-bands every AI kart in one pass
+	bool IsRubberBandingEnabled() const { return bEnableRubberBanding; }
+
+	UFUNCTION(BlueprintPure, Category = "AI")
+	EWRAILODTier GetLODTier() const { return LODTier; }
+
+	class AWRKart* GetControlledKart() const { return ControlledKart; }
+
+	// Picks the LOD tier and returns true when the kart is due to re-decide its inputs this tick
+	bool AdvanceLOD(float DeltaTime, float DistanceToHuman);
+
+	// Called by UWRAIDrivingSubsystem around its batched lane planning and solve, only for karts due an update
+	void GatherOvertakingState(FWRAIOvertakingBatch& Batch, int32 Index);
+	void ApplyOvertakingOutputs(const FWRAIOvertakingBatch& Batch, int32 Index);
+	void GatherDrivingState(FWRAIDrivingBatch& Batch, int32 Index);
+	void ApplyDrivingOutputs(const FWRAIDrivingBatch& Batch, int32 Index);
+
+	// Snapshot for the think step taken after the driving outputs are applied; its decisions come back a tick later
+	void GatherThinkState(FWRAIThinkBatch& Batch, int32 Index);
+	void ApplyThinkOutputs(const FWRAIThinkBatch& Batch, int32 Index);
+
 protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
 	float Difficulty = 0.5f;
@@ -28,33 +53,77 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
 	float LookAheadDistance = 1000.0f;
 
+	// Overrides the race manager's racing line
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	class UWRRacingLineData* RacingLine = nullptr;
+
+	// Fraction of the baked target speed driven at difficulty 0; difficulty 1 drives the full profile
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float MinTargetSpeedScale = 0.8f;
+
+	// Steer off the racing line around slower karts ahead
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	bool bEnableOvertaking = true;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
 	float WeaponUseChance = 0.3f;
 
+	// Weapons are only fired with a rival within this race distance ahead or behind
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI", meta = (ClampMin = "0.0"))
+	float WeaponRange = 5000.0f;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
 	float DriftChance = 0.4f;
 
+	// Strength comes from the race manager's per-difficulty rubber-band curves
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
 	bool bEnableRubberBanding = true;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
-	float RubberBandStrength = 0.2f;
-
 private:
 	class AWRKart* ControlledKart;
+
+	UPROPERTY()
+	class AWRRaceManager* RaceManager = nullptr;
+
 	FVector CurrentTarget;
+
+	// From the racing line at the kart's position, or negative when there is none
+	float CurrentTargetSpeed = -1.0f;
 	float WeaponCooldown = 0.0f;
 	float DriftTimer = 0.0f;
 	bool bIsDrifting = false;
+	float DriftDuration = 0.0f;
+
+	// Planned offset from the racing line, back to 0 once the way ahead is clear
+	float OvertakeBias = 0.0f;
+
+	// From the last driving update, for the think step
+	float LastSteering = 0.0f;
+	float ThinkDeltaTime = 0.0f;
+
+	// Route graph branch decided for the fork ahead, and progress along it while on a shortcut
+	int32 RouteFork = INDEX_NONE;
+	int32 RouteEdge = INDEX_NONE;
+	bool bOnShortcut = false;
+	// Set when the shortcut turned the boost on, so leaving it turns the boost off again
+	bool bShortcutBoost = false;
+	FWRTrackProgressState ShortcutState;
+
+	// Inputs are held between updates; timers advance by the time since the last one
+	EWRAILODTier LODTier = EWRAILODTier::High;
+	float LODElapsed = 0.0f;
+
+	// Seeded from wr.RandomSeed so benchmark runs are reproducible
+	FRandomStream RandomStream;
 
-	void UpdateMovement(float DeltaTime);
-	void UpdateWeaponUsage(float DeltaTime);
-	void UpdateDrifting(float DeltaTime);
-	void ApplyRubberBanding();
+	// Used by the Tick fallback when no driving subsystem exists
+	FWRAIOvertakingBatch SoloOvertakingBatch;
+	FWRAIDrivingBatch SoloBatch;
+	FWRAIThinkBatch SoloThinkBatch;
 
-	FVector FindNextWaypoint() const;
-	bool ShouldUseWeapon() const;
-	bool ShouldStartDrift() const;
-	float CalculateSteeringInput(const FVector& TargetLocation) const;
-	float CalculateThrottleInput() const;
+	class UWRRacingLineData* GetActiveRacingLine() const;
+	FVector FindNextWaypoint(const FVector& CurrentLocation, const FVector& ForwardDirection);
+	bool FollowRouteGraph(const FVector& CurrentLocation, float TrackDistance, FVector& OutTarget);
+	// Back onto the centre-line, dropping any boost the shortcut started
+	void LeaveShortcut();
 };
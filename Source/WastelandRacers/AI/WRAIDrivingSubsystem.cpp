@@ -0,0 +1,626 @@
+#include "WRAIDrivingSubsystem.h"
+#include "WastelandRacers/WastelandRacers.h"
+#include "WastelandRacers/AI/WRAIController.h"
+#include "WastelandRacers/AI/WRAILOD.h"
+#include "WastelandRacers/Gameplay/WRRaceManager.h"
+#include "WastelandRacers/Gameplay/WRRaceWorldSubsystem.h"
+#include "WastelandRacers/Vehicles/WRKart.h"
+#include "WastelandRacers/Core/WRGameplayProfiler.h"
+#include "Async/ParallelFor.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+static TAutoConsoleVariable<int32> CVarAIAsyncThink(
+	TEXT("wr.AI.AsyncThink"),
+	1,
+	TEXT("1 = run the AI think step (weapons, drift planning) on a worker thread and apply it next tick. 0 = think and apply on the game thread."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarAIParallelBatchSize(
+	TEXT("wr.AI.ParallelBatchSize"),
+	0,
+	TEXT("Karts per ParallelFor task in the AI driving kernel. 0 solves every kart on the game thread."),
+	ECVF_Default);
+
+void FWRAIDrivingBatch::SetNum(int32 NumKarts)
+{
+	for (TArray<float>* Array : { &LocationX, &LocationY, &RightX, &RightY, &Speed, &TargetX, &TargetY, &TargetSpeed, &Difficulty,
+		&SteeringNoise, &ThrottleNoise, &Steering, &Throttle, &Brake })
+	{
+		Array->SetNumUninitialized(NumKarts, EAllowShrinking::No);
+	}
+}
+
+void FWRAIDrivingBatch::Solve(int32 Begin, int32 End)
+{
+	const float SharpTurnDistanceSq = FMath::Square(300.0f);
+
+	// Straight-line arithmetic and selects only, so the loop vectorises
+	for (int32 i = Begin; i < End; i++)
+	{
+		const float ToTargetX = TargetX[i] - LocationX[i];
+		const float ToTargetY = TargetY[i] - LocationY[i];
+		const float DistanceSq = ToTargetX * ToTargetX + ToTargetY * ToTargetY;
+		const float InvDistance = FMath::InvSqrt(FMath::Max(DistanceSq, KINDA_SMALL_NUMBER));
+
+		// Lower difficulties steer less precisely
+		const float Alignment = (ToTargetX * RightX[i] + ToTargetY * RightY[i]) * InvDistance;
+		const float SteeringValue = FMath::Clamp(Alignment + (1.0f - Difficulty[i]) * SteeringNoise[i], -1.0f, 1.0f);
+		const float AbsSteering = FMath::Abs(SteeringValue);
+
+		// With a racing line, ease off approaching the target speed and brake above it
+		const bool bHasTargetSpeed = TargetSpeed[i] >= 0.0f;
+		const float SafeTargetSpeed = FMath::Max(TargetSpeed[i], 1.0f);
+		const float Overspeed = Speed[i] - TargetSpeed[i];
+		const float LineThrottle = FMath::Clamp((1.0f - Speed[i] / SafeTargetSpeed) * 10.0f, 0.0f, 1.0f);
+		const float LineBrake = Overspeed > 0.1f * TargetSpeed[i] ? FMath::Clamp(Overspeed / SafeTargetSpeed, 0.2f, 1.0f) : 0.0f;
+
+		// Without one, near-full throttle and a dab of brake into sharp turns
+		const float FreeThrottle = FMath::Clamp(0.8f + Difficulty[i] * 0.2f + ThrottleNoise[i], 0.0f, 1.0f);
+		const float FreeBrake = (DistanceSq < SharpTurnDistanceSq && AbsSteering > 0.7f) ? 0.3f : 0.0f;
+
+		Steering[i] = SteeringValue;
+		Throttle[i] = bHasTargetSpeed ? LineThrottle : FreeThrottle;
+		Brake[i] = bHasTargetSpeed ? LineBrake : FreeBrake;
+	}
+}
+
+void FWRAIOvertakingBatch::SetNum(int32 NumKarts)
+{
+	for (TArray<float>* Array : { &DeltaTime, &LookAhead, &HalfWidth, &LateralBias, &NewLateralBias })
+	{
+		Array->SetNumUninitialized(NumKarts, EAllowShrinking::No);
+	}
+	TrafficIndex.SetNumUninitialized(NumKarts, EAllowShrinking::No);
+	LineOffsets.SetNumUninitialized(NumKarts * NumLookAheads, EAllowShrinking::No);
+}
+
+void FWRAIOvertakingBatch::GatherTraffic(const AWRRaceManager* RaceManager)
+{
+	if (!RaceManager)
+	{
+		TrafficDistance.Reset();
+		TrafficLateral.Reset();
+		TrafficSpeed.Reset();
+		LapLength = 0.0f;
+		return;
+	}
+
+	RaceManager->GetTrafficSnapshot(TrafficDistance, TrafficLateral, TrafficSpeed);
+	LapLength = RaceManager->GetTrackProgress().GetLapLength();
+	bClosedLoop = RaceManager->GetTrackProgress().IsClosedLoop();
+}
+
+void FWRAIOvertakingBatch::Plan(int32 Begin, int32 End)
+{
+	// Karts nearer than this along and across the track are treated as in the way
+	const float ClearLength = 600.0f;
+	const float ClearWidth = 250.0f;
+
+	// Blocking on the racing line below this counts as clear
+	const float ClearCost = 0.25f;
+	const float BlockingWeight = 4.0f;
+	const float LineWeight = 0.3f;
+	const float SwitchWeight = 0.5f;
+
+	// Largest change of the offset per second, in cm
+	const float BlendRate = 400.0f;
+
+	const int32 NumTraffic = TrafficDistance.Num();
+	for (int32 i = Begin; i < End; i++)
+	{
+		const int32 Self = TrafficIndex[i];
+		const float* Line = &LineOffsets[i * NumLookAheads];
+		float TargetBias = 0.0f;
+
+		if (Self != INDEX_NONE && TrafficDistance.IsValidIndex(Self) && TrafficDistance[Self] >= 0.0f && HalfWidth[i] > 0.0f)
+		{
+			const float SelfDistance = TrafficDistance[Self];
+			const float SelfSpeed = FMath::Max(TrafficSpeed[Self], 500.0f);
+			const float ScanLength = LookAhead[i] * LookAheadFractions[NumLookAheads - 1] + ClearLength;
+
+			// The nearest karts from alongside to past the furthest look-ahead, nearest first
+			float OpponentGap[MaxOpponents];
+			float OpponentLateral[MaxOpponents];
+			float OpponentSpeed[MaxOpponents];
+			int32 NumOpponents = 0;
+			for (int32 j = 0; j < NumTraffic; j++)
+			{
+				if (j == Self || TrafficDistance[j] < 0.0f)
+				{
+					continue;
+				}
+
+				float Gap = TrafficDistance[j] - SelfDistance;
+				if (bClosedLoop && LapLength > 0.0f)
+				{
+					Gap = FMath::Fmod(Gap + LapLength * 1.5f, LapLength) - LapLength * 0.5f;
+				}
+				if (Gap < -ClearLength || Gap > ScanLength || (NumOpponents == MaxOpponents && FMath::Abs(Gap) >= FMath::Abs(OpponentGap[MaxOpponents - 1])))
+				{
+					continue;
+				}
+
+				int32 Slot = FMath::Min(NumOpponents, MaxOpponents - 1);
+				NumOpponents = FMath::Min(NumOpponents + 1, MaxOpponents);
+				for (; Slot > 0 && FMath::Abs(OpponentGap[Slot - 1]) > FMath::Abs(Gap); Slot--)
+				{
+					OpponentGap[Slot] = OpponentGap[Slot - 1];
+					OpponentLateral[Slot] = OpponentLateral[Slot - 1];
+					OpponentSpeed[Slot] = OpponentSpeed[Slot - 1];
+				}
+				OpponentGap[Slot] = Gap;
+				OpponentLateral[Slot] = TrafficLateral[j];
+				OpponentSpeed[Slot] = TrafficSpeed[j];
+			}
+
+			// Overlap with the karts ahead at a look-ahead, assuming everyone holds their speed and lane
+			auto GetBlocking = [&](int32 LookAheadIndex, float Offset)
+			{
+				const float Time = LookAhead[i] * LookAheadFractions[LookAheadIndex] / SelfSpeed;
+				float Blocking = 0.0f;
+				for (int32 o = 0; o < NumOpponents; o++)
+				{
+					const float Separation = OpponentGap[o] + (OpponentSpeed[o] - SelfSpeed) * Time;
+					const float Along = FMath::Max(0.0f, 1.0f - FMath::Abs(Separation) / ClearLength);
+					const float Across = FMath::Max(0.0f, 1.0f - FMath::Abs(Offset - OpponentLateral[o]) / ClearWidth);
+					Blocking += Along * Across;
+				}
+				return Blocking;
+			};
+
+			float LineBlocking = 0.0f;
+			for (int32 k = 0; k < NumLookAheads; k++)
+			{
+				LineBlocking += GetBlocking(k, Line[k]);
+			}
+
+			// Off the line only while it is blocked; otherwise the target stays 0 and the kart blends back
+			if (NumOpponents > 0 && LineBlocking > ClearCost)
+			{
+				const float CurrentOffset = Line[TargetLookAhead] + LateralBias[i];
+				const float InvHalfWidth = 1.0f / HalfWidth[i];
+				float BestCost = TNumericLimits<float>::Max();
+				for (int32 Lane = 0; Lane < NumLanes; Lane++)
+				{
+					const float Offset = FMath::Lerp(-HalfWidth[i], HalfWidth[i], (float)Lane / (float)(NumLanes - 1));
+					float Cost = FMath::Abs(Offset - CurrentOffset) * InvHalfWidth * SwitchWeight;
+					for (int32 k = 0; k < NumLookAheads; k++)
+					{
+						Cost += GetBlocking(k, Offset) * BlockingWeight + FMath::Abs(Offset - Line[k]) * InvHalfWidth * LineWeight;
+					}
+					if (Cost < BestCost)
+					{
+						BestCost = Cost;
+						TargetBias = Offset - Line[TargetLookAhead];
+					}
+				}
+			}
+		}
+
+		const float MaxChange = BlendRate * DeltaTime[i];
+		NewLateralBias[i] = FMath::Clamp(TargetBias, LateralBias[i] - MaxChange, LateralBias[i] + MaxChange);
+	}
+}
+
+void FWRAIThinkBatch::SetNum(int32 NumKarts)
+{
+	for (TArray<float>* Array : { &DeltaTime, &Steering, &Difficulty, &WeaponUseChance, &WeaponRange, &DriftChance, &WeaponCooldown, &DriftTimer,
+		&DriftDuration, &FireRoll, &CooldownRoll, &DriftRoll, &DriftDurationRoll, &NewWeaponCooldown, &NewDriftTimer, &NewDriftDuration })
+	{
+		Array->SetNumUninitialized(NumKarts, EAllowShrinking::No);
+	}
+	for (TArray<uint8>* Array : { &HasWeapon, &IsDrifting, &FireWeapon, &DriftAction })
+	{
+		Array->SetNumUninitialized(NumKarts, EAllowShrinking::No);
+	}
+	StandingIndex.SetNumUninitialized(NumKarts, EAllowShrinking::No);
+}
+
+void FWRAIThinkBatch::GatherRaceDistances(const AWRRaceManager* RaceManager, TArray<float>& OutRaceDistances)
+{
+	OutRaceDistances.Reset();
+	if (!RaceManager)
+	{
+		return;
+	}
+
+	const float TrackLength = RaceManager->GetTrackLength();
+	for (int32 Position = 1; Position <= RaceManager->GetNumRacers(); Position++)
+	{
+		AWRKart* Kart = RaceManager->GetKartAtPosition(Position);
+		OutRaceDistances.Add(Kart ? RaceManager->GetKartRaceProgress(Kart) * TrackLength : -1.0f);
+	}
+}
+
+void FWRAIThinkBatch::Think(int32 Begin, int32 End)
+{
+	const int32 NumStandings = RaceDistances.Num();
+	for (int32 i = Begin; i < End; i++)
+	{
+		// Standings are sorted, so the nearest rival is directly ahead or behind; outside a race anything goes
+		const int32 Standing = StandingIndex[i];
+		float NearestRival = 0.0f;
+		if (Standing != INDEX_NONE && NumStandings > 1)
+		{
+			const float Ahead = Standing > 0 ? RaceDistances[Standing - 1] - RaceDistances[Standing] : TNumericLimits<float>::Max();
+			const float Behind = Standing < NumStandings - 1 ? RaceDistances[Standing] - RaceDistances[Standing + 1] : TNumericLimits<float>::Max();
+			NearestRival = FMath::Min(Ahead, Behind);
+		}
+
+		float Cooldown = WeaponCooldown[i] - DeltaTime[i];
+		const float AdjustedChance = WeaponUseChance[i] * (0.5f + Difficulty[i] * 0.5f);
+		const bool bFire = Cooldown <= 0.0f && HasWeapon[i] && NearestRival <= WeaponRange[i] && FireRoll[i] < AdjustedChance;
+		if (bFire)
+		{
+			Cooldown = FMath::Lerp(2.0f, 5.0f, CooldownRoll[i]) / (Difficulty[i] + 0.1f);
+		}
+		FireWeapon[i] = bFire ? 1 : 0;
+		NewWeaponCooldown[i] = Cooldown;
+
+		// Drift into sharp corners, for a planned duration
+		DriftAction[i] = DriftNone;
+		NewDriftTimer[i] = DriftTimer[i];
+		NewDriftDuration[i] = DriftDuration[i];
+		if (IsDrifting[i])
+		{
+			NewDriftTimer[i] = DriftTimer[i] + DeltaTime[i];
+			if (NewDriftTimer[i] > DriftDuration[i])
+			{
+				DriftAction[i] = DriftStop;
+				NewDriftTimer[i] = 0.0f;
+			}
+		}
+		else if (FMath::Abs(Steering[i]) > 0.6f && DriftRoll[i] < DriftChance[i] * Difficulty[i])
+		{
+			DriftAction[i] = DriftStart;
+			NewDriftTimer[i] = 0.0f;
+			NewDriftDuration[i] = FMath::Lerp(1.0f, 3.0f, DriftDurationRoll[i]);
+		}
+	}
+}
+
+UWRAIDrivingSubsystem* UWRAIDrivingSubsystem::GetInstance(const UObject* WorldContext)
+{
+	if (const UWorld* World = GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::ReturnNull))
+	{
+		return World->GetSubsystem<UWRAIDrivingSubsystem>();
+	}
+	return nullptr;
+}
+
+bool UWRAIDrivingSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UWRAIDrivingSubsystem::Deinitialize()
+{
+	CancelThink();
+	Controllers.Empty();
+	Super::Deinitialize();
+}
+
+TStatId UWRAIDrivingSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UWRAIDrivingSubsystem, STATGROUP_Tickables);
+}
+
+void UWRAIDrivingSubsystem::RegisterController(AWRAIController* Controller)
+{
+	if (Controller)
+	{
+		Controllers.AddUnique(Controller);
+	}
+}
+
+void UWRAIDrivingSubsystem::UnregisterController(AWRAIController* Controller)
+{
+	Controllers.Remove(Controller);
+}
+
+void UWRAIDrivingSubsystem::Tick(float DeltaTime)
+{
+	WR_PROFILE_SCOPE(AI);
+
+	if (bSuspended)
+	{
+		return;
+	}
+
+	// Last tick's decisions land before this tick's snapshot is taken
+	CompleteThink();
+
+	Controllers.RemoveAll([](const AWRAIController* Controller) { return !IsValid(Controller); });
+
+	// Distant and off-screen karts hold their inputs until their LOD tier's next update
+	const UWRRaceWorldSubsystem* RaceWorld = UWRRaceWorldSubsystem::GetInstance(this);
+	const AWRRaceManager* RaceManager = RaceWorld ? RaceWorld->GetRaceManager() : nullptr;
+	FWRAILOD::GatherHumanKarts(GetWorld(), RaceManager, HumanRaceDistances, HumanLocations);
+
+	DueControllers.Reset();
+	for (AWRAIController* Controller : Controllers)
+	{
+		const float DistanceToHuman = FWRAILOD::GetDistanceToNearestHuman(Controller->GetControlledKart(), RaceManager, HumanRaceDistances, HumanLocations);
+		if (Controller->AdvanceLOD(DeltaTime, DistanceToHuman))
+		{
+			DueControllers.Add(Controller);
+		}
+	}
+
+	// Lanes first, so the driving gather aims at the planned offset
+	OvertakingBatch.GatherTraffic(RaceManager);
+	OvertakingBatch.SetNum(DueControllers.Num());
+	for (int32 i = 0; i < DueControllers.Num(); i++)
+	{
+		DueControllers[i]->GatherOvertakingState(OvertakingBatch, i);
+	}
+	OvertakingBatch.Plan(0, OvertakingBatch.Num());
+	for (int32 i = 0; i < DueControllers.Num(); i++)
+	{
+		DueControllers[i]->ApplyOvertakingOutputs(OvertakingBatch, i);
+	}
+
+	// Controllers without a kart keep their slot but are skipped when applying
+	Batch.SetNum(DueControllers.Num());
+	for (int32 i = 0; i < DueControllers.Num(); i++)
+	{
+		DueControllers[i]->GatherDrivingState(Batch, i);
+	}
+
+	const int32 BatchSize = CVarAIParallelBatchSize.GetValueOnGameThread();
+	if (BatchSize > 0 && Batch.Num() > BatchSize)
+	{
+		const int32 NumTasks = FMath::DivideAndRoundUp(Batch.Num(), BatchSize);
+		ParallelFor(NumTasks, [this, BatchSize](int32 Task)
+		{
+			Batch.Solve(Task * BatchSize, FMath::Min((Task + 1) * BatchSize, Batch.Num()));
+		});
+	}
+	else
+	{
+		Batch.Solve(0, Batch.Num());
+	}
+
+	for (int32 i = 0; i < DueControllers.Num(); i++)
+	{
+		DueControllers[i]->ApplyDrivingOutputs(Batch, i);
+	}
+
+	StartThink(RaceManager);
+}
+
+void UWRAIDrivingSubsystem::StartThink(const AWRRaceManager* RaceManager)
+{
+	ThinkControllers.Reset();
+	for (AWRAIController* Controller : DueControllers)
+	{
+		ThinkControllers.Add(Controller);
+	}
+
+	FWRAIThinkBatch::GatherRaceDistances(RaceManager, ThinkBatch.RaceDistances);
+	ThinkBatch.SetNum(DueControllers.Num());
+	for (int32 i = 0; i < DueControllers.Num(); i++)
+	{
+		DueControllers[i]->GatherThinkState(ThinkBatch, i);
+	}
+
+	if (ThinkBatch.Num() == 0)
+	{
+		return;
+	}
+
+	if (CVarAIAsyncThink.GetValueOnGameThread() == 0)
+	{
+		ThinkBatch.Think(0, ThinkBatch.Num());
+		CompleteThink();
+		return;
+	}
+
+	ThinkTask = FFunctionGraphTask::CreateAndDispatchWhenReady([this]()
+	{
+		ThinkBatch.Think(0, ThinkBatch.Num());
+	}, TStatId(), nullptr, ENamedThreads::AnyBackgroundThreadNormalTask);
+}
+
+void UWRAIDrivingSubsystem::CompleteThink()
+{
+	// Normally long finished by the next tick, so this rarely blocks
+	if (ThinkTask.IsValid())
+	{
+		FTaskGraphInterface::Get().WaitUntilTaskCompletes(ThinkTask);
+		ThinkTask.SafeRelease();
+	}
+
+	for (int32 i = 0; i < ThinkControllers.Num(); i++)
+	{
+		if (AWRAIController* Controller = ThinkControllers[i].Get())
+		{
+			Controller->ApplyThinkOutputs(ThinkBatch, i);
+		}
+	}
+	ThinkControllers.Reset();
+}
+
+void UWRAIDrivingSubsystem::CancelThink()
+{
+	// The task reads the think batch, so it must finish before anything is freed; its decisions are dropped
+	if (ThinkTask.IsValid())
+	{
+		FTaskGraphInterface::Get().WaitUntilTaskCompletes(ThinkTask);
+		ThinkTask.SafeRelease();
+	}
+	ThinkControllers.Reset();
+}
+
+void UWRAIDrivingSubsystem::SetSuspended(bool bInSuspended)
+{
+	if (bInSuspended)
+	{
+		CancelThink();
+	}
+	bSuspended = bInSuspended;
+}
+
+#if !UE_BUILD_SHIPPING
+// Compares the old per-controller pattern, which called the kart's actor accessors afresh for every
+// input it derived, with one transform and speed read per kart feeding the batched kernel. Karts are
+// spawned far below the track for the run and destroyed afterwards.
+static FAutoConsoleCommand BenchAIDrivingCommand(
+	TEXT("wr.Bench.AIDriving"),
+	TEXT("Benchmarks the batched AI driving kernel against per-kart evaluation for 8 to 64 karts"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (!World || !World->IsGameWorld())
+		{
+			UE_LOG(LogWastelandRacers, Display, TEXT("AIDriving: skipped, needs a game world"));
+			return;
+		}
+
+		const int32 NumTicks = 5000;
+
+		for (int32 NumKarts : { 8, 16, 32, 64 })
+		{
+			FRandomStream Random(1234);
+			TArray<AWRKart*> Karts;
+			TArray<FVector> Targets;
+			for (int32 k = 0; k < NumKarts; k++)
+			{
+				const FVector Location(k * 1000.0f, Random.FRandRange(-20000.0f, 20000.0f), -100000.0f);
+				FActorSpawnParameters SpawnParams;
+				SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+				SpawnParams.ObjectFlags |= RF_Transient;
+				if (AWRKart* Kart = World->SpawnActor<AWRKart>(AWRKart::StaticClass(), Location, FRotator(0.0f, Random.FRandRange(-180.0f, 180.0f), 0.0f), SpawnParams))
+				{
+					Karts.Add(Kart);
+					Targets.Add(Location + FVector(Random.FRandRange(-1000.0f, 1000.0f), Random.FRandRange(-1000.0f, 1000.0f), 0.0f));
+				}
+			}
+			if (Karts.Num() != NumKarts)
+			{
+				UE_LOG(LogWastelandRacers, Warning, TEXT("AIDriving: could only spawn %d of %d karts"), Karts.Num(), NumKarts);
+			}
+
+			// Per kart: each input goes back to the actor, as CalculateSteeringInput, CalculateThrottleInput
+			// and ShouldStartDrift did
+			double Checksum = 0.0;
+			uint64 PerKartCycles = 0;
+			{
+				const uint64 Start = FPlatformTime::Cycles64();
+				for (int32 Tick = 0; Tick < NumTicks; Tick++)
+				{
+					for (int32 k = 0; k < Karts.Num(); k++)
+					{
+						const AWRKart* Kart = Karts[k];
+						auto Steer = [&]()
+						{
+							const FVector ToTarget = (Targets[k] - Kart->GetActorLocation()).GetSafeNormal();
+							return FMath::Clamp(FVector::DotProduct(ToTarget, Kart->GetActorRightVector()) + 0.5f * Random.FRandRange(-0.2f, 0.2f), -1.0f, 1.0f);
+						};
+						const float Steering = Steer();
+						const float Throttle = FMath::Clamp(0.9f + Random.FRandRange(-0.1f, 0.1f), 0.0f, 1.0f);
+						const bool bDrift = FMath::Abs(Steer()) > 0.6f && Kart->GetCurrentSpeed() > 800.0f;
+						const float Brake = (FVector::Dist(Kart->GetActorLocation(), Targets[k]) < 300.0f && FMath::Abs(Steering) > 0.7f) ? 0.3f : 0.0f;
+						Checksum += Steering + Throttle + Brake + (bDrift ? 1.0f : 0.0f);
+					}
+				}
+				PerKartCycles = FPlatformTime::Cycles64() - Start;
+			}
+
+			FWRAIDrivingBatch Batch;
+			uint64 BatchedCycles = 0;
+			{
+				const uint64 Start = FPlatformTime::Cycles64();
+				for (int32 Tick = 0; Tick < NumTicks; Tick++)
+				{
+					Batch.SetNum(Karts.Num());
+					for (int32 k = 0; k < Karts.Num(); k++)
+					{
+						// The same single read per kart as AWRAIController::GatherDrivingState
+						const FTransform Transform = Karts[k]->GetActorTransform();
+						const FVector Location = Transform.GetLocation();
+						const FVector Right = Transform.GetUnitAxis(EAxis::Y);
+						Batch.LocationX[k] = Location.X;
+						Batch.LocationY[k] = Location.Y;
+						Batch.RightX[k] = Right.X;
+						Batch.RightY[k] = Right.Y;
+						Batch.Speed[k] = Karts[k]->GetCurrentSpeed();
+						Batch.TargetX[k] = Targets[k].X;
+						Batch.TargetY[k] = Targets[k].Y;
+						Batch.TargetSpeed[k] = -1.0f;
+						Batch.Difficulty[k] = 0.5f;
+						Batch.SteeringNoise[k] = Random.FRandRange(-0.2f, 0.2f);
+						Batch.ThrottleNoise[k] = Random.FRandRange(-0.1f, 0.1f);
+					}
+					Batch.Solve(0, Karts.Num());
+					for (int32 k = 0; k < Karts.Num(); k++)
+					{
+						Checksum += Batch.Steering[k] + Batch.Throttle[k] + Batch.Brake[k];
+					}
+				}
+				BatchedCycles = FPlatformTime::Cycles64() - Start;
+			}
+
+			for (AWRKart* Kart : Karts)
+			{
+				Kart->Destroy();
+			}
+
+			const int32 NumSamples = FMath::Max(1, NumTicks * Karts.Num());
+			const double PerKartNs = FPlatformTime::ToMilliseconds64(PerKartCycles) * 1.0e6 / (double)NumSamples;
+			const double BatchedNs = FPlatformTime::ToMilliseconds64(BatchedCycles) * 1.0e6 / (double)NumSamples;
+			UE_LOG(LogWastelandRacers, Display, TEXT("AIDriving: %2d karts, per-kart %.1f ns/kart, batched %.1f ns/kart (%.2fx), %.4f ms per tick batched (checksum %.0f)"),
+				Karts.Num(), PerKartNs, BatchedNs, PerKartNs / FMath::Max(BatchedNs, 0.001), BatchedNs * Karts.Num() * 1.0e-6, Checksum);
+		}
+	}));
+
+// Lane planning for a pack of karts bunched on one stretch, so every kart has opponents to score
+static FAutoConsoleCommand BenchAIOvertakingCommand(
+	TEXT("wr.Bench.AIOvertaking"),
+	TEXT("Benchmarks the AI overtaking lane planner for 8 to 64 karts in a pack"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		const int32 NumTicks = 5000;
+
+		for (int32 NumKarts : { 8, 16, 32, 64 })
+		{
+			FRandomStream Random(1234);
+			FWRAIOvertakingBatch Batch;
+			Batch.LapLength = 100000.0f;
+			Batch.bClosedLoop = true;
+			Batch.SetNum(NumKarts);
+			for (int32 k = 0; k < NumKarts; k++)
+			{
+				Batch.TrafficDistance.Add(Random.FRandRange(0.0f, 300.0f * NumKarts));
+				Batch.TrafficLateral.Add(Random.FRandRange(-300.0f, 300.0f));
+				Batch.TrafficSpeed.Add(Random.FRandRange(1500.0f, 3000.0f));
+				Batch.TrafficIndex[k] = k;
+				Batch.DeltaTime[k] = 1.0f / 60.0f;
+				Batch.LookAhead[k] = 1000.0f;
+				Batch.HalfWidth[k] = 350.0f;
+				Batch.LateralBias[k] = 0.0f;
+				for (int32 l = 0; l < FWRAIOvertakingBatch::NumLookAheads; l++)
+				{
+					Batch.LineOffsets[k * FWRAIOvertakingBatch::NumLookAheads + l] = Random.FRandRange(-200.0f, 200.0f);
+				}
+			}
+
+			double Checksum = 0.0;
+			const uint64 Start = FPlatformTime::Cycles64();
+			for (int32 Tick = 0; Tick < NumTicks; Tick++)
+			{
+				Batch.Plan(0, NumKarts);
+				Swap(Batch.LateralBias, Batch.NewLateralBias);
+				Checksum += Batch.LateralBias[Tick % NumKarts];
+			}
+			const uint64 Cycles = FPlatformTime::Cycles64() - Start;
+
+			const double Ns = FPlatformTime::ToMilliseconds64(Cycles) * 1.0e6 / (double)(NumTicks * NumKarts);
+			UE_LOG(LogWastelandRacers, Display, TEXT("AIOvertaking: %2d karts, %.1f ns/kart, %.4f ms per tick (checksum %.0f)"),
+				NumKarts, Ns, Ns * NumKarts * 1.0e-6, Checksum);
+		}
+	}));
+#endif
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "WRAIDrivingSubsystem.generated.h"
+
+// Driving state for every AI kart in flat arrays. Controllers fill the inputs in a gather pass,
+// Solve turns them into steering, throttle and brake without touching any actor, and controllers
+// apply the outputs afterwards.
+struct WASTELANDRACERS_API FWRAIDrivingBatch
+{
+	// Inputs, planar since karts steer in the ground plane
+	TArray<float> LocationX, LocationY;
+	TArray<float> RightX, RightY;
+	TArray<float> Speed;
+	TArray<float> TargetX, TargetY;
+
+	// Negative when the kart has no racing line to follow
+	TArray<float> TargetSpeed;
+	TArray<float> Difficulty;
+
+	// Random values drawn from each controller's stream during the gather, so Solve stays deterministic
+	TArray<float> SteeringNoise;
+	TArray<float> ThrottleNoise;
+
+	// Outputs
+	TArray<float> Steering;
+	TArray<float> Throttle;
+	TArray<float> Brake;
+
+	void SetNum(int32 NumKarts);
+	int32 Num() const { return Speed.Num(); }
+
+	// Karts in [Begin, End) only; ranges may be solved in parallel
+	void Solve(int32 Begin, int32 End);
+};
+
+// Lateral lane planning around karts ahead. Each kart scores a few offsets across the track at a
+// few look-ahead distances against where the karts ahead are predicted to be, shifts its target off
+// the racing line towards the cheapest, and eases back onto the line once the way is clear.
+// Fixed-size scratch only, so planning allocates nothing and never traces.
+struct WASTELANDRACERS_API FWRAIOvertakingBatch
+{
+	static constexpr int32 NumLanes = 5;
+	static constexpr int32 NumLookAheads = 3;
+	static constexpr int32 MaxOpponents = 4;
+
+	// Fraction of each kart's look-ahead distance the lanes are scored at
+	static constexpr float LookAheadFractions[NumLookAheads] = { 0.5f, 1.0f, 2.0f };
+
+	// The one the driving target sits at, which the offset is measured against
+	static constexpr int32 TargetLookAhead = 1;
+
+	// Every kart from the race manager's last step, shared by the whole batch
+	TArray<float> TrafficDistance;
+	TArray<float> TrafficLateral;
+	TArray<float> TrafficSpeed;
+	float LapLength = 0.0f;
+	bool bClosedLoop = true;
+
+	// Inputs; TrafficIndex is the kart's own traffic slot, or INDEX_NONE to just ease back to the line
+	TArray<int32> TrafficIndex;
+	TArray<float> DeltaTime;
+	TArray<float> LookAhead;
+	TArray<float> HalfWidth;
+	TArray<float> LateralBias;
+
+	// Racing line offset from the centre-line at each look-ahead, NumLookAheads per kart
+	TArray<float> LineOffsets;
+
+	// Outputs: offset from the racing line to steer for
+	TArray<float> NewLateralBias;
+
+	void SetNum(int32 NumKarts);
+	int32 Num() const { return DeltaTime.Num(); }
+
+	void GatherTraffic(const class AWRRaceManager* RaceManager);
+
+	// Karts in [Begin, End) only
+	void Plan(int32 Begin, int32 End);
+};
+
+// Decisions beyond the controls: weapon use and drift planning. Think reads only a snapshot taken
+// on the game thread and writes only the outputs, so it can run on a worker thread and a given
+// snapshot always produces the same decisions.
+struct WASTELANDRACERS_API FWRAIThinkBatch
+{
+	enum EDriftAction : uint8
+	{
+		DriftNone,
+		DriftStart,
+		DriftStop
+	};
+
+	// Race distance of every kart in standings order, shared by the whole batch
+	TArray<float> RaceDistances;
+
+	// Inputs; StandingIndex points into RaceDistances, or is INDEX_NONE outside a race
+	TArray<int32> StandingIndex;
+	TArray<float> DeltaTime;
+	TArray<float> Steering;
+	TArray<float> Difficulty;
+	TArray<float> WeaponUseChance;
+	TArray<float> WeaponRange;
+	TArray<float> DriftChance;
+	TArray<float> WeaponCooldown;
+	TArray<float> DriftTimer;
+	TArray<float> DriftDuration;
+	TArray<uint8> HasWeapon;
+	TArray<uint8> IsDrifting;
+
+	// Drawn from each controller's stream during the gather
+	TArray<float> FireRoll;
+	TArray<float> CooldownRoll;
+	TArray<float> DriftRoll;
+	TArray<float> DriftDurationRoll;
+
+	// Outputs
+	TArray<uint8> FireWeapon;
+	TArray<uint8> DriftAction;
+	TArray<float> NewWeaponCooldown;
+	TArray<float> NewDriftTimer;
+	TArray<float> NewDriftDuration;
+
+	void SetNum(int32 NumKarts);
+	int32 Num() const { return DeltaTime.Num(); }
+
+	static void GatherRaceDistances(const class AWRRaceManager* RaceManager, TArray<float>& OutRaceDistances);
+
+	void Think(int32 Begin, int32 End);
+};
+
+// Drives every registered AWRAIController from one tick: lanes are planned against the shared race
+// state first, then one gather pass over the karts, one kernel over contiguous arrays, and one pass
+// writing the inputs back. The think step for the same karts is then dispatched to a worker and its
+// decisions applied at the start of the next tick.
+UCLASS()
+class WASTELANDRACERS_API UWRAIDrivingSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UWRAIDrivingSubsystem* GetInstance(const UObject* WorldContext);
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterController(class AWRAIController* Controller);
+	void UnregisterController(class AWRAIController* Controller);
+
+	int32 GetNumControllers() const { return Controllers.Num(); }
+
+	// Held while a replay poses the karts; decisions still in flight are dropped
+	void SetSuspended(bool bInSuspended);
+	bool IsSuspended() const { return bSuspended; }
+
+private:
+	UPROPERTY()
+	TArray<class AWRAIController*> Controllers;
+
+	// Controllers whose LOD tier makes them due this tick, in batch order
+	TArray<class AWRAIController*> DueControllers;
+	TArray<float> HumanRaceDistances;
+	TArray<FVector> HumanLocations;
+
+	FWRAIOvertakingBatch OvertakingBatch;
+	FWRAIDrivingBatch Batch;
+
+	// Owned by the think task while it runs; only touched on the game thread once it has completed
+	FWRAIThinkBatch ThinkBatch;
+	TArray<TWeakObjectPtr<class AWRAIController>> ThinkControllers;
+	FGraphEventRef ThinkTask;
+
+	bool bSuspended = false;
+
+	void StartThink(const class AWRRaceManager* RaceManager);
+	void CompleteThink();
+	void CancelThink();
+};
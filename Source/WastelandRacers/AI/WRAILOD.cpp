@@ -0,0 +1,148 @@
+#include "WRAILOD.h"
+#include "WastelandRacers/Gameplay/WRRaceManager.h"
+#include "WastelandRacers/Vehicles/WRKart.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+// Tuned per scalability level in DefaultScalability.ini under ViewDistanceQuality
+static TAutoConsoleVariable<int32> CVarAILODEnable(
+	TEXT("wr.AI.LOD.Enable"),
+	1,
+	TEXT("1 = update distant and off-screen AI karts at reduced rates."),
+	ECVF_Scalability);
+
+static TAutoConsoleVariable<float> CVarAILODHighDistance(
+	TEXT("wr.AI.LOD.HighDistance"),
+	4000.0f,
+	TEXT("Race distance to the nearest human within which AI karts update every tick."),
+	ECVF_Scalability);
+
+static TAutoConsoleVariable<float> CVarAILODMediumDistance(
+	TEXT("wr.AI.LOD.MediumDistance"),
+	15000.0f,
+	TEXT("Race distance to the nearest human within which AI karts use the medium update rate."),
+	ECVF_Scalability);
+
+static TAutoConsoleVariable<float> CVarAILODHysteresis(
+	TEXT("wr.AI.LOD.Hysteresis"),
+	0.25f,
+	TEXT("Fraction past a tier's distance a kart must be before it drops to a lower tier."),
+	ECVF_Scalability);
+
+static TAutoConsoleVariable<float> CVarAILODMediumRate(
+	TEXT("wr.AI.LOD.MediumRate"),
+	15.0f,
+	TEXT("Decisions per second for medium-tier AI karts."),
+	ECVF_Scalability);
+
+static TAutoConsoleVariable<float> CVarAILODLowRate(
+	TEXT("wr.AI.LOD.LowRate"),
+	4.0f,
+	TEXT("Decisions per second for low-tier AI karts."),
+	ECVF_Scalability);
+
+bool FWRAILOD::IsEnabled()
+{
+	return CVarAILODEnable.GetValueOnGameThread() != 0;
+}
+
+EWRAILODTier FWRAILOD::SelectTier(EWRAILODTier CurrentTier, float DistanceToHuman, bool bVisible)
+{
+	if (!IsEnabled())
+	{
+		return EWRAILODTier::High;
+	}
+
+	const float HighDistance = CVarAILODHighDistance.GetValueOnGameThread();
+	const float MediumDistance = CVarAILODMediumDistance.GetValueOnGameThread();
+	const float Margin = 1.0f + FMath::Max(0.0f, CVarAILODHysteresis.GetValueOnGameThread());
+
+	// Thresholds are stretched for the tier the kart is leaving, so it must clearly cross them to drop
+	const float HighLimit = CurrentTier == EWRAILODTier::High ? HighDistance * Margin : HighDistance;
+	const float MediumLimit = CurrentTier != EWRAILODTier::Low ? MediumDistance * Margin : MediumDistance;
+
+	EWRAILODTier Tier = EWRAILODTier::Low;
+	if (DistanceToHuman <= HighLimit)
+	{
+		Tier = EWRAILODTier::High;
+	}
+	else if (DistanceToHuman <= MediumLimit)
+	{
+		Tier = EWRAILODTier::Medium;
+	}
+
+	if (bVisible && Tier == EWRAILODTier::Low)
+	{
+		Tier = EWRAILODTier::Medium;
+	}
+	return Tier;
+}
+
+float FWRAILOD::GetUpdateInterval(EWRAILODTier Tier)
+{
+	switch (Tier)
+	{
+		case EWRAILODTier::Medium:
+			return 1.0f / FMath::Max(CVarAILODMediumRate.GetValueOnGameThread(), 1.0f);
+		case EWRAILODTier::Low:
+			return 1.0f / FMath::Max(CVarAILODLowRate.GetValueOnGameThread(), 1.0f);
+		default:
+			return 0.0f;
+	}
+}
+
+void FWRAILOD::GatherHumanKarts(const UWorld* World, const AWRRaceManager* RaceManager, TArray<float>& OutRaceDistances, TArray<FVector>& OutLocations)
+{
+	OutRaceDistances.Reset();
+	OutLocations.Reset();
+	if (!World)
+	{
+		return;
+	}
+
+	const float TrackLength = RaceManager ? RaceManager->GetTrackLength() : 0.0f;
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		AWRKart* Kart = PlayerController ? Cast<AWRKart>(PlayerController->GetPawn()) : nullptr;
+		if (!Kart)
+		{
+			continue;
+		}
+
+		OutLocations.Add(Kart->GetActorLocation());
+		if (TrackLength > 0.0f)
+		{
+			OutRaceDistances.Add(RaceManager->GetKartRaceProgress(Kart) * TrackLength);
+		}
+	}
+}
+
+float FWRAILOD::GetDistanceToNearestHuman(AWRKart* Kart, const AWRRaceManager* RaceManager,
+	TArrayView<const float> HumanRaceDistances, TArrayView<const FVector> HumanLocations)
+{
+	// No human in the race, e.g. the headless benchmark: nothing to be relevant to, but keep full rate
+	if (!Kart || HumanLocations.Num() == 0)
+	{
+		return 0.0f;
+	}
+
+	float Nearest = TNumericLimits<float>::Max();
+	if (RaceManager && HumanRaceDistances.Num() == HumanLocations.Num())
+	{
+		const float RaceDistance = RaceManager->GetKartRaceProgress(Kart) * RaceManager->GetTrackLength();
+		for (float HumanDistance : HumanRaceDistances)
+		{
+			Nearest = FMath::Min(Nearest, FMath::Abs(RaceDistance - HumanDistance));
+		}
+		return Nearest;
+	}
+
+	const FVector Location = Kart->GetActorLocation();
+	for (const FVector& HumanLocation : HumanLocations)
+	{
+		Nearest = FMath::Min(Nearest, (float)FVector::Dist(Location, HumanLocation));
+	}
+	return Nearest;
+}
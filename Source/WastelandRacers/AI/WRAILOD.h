@@ -0,0 +1,29 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WRAILOD.generated.h"
+
+UENUM(BlueprintType)
+enum class EWRAILODTier : uint8
+{
+	High,		// Decisions every tick
+	Medium,		// Decisions at wr.AI.LOD.MediumRate, inputs held in between
+	Low			// Decisions at wr.AI.LOD.LowRate, inputs held in between
+};
+
+// Chooses how often each AI kart re-decides its inputs. Tiers come from the gap in race
+// progress to the nearest human kart, with karts on screen never dropping below Medium.
+// Demotion needs the gap to exceed a threshold by wr.AI.LOD.Hysteresis, so tiers do not flicker.
+struct WASTELANDRACERS_API FWRAILOD
+{
+	static bool IsEnabled();
+
+	static EWRAILODTier SelectTier(EWRAILODTier CurrentTier, float DistanceToHuman, bool bVisible);
+	static float GetUpdateInterval(EWRAILODTier Tier);
+
+	// Race distance of every human kart, or world locations when there is no track to measure along
+	static void GatherHumanKarts(const UWorld* World, const class AWRRaceManager* RaceManager, TArray<float>& OutRaceDistances, TArray<FVector>& OutLocations);
+
+	static float GetDistanceToNearestHuman(class AWRKart* Kart, const class AWRRaceManager* RaceManager,
+		TArrayView<const float> HumanRaceDistances, TArrayView<const FVector> HumanLocations);
+};
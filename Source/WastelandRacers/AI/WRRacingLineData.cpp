@@ -0,0 +1,31 @@
+#include "WRRacingLineData.h"
+
+void UWRRacingLineData::Sample(float Distance, float& OutLateralOffset, float& OutTargetSpeed) const
+{
+	if (!IsValid())
+	{
+		OutLateralOffset = 0.0f;
+		OutTargetSpeed = 0.0f;
+		return;
+	}
+
+	// Closed loops have no sample on the end point, which is the first sample again
+	const int32 NumSamples = LateralOffsets.Num();
+	const int32 NumIntervals = bClosedLoop ? NumSamples : NumSamples - 1;
+	const float Position = FMath::Clamp(Distance / LapLength, bClosedLoop ? -1.0f : 0.0f, bClosedLoop ? 2.0f : 1.0f) * (float)NumIntervals;
+
+	const int32 Floor = FMath::FloorToInt(Position);
+	const float Alpha = Position - (float)Floor;
+	const int32 Index0 = bClosedLoop ? (Floor % NumSamples + NumSamples) % NumSamples : FMath::Clamp(Floor, 0, NumSamples - 1);
+	const int32 Index1 = bClosedLoop ? (Index0 + 1) % NumSamples : FMath::Min(Index0 + 1, NumSamples - 1);
+
+	OutLateralOffset = FMath::Lerp((float)LateralOffsets[Index0], (float)LateralOffsets[Index1], Alpha);
+	OutTargetSpeed = FMath::Lerp((float)TargetSpeeds[Index0], (float)TargetSpeeds[Index1], Alpha);
+}
+
+float UWRRacingLineData::GetTargetSpeed(float Distance) const
+{
+	float LateralOffset, TargetSpeed;
+	Sample(Distance, LateralOffset, TargetSpeed);
+	return TargetSpeed;
+}
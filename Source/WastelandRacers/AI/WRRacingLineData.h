@@ -0,0 +1,48 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "WastelandRacers/Tracks/WRTrackVariations.h"
+#include "WRRacingLineData.generated.h"
+
+// Racing line and target speeds for one track variation, baked offline by UWRRacingLineBakeCommandlet.
+// Samples are spaced evenly along the centre-line; offsets are to the right of the centre-line
+// in centimetres and speeds are in cm/s, both quantised to 16 bits.
+UCLASS(BlueprintType)
+class WASTELANDRACERS_API UWRRacingLineData : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	// Interpolated offset and speed at a distance along the centre-line; distances wrap on closed loops
+	void Sample(float Distance, float& OutLateralOffset, float& OutTargetSpeed) const;
+
+	UFUNCTION(BlueprintPure, Category = "Racing Line")
+	float GetTargetSpeed(float Distance) const;
+
+	UFUNCTION(BlueprintPure, Category = "Racing Line")
+	bool IsValid() const { return LateralOffsets.Num() > 1 && LateralOffsets.Num() == TargetSpeeds.Num() && LapLength > 0.0f; }
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Racing Line")
+	ETrackType Track = ETrackType::PandoraDesert_Oval;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Racing Line")
+	ETrackShape Shape = ETrackShape::Oval;
+
+	// Centre-line length the samples were taken over
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Racing Line")
+	float LapLength = 0.0f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Racing Line")
+	bool bClosedLoop = true;
+
+	// Usable width either side of the centre-line, inside the bake margin; bounds AI overtaking lanes
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Racing Line")
+	float HalfWidth = 250.0f;
+
+	UPROPERTY(VisibleAnywhere, Category = "Racing Line")
+	TArray<int16> LateralOffsets;
+
+	UPROPERTY(VisibleAnywhere, Category = "Racing Line")
+	TArray<uint16> TargetSpeeds;
+};
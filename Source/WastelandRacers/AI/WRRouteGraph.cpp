@@ -0,0 +1,332 @@
+#include "WRRouteGraph.h"
+#include "WastelandRacers/WastelandRacers.h"
+#include "WastelandRacers/AI/WRRacingLineData.h"
+#include "WastelandRacers/Tracks/WRShortcutSystem.h"
+#include "Algo/StableSort.h"
+#include "Math/InterpCurve.h"
+
+namespace WRRouteGraph
+{
+	// Centre-line pace when there is no racing line to integrate, in cm/s
+	constexpr float DefaultSpeed = 2000.0f;
+	constexpr float TimeStepDistance = 500.0f;
+	constexpr float PathSampleSpacing = 100.0f;
+	constexpr float NodeTolerance = 1.0f;
+
+	// Seconds lost to a crash, and the risk added by hazards on a shortcut
+	constexpr float CrashPenalty = 8.0f;
+	constexpr float HazardRisk = 0.15f;
+
+	static float GetShortcutRisk(const FShortcutData& Shortcut)
+	{
+		float Risk = 0.1f;
+		switch (Shortcut.Difficulty)
+		{
+			case EShortcutDifficulty::Medium:
+				Risk = 0.25f;
+				break;
+			case EShortcutDifficulty::Hard:
+				Risk = 0.45f;
+				break;
+			case EShortcutDifficulty::Expert:
+				Risk = 0.65f;
+				break;
+			default:
+				break;
+		}
+		return FMath::Min(Risk + (Shortcut.bHasHazards ? HazardRisk : 0.0f), 1.0f);
+	}
+
+	// Curves through the entry, waypoints and exit the way the shortcut trigger's spline does
+	static void SamplePath(const FShortcutData& Shortcut, TArray<FVector>& OutPoints)
+	{
+		FInterpCurveVector Curve;
+		auto AddPoint = [&Curve](const FVector& Point)
+		{
+			Curve.Points.Emplace((float)Curve.Points.Num(), Point, FVector::ZeroVector, FVector::ZeroVector, CIM_CurveAuto);
+		};
+
+		AddPoint(Shortcut.EntryPoint);
+		for (const FVector& Waypoint : Shortcut.WaypointLocations)
+		{
+			AddPoint(Waypoint);
+		}
+		AddPoint(Shortcut.ExitPoint);
+		Curve.AutoSetTangents();
+
+		OutPoints.Reset();
+		OutPoints.Add(Shortcut.EntryPoint);
+		for (int32 Segment = 0; Segment < Curve.Points.Num() - 1; Segment++)
+		{
+			const float Chord = FVector::Dist(Curve.Points[Segment].OutVal, Curve.Points[Segment + 1].OutVal);
+			const int32 NumSteps = FMath::Max(1, FMath::CeilToInt32(Chord / PathSampleSpacing));
+			for (int32 Step = 1; Step <= NumSteps; Step++)
+			{
+				OutPoints.Add(Curve.Eval(Segment + (float)Step / NumSteps, FVector::ZeroVector));
+			}
+		}
+	}
+}
+
+void FWRRouteGraph::Reset()
+{
+	NodeDistances.Reset();
+	Edges.Reset();
+	NodeFirstEdges.Reset();
+	ForkNodes.Reset();
+	DecisionTable.Reset();
+	LapLength = 0.0f;
+}
+
+void FWRRouteGraph::Build(const FWRTrackProgress& Track, const UWRRacingLineData* RacingLine, TArrayView<const FShortcutData> Shortcuts)
+{
+	Reset();
+	if (!Track.IsValid())
+	{
+		return;
+	}
+
+	LapLength = Track.GetLapLength();
+	bClosedLoop = Track.IsClosedLoop();
+
+	if (RacingLine && !RacingLine->IsValid())
+	{
+		RacingLine = nullptr;
+	}
+	const float TrackToLine = RacingLine ? RacingLine->LapLength / FMath::Max(LapLength, 1.0f) : 1.0f;
+
+	// Where each shortcut leaves and rejoins the centre-line
+	struct FPendingShortcut
+	{
+		int32 Index;
+		float Entry;
+		float Exit;
+	};
+	TArray<FPendingShortcut, TInlineAllocator<8>> Pending;
+	for (int32 i = 0; i < Shortcuts.Num(); i++)
+	{
+		FWRTrackProgressState EntryState, ExitState;
+		const float Entry = Track.ProjectPoint(Shortcuts[i].EntryPoint, EntryState);
+		const float Exit = Track.ProjectPoint(Shortcuts[i].ExitPoint, ExitState);
+
+		// A shortcut rejoining behind its entry, or over half a lap on, is really a way backwards
+		const float Forward = GetForwardDistance(Entry, Exit);
+		if (Forward <= WRRouteGraph::NodeTolerance || (bClosedLoop && Forward > LapLength * 0.5f))
+		{
+			UE_LOG(LogWastelandRacers, Warning, TEXT("Route graph: shortcut %s does not rejoin ahead of its entry and is ignored by AI"), *Shortcuts[i].ShortcutName);
+			continue;
+		}
+		Pending.Add({ i, Entry, Exit });
+	}
+
+	if (Pending.Num() == 0)
+	{
+		return;
+	}
+
+	for (const FPendingShortcut& Shortcut : Pending)
+	{
+		NodeDistances.Add(Shortcut.Entry);
+		NodeDistances.Add(Shortcut.Exit);
+	}
+	NodeDistances.Sort();
+	for (int32 i = NodeDistances.Num() - 1; i > 0; i--)
+	{
+		if (NodeDistances[i] - NodeDistances[i - 1] < WRRouteGraph::NodeTolerance)
+		{
+			NodeDistances.RemoveAt(i);
+		}
+	}
+
+	auto FindNode = [this](float Distance)
+	{
+		int32 Best = 0;
+		for (int32 i = 1; i < NodeDistances.Num(); i++)
+		{
+			if (FMath::Abs(NodeDistances[i] - Distance) < FMath::Abs(NodeDistances[Best] - Distance))
+			{
+				Best = i;
+			}
+		}
+		return Best;
+	};
+
+	// Centre-line edges between consecutive nodes, round the loop on closed tracks
+	const int32 NumNodes = NodeDistances.Num();
+	for (int32 Node = 0; Node < NumNodes; Node++)
+	{
+		if (Node == NumNodes - 1 && !bClosedLoop)
+		{
+			break;
+		}
+
+		const int32 Next = (Node + 1) % NumNodes;
+		FWRRouteEdge& Edge = Edges.AddDefaulted_GetRef();
+		Edge.FromNode = Node;
+		Edge.ToNode = Next;
+		Edge.Length = NumNodes > 1 ? GetForwardDistance(NodeDistances[Node], NodeDistances[Next]) : LapLength;
+		Edge.ExpectedTime = GetCentreLineTime(RacingLine, TrackToLine, NodeDistances[Node], NodeDistances[Node] + Edge.Length);
+	}
+
+	TArray<FVector> PathPoints;
+	for (const FPendingShortcut& Pend : Pending)
+	{
+		const FShortcutData& Shortcut = Shortcuts[Pend.Index];
+
+		FWRRouteEdge& Edge = Edges.AddDefaulted_GetRef();
+		Edge.FromNode = FindNode(Pend.Entry);
+		Edge.ToNode = FindNode(Pend.Exit);
+		Edge.ShortcutIndex = Pend.Index;
+		Edge.Risk = WRRouteGraph::GetShortcutRisk(Shortcut);
+		Edge.RequiredSpeed = Shortcut.RequiredSpeed;
+		Edge.bRequiresBoost = Shortcut.bRequiresBoost;
+
+		WRRouteGraph::SamplePath(Shortcut, PathPoints);
+		Edge.Path.BuildFromPoints(PathPoints, false);
+		Edge.Length = Edge.Path.GetLapLength();
+
+		// The authored time save is relative to driving the centre-line between entry and exit
+		const float CentreLineTime = GetCentreLineTime(RacingLine, TrackToLine, Pend.Entry, Pend.Entry + GetForwardDistance(Pend.Entry, Pend.Exit));
+		Edge.ExpectedTime = FMath::Max(CentreLineTime - Shortcut.TimeSaveSeconds, CentreLineTime * 0.1f);
+	}
+
+	// Stable, so each node's centre-line edge comes before its shortcuts
+	Algo::StableSortBy(Edges, &FWRRouteEdge::FromNode);
+
+	NodeFirstEdges.SetNumZeroed(NumNodes + 1);
+	for (const FWRRouteEdge& Edge : Edges)
+	{
+		NodeFirstEdges[Edge.FromNode + 1]++;
+	}
+	for (int32 Node = 0; Node < NumNodes; Node++)
+	{
+		NodeFirstEdges[Node + 1] += NodeFirstEdges[Node];
+	}
+
+	for (int32 Node = 0; Node < NumNodes; Node++)
+	{
+		if (NodeFirstEdges[Node + 1] - NodeFirstEdges[Node] > 1)
+		{
+			ForkNodes.Add(Node);
+		}
+	}
+
+	BuildDecisionTable(RacingLine, TrackToLine);
+
+	UE_LOG(LogWastelandRacers, Log, TEXT("Route graph: %d nodes, %d edges, %d forks"), NumNodes, Edges.Num(), ForkNodes.Num());
+}
+
+void FWRRouteGraph::BuildDecisionTable(const UWRRacingLineData* RacingLine, float TrackToLine)
+{
+	DecisionTable.SetNumUninitialized(ForkNodes.Num() * NumSpeedBuckets * 2 * NumDifficultyBuckets);
+
+	TArray<float, TInlineAllocator<8>> OptionTimes;
+	for (int32 Fork = 0; Fork < ForkNodes.Num(); Fork++)
+	{
+		const int32 Node = ForkNodes[Fork];
+		const float ForkDistance = NodeDistances[Node];
+		const int32 FirstEdge = NodeFirstEdges[Node];
+		const int32 NumOptions = NodeFirstEdges[Node + 1] - FirstEdge;
+
+		// Options end at different nodes, so each is timed to the furthest of them along the centre-line
+		float Horizon = 0.0f;
+		for (int32 Option = 0; Option < NumOptions; Option++)
+		{
+			Horizon = FMath::Max(Horizon, GetForwardDistance(ForkDistance, NodeDistances[Edges[FirstEdge + Option].ToNode]));
+		}
+
+		OptionTimes.Reset();
+		for (int32 Option = 0; Option < NumOptions; Option++)
+		{
+			const FWRRouteEdge& Edge = Edges[FirstEdge + Option];
+			const float EdgeEnd = ForkDistance + GetForwardDistance(ForkDistance, NodeDistances[Edge.ToNode]);
+			OptionTimes.Add(Edge.ExpectedTime + GetCentreLineTime(RacingLine, TrackToLine, EdgeEnd, ForkDistance + Horizon));
+		}
+
+		for (int32 SpeedBucket = 0; SpeedBucket < NumSpeedBuckets; SpeedBucket++)
+		{
+			// A bucket only counts as fast enough if its slowest speed is
+			const float Speed = SpeedBucket * SpeedBucketWidth;
+			for (int32 Boost = 0; Boost < 2; Boost++)
+			{
+				for (int32 DifficultyBucket = 0; DifficultyBucket < NumDifficultyBuckets; DifficultyBucket++)
+				{
+					const float Skill = (DifficultyBucket + 0.5f) / NumDifficultyBuckets;
+
+					int32 BestEdge = FirstEdge;
+					float BestCost = TNumericLimits<float>::Max();
+					for (int32 Option = 0; Option < NumOptions; Option++)
+					{
+						const FWRRouteEdge& Edge = Edges[FirstEdge + Option];
+						if (Speed < Edge.RequiredSpeed || (Edge.bRequiresBoost && Boost == 0))
+						{
+							continue;
+						}
+
+						const float Cost = OptionTimes[Option] + Edge.Risk * FMath::Lerp(1.0f, 0.2f, Skill) * WRRouteGraph::CrashPenalty;
+						if (Cost < BestCost)
+						{
+							BestCost = Cost;
+							BestEdge = FirstEdge + Option;
+						}
+					}
+					DecisionTable[GetDecisionIndex(Fork, SpeedBucket, Boost, DifficultyBucket)] = BestEdge;
+				}
+			}
+		}
+	}
+}
+
+int32 FWRRouteGraph::FindNextFork(float Distance) const
+{
+	for (int32 Fork = 0; Fork < ForkNodes.Num(); Fork++)
+	{
+		if (NodeDistances[ForkNodes[Fork]] >= Distance)
+		{
+			return Fork;
+		}
+	}
+	return bClosedLoop && ForkNodes.Num() > 0 ? 0 : INDEX_NONE;
+}
+
+float FWRRouteGraph::GetDistanceToFork(float Distance, int32 ForkIndex) const
+{
+	return GetForwardDistance(Distance, GetForkDistance(ForkIndex));
+}
+
+int32 FWRRouteGraph::ChooseEdge(int32 ForkIndex, float Speed, bool bBoostAvailable, float Difficulty) const
+{
+	const int32 SpeedBucket = FMath::Clamp(FMath::FloorToInt32(Speed / SpeedBucketWidth), 0, NumSpeedBuckets - 1);
+	const int32 DifficultyBucket = FMath::Clamp(FMath::FloorToInt32(Difficulty * NumDifficultyBuckets), 0, NumDifficultyBuckets - 1);
+	return DecisionTable[GetDecisionIndex(ForkIndex, SpeedBucket, bBoostAvailable ? 1 : 0, DifficultyBucket)];
+}
+
+float FWRRouteGraph::GetForwardDistance(float From, float To) const
+{
+	const float Distance = To - From;
+	return (bClosedLoop && Distance < 0.0f) ? Distance + LapLength : Distance;
+}
+
+float FWRRouteGraph::GetCentreLineTime(const UWRRacingLineData* RacingLine, float TrackToLine, float From, float To) const
+{
+	const float Distance = To - From;
+	if (Distance <= 0.0f)
+	{
+		return 0.0f;
+	}
+
+	if (!RacingLine)
+	{
+		return Distance / WRRouteGraph::DefaultSpeed;
+	}
+
+	// Integrate the baked speed profile; it wraps distances past the end of the lap
+	float Time = 0.0f;
+	for (float Along = 0.0f; Along < Distance; Along += WRRouteGraph::TimeStepDistance)
+	{
+		const float Step = FMath::Min(WRRouteGraph::TimeStepDistance, Distance - Along);
+		const float Speed = RacingLine->GetTargetSpeed((From + Along + Step * 0.5f) * TrackToLine);
+		Time += Step / FMath::Max(Speed, 100.0f);
+	}
+	return Time;
+}
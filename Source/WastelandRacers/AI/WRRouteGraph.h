@@ -0,0 +1,89 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WastelandRacers/Gameplay/WRTrackProgress.h"
+
+struct FShortcutData;
+class UWRRacingLineData;
+
+// One way between two nodes: a stretch of centre-line or a shortcut
+struct FWRRouteEdge
+{
+	int32 FromNode = INDEX_NONE;
+	int32 ToNode = INDEX_NONE;
+
+	// Index into AWRShortcutSystem, or INDEX_NONE for the centre-line
+	int32 ShortcutIndex = INDEX_NONE;
+
+	float Length = 0.0f;
+	float ExpectedTime = 0.0f;
+
+	// Rough chance from 0 to 1 of crashing out of the edge
+	float Risk = 0.0f;
+
+	float RequiredSpeed = 0.0f;
+	bool bRequiresBoost = false;
+
+	// Pre-sampled from the entry, waypoints and exit, for shortcuts only
+	FWRTrackProgress Path;
+
+	bool IsShortcut() const { return ShortcutIndex != INDEX_NONE; }
+};
+
+// The track and its shortcuts as a small directed graph, compiled once per race. Nodes sit at the
+// centre-line distances where shortcuts leave and rejoin. At every fork the best edge is decided up
+// front for each speed bucket, boost availability and difficulty bucket, so AI picks a branch with
+// one table read instead of searching while driving.
+class WASTELANDRACERS_API FWRRouteGraph
+{
+public:
+	static constexpr int32 NumSpeedBuckets = 8;
+	static constexpr float SpeedBucketWidth = 250.0f;
+	static constexpr int32 NumDifficultyBuckets = 4;
+
+	// Racing line is optional and only refines the centre-line edge times
+	void Build(const FWRTrackProgress& Track, const UWRRacingLineData* RacingLine, TArrayView<const FShortcutData> Shortcuts);
+	void Reset();
+
+	bool IsValid() const { return NodeDistances.Num() > 0; }
+	int32 GetNumForks() const { return ForkNodes.Num(); }
+	int32 GetNumEdges() const { return Edges.Num(); }
+	const FWRRouteEdge& GetEdge(int32 EdgeIndex) const { return Edges[EdgeIndex]; }
+
+	// Centre-line distance of a fork, where its shortcuts start
+	float GetForkDistance(int32 ForkIndex) const { return NodeDistances[ForkNodes[ForkIndex]]; }
+
+	// First fork at or past Distance, wrapping on closed loops; INDEX_NONE when there is none
+	int32 FindNextFork(float Distance) const;
+
+	// Forward centre-line distance from Distance to the fork, wrapping on closed loops
+	float GetDistanceToFork(float Distance, int32 ForkIndex) const;
+
+	// The edge to take at a fork, from the decision table
+	int32 ChooseEdge(int32 ForkIndex, float Speed, bool bBoostAvailable, float Difficulty) const;
+
+private:
+	// Sorted by distance along the centre-line
+	TArray<float> NodeDistances;
+
+	// Edges grouped by FromNode; a node's edges are [NodeFirstEdges[N], NodeFirstEdges[N + 1])
+	TArray<FWRRouteEdge> Edges;
+	TArray<int32> NodeFirstEdges;
+
+	TArray<int32> ForkNodes;
+
+	// Edge index per fork, speed bucket, boost and difficulty bucket
+	TArray<int32> DecisionTable;
+
+	float LapLength = 0.0f;
+	bool bClosedLoop = true;
+
+	float GetForwardDistance(float From, float To) const;
+	float GetCentreLineTime(const UWRRacingLineData* RacingLine, float TrackToLine, float From, float To) const;
+	void BuildDecisionTable(const UWRRacingLineData* RacingLine, float TrackToLine);
+
+	static int32 GetDecisionIndex(int32 ForkIndex, int32 SpeedBucket, int32 Boost, int32 DifficultyBucket)
+	{
+		return ((ForkIndex * NumSpeedBuckets + SpeedBucket) * 2 + Boost) * NumDifficultyBuckets + DifficultyBucket;
+	}
+};
@@ -0,0 +1,354 @@
+#include "WRRaceBenchmarkCommandlet.h"
+#include "WastelandRacers/WastelandRacers.h"
+#include "WastelandRacers/Core/WRGameplayProfiler.h"
+#include "WastelandRacers/Gameplay/WRRaceManager.h"
+#include "WastelandRacers/Tracks/WRTrackVariations.h"
+#include "WastelandRacers/Vehicles/WRKart.h"
+#include "WastelandRacers/AI/WRAIController.h"
+#include "Components/SplineComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "Misc/App.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace WRRaceBenchmark
+{
+	// One column per EWRProfileCategory plus the whole world tick
+	static const int32 NumColumns = (int32)EWRProfileCategory::Count + 1;
+	static const int32 WorldTickColumn = (int32)EWRProfileCategory::Count;
+
+	static float Percentile(const TArray<float>& Sorted, float Fraction)
+	{
+		if (Sorted.Num() == 0)
+		{
+			return 0.0f;
+		}
+		const int32 Index = FMath::Clamp(FMath::CeilToInt(Fraction * Sorted.Num()) - 1, 0, Sorted.Num() - 1);
+		return Sorted[Index];
+	}
+}
+
+UWRRaceBenchmarkCommandlet::UWRRaceBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = true;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UWRRaceBenchmarkCommandlet::Main(const FString& Params)
+{
+	int32 NumKarts = 8;
+	int32 NumLaps = 3;
+	int32 Seed = 1234;
+	float TickRate = 60.0f;
+	float MaxSeconds = 600.0f;
+	FString TrackName = TEXT("PandoraDesert_Oval");
+	FString ShapeName = TEXT("Oval");
+	FString MapName;
+	FString KartClassPath;
+	FString OutputPath = FPaths::ProjectSavedDir() / TEXT("Benchmarks/RaceBenchmark.csv");
+
+	FParse::Value(*Params, TEXT("Karts="), NumKarts);
+	FParse::Value(*Params, TEXT("Laps="), NumLaps);
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+	FParse::Value(*Params, TEXT("TickRate="), TickRate);
+	FParse::Value(*Params, TEXT("MaxSeconds="), MaxSeconds);
+	FParse::Value(*Params, TEXT("Track="), TrackName);
+	FParse::Value(*Params, TEXT("Shape="), ShapeName);
+	FParse::Value(*Params, TEXT("Map="), MapName);
+	FParse::Value(*Params, TEXT("KartClass="), KartClassPath);
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	NumKarts = FMath::Max(1, NumKarts);
+	TickRate = FMath::Max(1.0f, TickRate);
+
+	const int64 TrackValue = StaticEnum<ETrackType>()->GetValueByNameString(TrackName);
+	const int64 ShapeValue = StaticEnum<ETrackShape>()->GetValueByNameString(ShapeName);
+	if (TrackValue == INDEX_NONE || ShapeValue == INDEX_NONE)
+	{
+		UE_LOG(LogWastelandRacers, Error, TEXT("Unknown track '%s' or shape '%s'"), *TrackName, *ShapeName);
+		return 1;
+	}
+
+	TSubclassOf<AWRKart> KartClass = AWRKart::StaticClass();
+	if (!KartClassPath.IsEmpty())
+	{
+		KartClass = LoadClass<AWRKart>(nullptr, *KartClassPath);
+		if (!KartClass)
+		{
+			UE_LOG(LogWastelandRacers, Error, TEXT("Could not load kart class %s"), *KartClassPath);
+			return 1;
+		}
+	}
+
+	// Every gameplay random stream derives from this seed
+	FWRGameplayRandom::SetGlobalSeed(Seed);
+	FMath::RandInit(Seed);
+	FMath::SRandInit(Seed);
+
+	UWorld* World = CreateBenchmarkWorld(MapName);
+	if (!World)
+	{
+		UE_LOG(LogWastelandRacers, Error, TEXT("Could not create benchmark world (map '%s')"), *MapName);
+		return 1;
+	}
+
+	AWRTrackVariations* Track = World->SpawnActor<AWRTrackVariations>();
+	Track->GenerateTrackVariation((ETrackType)TrackValue, (ETrackShape)ShapeValue);
+
+	AWRRaceManager* RaceManager = World->SpawnActor<AWRRaceManager>();
+	RaceManager->Initialize(NumLaps, NumKarts);
+	RaceManager->SetTrackSpline(Track->GetTrackSpline());
+
+	TArray<AWRKart*> Karts;
+	SpawnKarts(World, RaceManager, Track->GetTrackSpline(), KartClass, NumKarts, Karts);
+
+	RaceManager->StartRace();
+
+	const float FixedDeltaTime = 1.0f / TickRate;
+	const int32 MaxFrames = FMath::CeilToInt(MaxSeconds * TickRate);
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(FixedDeltaTime);
+
+	TArray<TArray<float>> FrameTimes;
+	FrameTimes.SetNum(WRRaceBenchmark::NumColumns);
+	for (TArray<float>& Column : FrameTimes)
+	{
+		Column.Reserve(MaxFrames);
+	}
+
+	UE_LOG(LogWastelandRacers, Display, TEXT("Race benchmark: %d karts, %d laps, seed %d, %.0f Hz, track %s/%s"),
+		NumKarts, NumLaps, Seed, TickRate, *TrackName, *ShapeName);
+
+	FWRGameplayProfiler::SetEnabled(true);
+
+	int32 NumFrames = 0;
+	while (NumFrames < MaxFrames)
+	{
+		FWRGameplayProfiler::BeginFrame();
+
+		FApp::SetCurrentTime(FApp::GetCurrentTime() + FixedDeltaTime);
+		FApp::SetDeltaTime(FixedDeltaTime);
+
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		World->Tick(LEVELTICK_All, FixedDeltaTime);
+		const float WorldTickMs = (float)FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+
+		for (int32 Category = 0; Category < (int32)EWRProfileCategory::Count; Category++)
+		{
+			FrameTimes[Category].Add((float)FWRGameplayProfiler::GetFrameMilliseconds((EWRProfileCategory)Category));
+		}
+		FrameTimes[WRRaceBenchmark::WorldTickColumn].Add(WorldTickMs);
+
+		// Counted before the exit checks, so the frame that ends the race is included
+		NumFrames++;
+
+		if (RaceManager->GetRaceState() == ERaceState::Finished)
+		{
+			break;
+		}
+
+		bool bAllFinished = true;
+		for (const AWRKart* Kart : Karts)
+		{
+			bAllFinished &= Kart && Kart->GetCurrentLap() >= NumLaps;
+		}
+		if (bAllFinished)
+		{
+			break;
+		}
+	}
+
+	FWRGameplayProfiler::SetEnabled(false);
+
+	const bool bWroteTimings = WriteTimingsCsv(OutputPath, FrameTimes, NumFrames);
+	uint32 StateHash = 0;
+	const bool bWroteResults = WriteResultsCsv(FPaths::ChangeExtension(OutputPath, TEXT("results.csv")), RaceManager, Karts, NumFrames, StateHash);
+
+	UE_LOG(LogWastelandRacers, Display, TEXT("Race benchmark finished after %d frames (%.1f s simulated), state hash %08x"),
+		NumFrames, NumFrames * FixedDeltaTime, StateHash);
+
+	DestroyBenchmarkWorld(World);
+	return bWroteTimings && bWroteResults ? 0 : 1;
+}
+
+UWorld* UWRRaceBenchmarkCommandlet::CreateBenchmarkWorld(const FString& MapName) const
+{
+	UWorld* World = nullptr;
+
+	if (!MapName.IsEmpty())
+	{
+		if (UPackage* Package = LoadPackage(nullptr, *MapName, LOAD_None))
+		{
+			World = UWorld::FindWorldInPackage(Package);
+		}
+
+		if (!World)
+		{
+			return nullptr;
+		}
+
+		World->WorldType = EWorldType::Game;
+		World->AddToRoot();
+		if (!World->bIsWorldInitialized)
+		{
+			World->InitWorld(UWorld::InitializationValues().AllowAudioPlayback(false));
+		}
+	}
+	else
+	{
+		World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("WRRaceBenchmark"));
+	}
+
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	World->UpdateWorldComponents(true, false);
+	World->InitializeActorsForPlay(FURL());
+
+	// No game mode is spawned, so dispatch BeginPlay directly; the default game mode would spawn its own race manager
+	if (AWorldSettings* WorldSettings = World->GetWorldSettings())
+	{
+		WorldSettings->NotifyBeginPlay();
+	}
+
+	return World;
+}
+
+void UWRRaceBenchmarkCommandlet::DestroyBenchmarkWorld(UWorld* World) const
+{
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	World->RemoveFromRoot();
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+void UWRRaceBenchmarkCommandlet::SpawnKarts(UWorld* World, AWRRaceManager* RaceManager, USplineComponent* Spline,
+	TSubclassOf<AWRKart> KartClass, int32 NumKarts, TArray<AWRKart*>& OutKarts) const
+{
+	const float GridRowSpacing = 600.0f;
+	const float GridLaneOffset = 150.0f;
+	const float SplineLength = Spline ? Spline->GetSplineLength() : 0.0f;
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	for (int32 i = 0; i < NumKarts; i++)
+	{
+		FVector Location = FVector(-GridRowSpacing * (i / 2 + 1), (i % 2 == 0 ? -1.0f : 1.0f) * GridLaneOffset, 50.0f);
+		FRotator Rotation = FRotator::ZeroRotator;
+
+		// Two-wide grid behind the start line, following the centre-line
+		if (Spline && SplineLength > 0.0f)
+		{
+			const float Distance = Spline->IsClosedLoop()
+				? FMath::Fmod(SplineLength - GridRowSpacing * (i / 2 + 1) + SplineLength, SplineLength)
+				: FMath::Min(GridRowSpacing * (NumKarts / 2 - i / 2), SplineLength);
+			const FVector Right = Spline->GetRightVectorAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::World);
+
+			Location = Spline->GetLocationAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::World)
+				+ Right * ((i % 2 == 0 ? -1.0f : 1.0f) * GridLaneOffset)
+				+ FVector(0.0f, 0.0f, 50.0f);
+			Rotation = Spline->GetRotationAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::World);
+		}
+
+		AWRKart* Kart = World->SpawnActor<AWRKart>(KartClass, Location, Rotation, SpawnParams);
+		if (!Kart)
+		{
+			continue;
+		}
+
+		AWRAIController* Controller = World->SpawnActor<AWRAIController>(Location, Rotation, SpawnParams);
+		Controller->SetDifficulty(NumKarts > 1 ? 0.3f + 0.7f * (float)i / (float)(NumKarts - 1) : 0.5f);
+		Controller->Possess(Kart);
+
+		RaceManager->RegisterKart(Kart);
+		OutKarts.Add(Kart);
+	}
+}
+
+bool UWRRaceBenchmarkCommandlet::WriteTimingsCsv(const FString& Path, const TArray<TArray<float>>& FrameTimes, int32 NumFrames) const
+{
+	FString Csv = TEXT("Subsystem,Frames,MeanMs,P50Ms,P90Ms,P95Ms,P99Ms,MaxMs\n");
+
+	for (int32 Column = 0; Column < WRRaceBenchmark::NumColumns; Column++)
+	{
+		TArray<float> Sorted = FrameTimes[Column];
+		Sorted.Sort();
+
+		double Sum = 0.0;
+		for (float Value : Sorted)
+		{
+			Sum += Value;
+		}
+
+		const TCHAR* Name = Column == WRRaceBenchmark::WorldTickColumn
+			? TEXT("WorldTick")
+			: FWRGameplayProfiler::GetCategoryName((EWRProfileCategory)Column);
+
+		Csv += FString::Printf(TEXT("%s,%d,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f\n"),
+			Name,
+			Sorted.Num(),
+			Sorted.Num() > 0 ? Sum / Sorted.Num() : 0.0,
+			WRRaceBenchmark::Percentile(Sorted, 0.50f),
+			WRRaceBenchmark::Percentile(Sorted, 0.90f),
+			WRRaceBenchmark::Percentile(Sorted, 0.95f),
+			WRRaceBenchmark::Percentile(Sorted, 0.99f),
+			Sorted.Num() > 0 ? Sorted.Last() : 0.0f);
+	}
+
+	if (!FFileHelper::SaveStringToFile(Csv, *Path))
+	{
+		UE_LOG(LogWastelandRacers, Error, TEXT("Failed to write %s"), *Path);
+		return false;
+	}
+
+	UE_LOG(LogWastelandRacers, Display, TEXT("Wrote frame timings to %s"), *Path);
+	return true;
+}
+
+bool UWRRaceBenchmarkCommandlet::WriteResultsCsv(const FString& Path, AWRRaceManager* RaceManager, const TArray<AWRKart*>& Karts, int32 NumFrames, uint32& OutStateHash) const
+{
+	FString Csv = TEXT("Kart,Position,Lap,Progress,X,Y,Z,Health\n");
+
+	// Quantised to centimetres so the hash only changes for real divergence
+	TArray<int32> HashValues;
+	HashValues.Add(NumFrames);
+
+	for (int32 i = 0; i < Karts.Num(); i++)
+	{
+		const AWRKart* Kart = Karts[i];
+		if (!Kart)
+		{
+			continue;
+		}
+
+		const FVector Location = Kart->GetActorLocation();
+		const float Progress = RaceManager->GetKartRaceProgress(const_cast<AWRKart*>(Kart));
+
+		Csv += FString::Printf(TEXT("%d,%d,%d,%.4f,%.1f,%.1f,%.1f,%.1f\n"),
+			i, Kart->GetPosition(), Kart->GetCurrentLap(), Progress, Location.X, Location.Y, Location.Z, Kart->CurrentHealth);
+
+		HashValues.Add(Kart->GetPosition());
+		HashValues.Add(Kart->GetCurrentLap());
+		HashValues.Add(FMath::RoundToInt(Location.X));
+		HashValues.Add(FMath::RoundToInt(Location.Y));
+		HashValues.Add(FMath::RoundToInt(Location.Z));
+	}
+
+	OutStateHash = FCrc::MemCrc32(HashValues.GetData(), HashValues.Num() * HashValues.GetTypeSize());
+	Csv += FString::Printf(TEXT("StateHash,%08x\n"), OutStateHash);
+
+	if (!FFileHelper::SaveStringToFile(Csv, *Path))
+	{
+		UE_LOG(LogWastelandRacers, Error, TEXT("Failed to write %s"), *Path);
+		return false;
+	}
+
+	UE_LOG(LogWastelandRacers, Display, TEXT("Wrote race results to %s"), *Path);
+	return true;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "WRRaceBenchmarkCommandlet.generated.h"
+
+// Headless gameplay CPU benchmark. Runs an AI-only race on a fixed timestep with seeded
+// random streams and writes per-subsystem frame-time percentiles to CSV.
+//
+// UnrealEditor-Cmd WastelandRacers.uproject -run=WRRaceBenchmark -nullrhi -unattended
+//     -Karts=8 -Laps=3 -Seed=1234 -TickRate=60 -MaxSeconds=600
+//     -Track=PandoraDesert_Oval -Shape=Oval [-Map=/Game/Maps/TestTrack] [-KartClass=/Game/...]
+//     -Output=Saved/Benchmarks/RaceBenchmark.csv
+//
+// A second file (<Output>.results.csv) holds the final race state and its hash; two runs
+// with the same seed must produce identical results files.
+UCLASS()
+class UWRRaceBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UWRRaceBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	UWorld* CreateBenchmarkWorld(const FString& MapName) const;
+	void DestroyBenchmarkWorld(UWorld* World) const;
+
+	void SpawnKarts(UWorld* World, class AWRRaceManager* RaceManager, class USplineComponent* Spline,
+		TSubclassOf<class AWRKart> KartClass, int32 NumKarts, TArray<class AWRKart*>& OutKarts) const;
+
+	bool WriteTimingsCsv(const FString& Path, const TArray<TArray<float>>& FrameTimes, int32 NumFrames) const;
+	bool WriteResultsCsv(const FString& Path, class AWRRaceManager* RaceManager, const TArray<class AWRKart*>& Karts, int32 NumFrames, uint32& OutStateHash) const;
+};
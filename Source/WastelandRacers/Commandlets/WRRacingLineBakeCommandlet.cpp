@@ -0,0 +1,260 @@
+#include "WRRacingLineBakeCommandlet.h"
+#include "WastelandRacers/WastelandRacers.h"
+#include "WastelandRacers/AI/WRRacingLineData.h"
+#include "WastelandRacers/Tracks/WRTrackVariations.h"
+#include "Components/SplineComponent.h"
+#include "Engine/World.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+#include "Misc/PackageName.h"
+
+namespace WRRacingLineBake
+{
+	struct FSettings
+	{
+		float Spacing = 200.0f;
+		float Margin = 150.0f;
+		float Friction = 1.1f;
+		float MaxSpeed = 3500.0f;
+		float Acceleration = 900.0f;
+		float Braking = 1800.0f;
+		int32 Iterations = 2000;
+	};
+
+	static const float Gravity = 980.0f;
+
+	static int32 Wrap(int32 Index, int32 Num, bool bLoop)
+	{
+		return bLoop ? (Index % Num + Num) % Num : FMath::Clamp(Index, 0, Num - 1);
+	}
+
+	// Gauss-Seidel descent on the summed squared second difference of the line, with each point
+	// only free to slide along its centre-line normal within the track edges
+	static void SolveMinimumCurvature(TArrayView<const FVector2D> Centre, TArrayView<const FVector2D> Normals, float HalfWidth,
+		bool bLoop, int32 Iterations, TArray<double>& OutOffsets)
+	{
+		const int32 Num = Centre.Num();
+		OutOffsets.Init(0.0, Num);
+
+		auto Point = [&](int32 Index)
+		{
+			const int32 Wrapped = Wrap(Index, Num, bLoop);
+			return Centre[Wrapped] + Normals[Wrapped] * OutOffsets[Wrapped];
+		};
+
+		// Open tracks keep their end points on the centre-line
+		const int32 First = bLoop ? 0 : 2;
+		const int32 Last = bLoop ? Num : Num - 2;
+
+		for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+		{
+			for (int32 i = First; i < Last; i++)
+			{
+				// Minimiser of the five second-difference terms that involve point i
+				const FVector2D Target = (Point(i - 1) * 4.0 + Point(i + 1) * 4.0 - Point(i - 2) - Point(i + 2)) / 6.0;
+				OutOffsets[i] = FMath::Clamp(FVector2D::DotProduct(Target - Centre[i], Normals[i]), -(double)HalfWidth, (double)HalfWidth);
+			}
+		}
+	}
+
+	// Curvature from the circle through each point and its neighbours, then forward and backward
+	// passes so the profile never asks for more acceleration or braking than the kart has
+	static void SolveSpeedProfile(TArrayView<const FVector> Line, bool bLoop, const FSettings& Settings, TArray<double>& OutSpeeds)
+	{
+		const int32 Num = Line.Num();
+		OutSpeeds.Init(Settings.MaxSpeed, Num);
+
+		for (int32 i = 0; i < Num; i++)
+		{
+			if (!bLoop && (i == 0 || i == Num - 1))
+			{
+				continue;
+			}
+
+			const FVector A = Line[Wrap(i - 1, Num, bLoop)];
+			const FVector B = Line[i];
+			const FVector C = Line[Wrap(i + 1, Num, bLoop)];
+			const double Denominator = FVector::Dist2D(A, B) * FVector::Dist2D(B, C) * FVector::Dist2D(A, C);
+			const double Cross = FMath::Abs((B.X - A.X) * (C.Y - A.Y) - (B.Y - A.Y) * (C.X - A.X));
+			const double Curvature = Denominator > KINDA_SMALL_NUMBER ? 2.0 * Cross / Denominator : 0.0;
+
+			if (Curvature > KINDA_SMALL_NUMBER)
+			{
+				OutSpeeds[i] = FMath::Min((double)Settings.MaxSpeed, FMath::Sqrt(Settings.Friction * Gravity / Curvature));
+			}
+		}
+
+		// Two laps of each pass settle the wrap-around on closed loops
+		const int32 Passes = bLoop ? 2 : 1;
+		for (int32 Pass = 0; Pass < Passes * Num; Pass++)
+		{
+			const int32 i = Pass % Num;
+			const int32 Next = i + 1;
+			if (!bLoop && Next >= Num)
+			{
+				continue;
+			}
+			const int32 j = Next % Num;
+			const double Step = FVector::Dist(Line[i], Line[j]);
+			OutSpeeds[j] = FMath::Min(OutSpeeds[j], FMath::Sqrt(FMath::Square(OutSpeeds[i]) + 2.0 * Settings.Acceleration * Step));
+		}
+
+		for (int32 Pass = Passes * Num - 1; Pass >= 0; Pass--)
+		{
+			const int32 i = Pass % Num;
+			const int32 Previous = i - 1;
+			if (!bLoop && Previous < 0)
+			{
+				continue;
+			}
+			const int32 j = (Previous + Num) % Num;
+			const double Step = FVector::Dist(Line[i], Line[j]);
+			OutSpeeds[j] = FMath::Min(OutSpeeds[j], FMath::Sqrt(FMath::Square(OutSpeeds[i]) + 2.0 * Settings.Braking * Step));
+		}
+	}
+
+	static UWRRacingLineData* Bake(const USplineComponent* Spline, const FTrackVariation& Variation, const FSettings& Settings, UObject* Outer, FName Name)
+	{
+		const float LapLength = Spline->GetSplineLength();
+		const bool bLoop = Spline->IsClosedLoop();
+		const int32 NumIntervals = FMath::Max(4, FMath::RoundToInt(LapLength / Settings.Spacing));
+		const int32 NumSamples = bLoop ? NumIntervals : NumIntervals + 1;
+
+		TArray<FVector> Centre3D;
+		TArray<FVector2D> Centre;
+		TArray<FVector2D> Normals;
+		for (int32 i = 0; i < NumSamples; i++)
+		{
+			const float Distance = LapLength * (float)i / (float)NumIntervals;
+			Centre3D.Add(Spline->GetLocationAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::World));
+			Centre.Add(FVector2D(Centre3D.Last()));
+			Normals.Add(FVector2D(Spline->GetRightVectorAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::World)).GetSafeNormal());
+		}
+
+		const float HalfWidth = FMath::Max(0.0f, Variation.TrackWidth * 0.5f - Settings.Margin);
+
+		TArray<double> Offsets;
+		SolveMinimumCurvature(Centre, Normals, HalfWidth, bLoop, Settings.Iterations, Offsets);
+
+		TArray<FVector> Line;
+		for (int32 i = 0; i < NumSamples; i++)
+		{
+			Line.Add(Centre3D[i] + FVector(Normals[i] * Offsets[i], 0.0));
+		}
+
+		TArray<double> Speeds;
+		SolveSpeedProfile(Line, bLoop, Settings, Speeds);
+
+		UWRRacingLineData* Data = NewObject<UWRRacingLineData>(Outer, Name, RF_Public | RF_Standalone);
+		Data->LapLength = LapLength;
+		Data->bClosedLoop = bLoop;
+		Data->HalfWidth = HalfWidth;
+		Data->LateralOffsets.Reserve(NumSamples);
+		Data->TargetSpeeds.Reserve(NumSamples);
+		for (int32 i = 0; i < NumSamples; i++)
+		{
+			Data->LateralOffsets.Add((int16)FMath::Clamp(FMath::RoundToInt(Offsets[i]), (int32)MIN_int16, (int32)MAX_int16));
+			Data->TargetSpeeds.Add((uint16)FMath::Clamp(FMath::RoundToInt(Speeds[i]), 0, (int32)MAX_uint16));
+		}
+		return Data;
+	}
+}
+
+UWRRacingLineBakeCommandlet::UWRRacingLineBakeCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UWRRacingLineBakeCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	WRRacingLineBake::FSettings Settings;
+	FString TrackFilter;
+	FString ShapeFilter;
+	FString OutputPath = TEXT("/Game/AI/RacingLines");
+
+	FParse::Value(*Params, TEXT("Track="), TrackFilter);
+	FParse::Value(*Params, TEXT("Shape="), ShapeFilter);
+	FParse::Value(*Params, TEXT("Spacing="), Settings.Spacing);
+	FParse::Value(*Params, TEXT("Margin="), Settings.Margin);
+	FParse::Value(*Params, TEXT("Friction="), Settings.Friction);
+	FParse::Value(*Params, TEXT("MaxSpeed="), Settings.MaxSpeed);
+	FParse::Value(*Params, TEXT("Accel="), Settings.Acceleration);
+	FParse::Value(*Params, TEXT("Brake="), Settings.Braking);
+	FParse::Value(*Params, TEXT("Iterations="), Settings.Iterations);
+	FParse::Value(*Params, TEXT("OutputPath="), OutputPath);
+
+	Settings.Spacing = FMath::Max(10.0f, Settings.Spacing);
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Editor, false, TEXT("WRRacingLineBake"));
+	AWRTrackVariations* TrackActor = World->SpawnActor<AWRTrackVariations>();
+
+	int32 NumBaked = 0;
+	int32 NumFailed = 0;
+
+	const UEnum* TrackEnum = StaticEnum<ETrackType>();
+	const UEnum* ShapeEnum = StaticEnum<ETrackShape>();
+	for (ETrackType Track : { ETrackType::PandoraDesert, ETrackType::OpportunityRuins, ETrackType::EridiumMines, ETrackType::WildlifePreserve, ETrackType::HyperionMoonBase })
+	{
+		// The base track values alias the _Oval entries, so strip the suffix for names
+		const FString TrackName = TrackEnum->GetNameStringByValue((int64)Track).Replace(TEXT("_Oval"), TEXT(""));
+		if (!TrackFilter.IsEmpty() && TrackName != TrackFilter)
+		{
+			continue;
+		}
+
+		for (const FTrackVariation& Variation : TrackActor->GetAllVariationsForTrack(Track))
+		{
+			const FString ShapeName = ShapeEnum->GetNameStringByValue((int64)Variation.TrackShape);
+			if (!ShapeFilter.IsEmpty() && ShapeName != ShapeFilter)
+			{
+				continue;
+			}
+
+			TrackActor->GenerateTrackVariation(Track, Variation.TrackShape);
+			const USplineComponent* Spline = TrackActor->GetTrackSpline();
+			if (!Spline || Spline->GetNumberOfSplinePoints() < 2)
+			{
+				UE_LOG(LogWastelandRacers, Warning, TEXT("%s %s has no track spline - skipped"), *TrackName, *ShapeName);
+				continue;
+			}
+
+			const FString AssetName = FString::Printf(TEXT("RL_%s_%s"), *TrackName, *ShapeName);
+			const FString PackageName = OutputPath / AssetName;
+			UPackage* Package = CreatePackage(*PackageName);
+			Package->FullyLoad();
+
+			UWRRacingLineData* Data = WRRacingLineBake::Bake(Spline, Variation, Settings, Package, *AssetName);
+			Data->Track = Track;
+			Data->Shape = Variation.TrackShape;
+			Package->MarkPackageDirty();
+
+			FSavePackageArgs SaveArgs;
+			SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+			const FString Filename = FPackageName::LongPackageNameToFilename(PackageName, FPackageName::GetAssetPackageExtension());
+			if (UPackage::SavePackage(Package, Data, *Filename, SaveArgs))
+			{
+				UE_LOG(LogWastelandRacers, Display, TEXT("Baked %s: %d samples over %.0f cm"), *AssetName, Data->LateralOffsets.Num(), Data->LapLength);
+				NumBaked++;
+			}
+			else
+			{
+				UE_LOG(LogWastelandRacers, Error, TEXT("Failed to save %s"), *Filename);
+				NumFailed++;
+			}
+		}
+	}
+
+	World->DestroyWorld(false);
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+	UE_LOG(LogWastelandRacers, Display, TEXT("Racing line bake finished: %d baked, %d failed"), NumBaked, NumFailed);
+	return NumFailed == 0 ? 0 : 1;
+#else
+	UE_LOG(LogWastelandRacers, Error, TEXT("WRRacingLineBake needs the editor to save assets"));
+	return 1;
+#endif
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "WRRacingLineBakeCommandlet.generated.h"
+
+// Bakes a minimum-curvature racing line and friction-limited speed profile for every track
+// variation into UWRRacingLineData assets, one per track and shape.
+//
+// UnrealEditor-Cmd WastelandRacers.uproject -run=WRRacingLineBake -nullrhi -unattended
+//     [-Track=PandoraDesert] [-Shape=Oval] [-Spacing=200] [-Margin=150] [-Friction=1.1]
+//     [-MaxSpeed=3500] [-Accel=900] [-Brake=1800] [-Iterations=2000] [-OutputPath=/Game/AI/RacingLines]
+UCLASS()
+class UWRRacingLineBakeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UWRRacingLineBakeCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,84 @@
+#include "WRTelemetryToCsvCommandlet.h"
+#include "WastelandRacers/WastelandRacers.h"
+#include "WastelandRacers/Telemetry/WRTelemetryReader.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+UWRTelemetryToCsvCommandlet::UWRTelemetryToCsvCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UWRTelemetryToCsvCommandlet::Main(const FString& Params)
+{
+	FString InputPath;
+	FString OutputPath;
+	FParse::Value(*Params, TEXT("Input="), InputPath);
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	if (InputPath.IsEmpty())
+	{
+		UE_LOG(LogWastelandRacers, Error, TEXT("Usage: -run=WRTelemetryToCsv -Input=<file.wrtl> [-Output=<file.csv>]"));
+		return 1;
+	}
+
+	if (OutputPath.IsEmpty())
+	{
+		OutputPath = FPaths::ChangeExtension(InputPath, TEXT("csv"));
+	}
+
+	FWRTelemetryReader Reader;
+	if (!Reader.Open(InputPath))
+	{
+		return 1;
+	}
+
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*OutputPath));
+	if (!Writer)
+	{
+		UE_LOG(LogWastelandRacers, Error, TEXT("Could not create %s"), *OutputPath);
+		return 1;
+	}
+
+	auto WriteText = [&Writer](const FString& Text)
+	{
+		FTCHARToUTF8 Utf8(*Text);
+		Writer->Serialize((void*)Utf8.Get(), Utf8.Length());
+	};
+
+	WriteText(TEXT("Frame,Time,Kart,Name,X,Y,Z,VX,VY,VZ,Throttle,Steering,BoostEnergy,Health,Lap,Progress\n"));
+
+	// Converted a chunk at a time so large files never need a full CSV string in memory
+	FString Rows;
+	for (int32 ChunkIndex = 0; ChunkIndex < Reader.GetNumChunks(); ChunkIndex++)
+	{
+		const FWRTelemetryChunkView& Chunk = Reader.GetChunk(ChunkIndex);
+		Rows.Reset();
+
+		for (int32 LocalFrame = 0; LocalFrame < Chunk.NumFrames; LocalFrame++)
+		{
+			for (int32 Kart = 0; Kart < Reader.GetNumKarts(); Kart++)
+			{
+				const int32 Index = LocalFrame * Reader.GetNumKarts() + Kart;
+				const FVector3f& Location = Chunk.Locations[Index];
+				const FVector3f& Velocity = Chunk.Velocities[Index];
+
+				Rows += FString::Printf(TEXT("%d,%.4f,%d,%s,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.3f,%.3f,%.2f,%.2f,%d,%.5f\n"),
+					Chunk.FirstFrame + LocalFrame, Chunk.Times[LocalFrame], Kart, *Reader.GetKartName(Kart),
+					Location.X, Location.Y, Location.Z, Velocity.X, Velocity.Y, Velocity.Z,
+					Chunk.Throttles[Index], Chunk.Steerings[Index], Chunk.BoostEnergies[Index], Chunk.Healths[Index],
+					Chunk.Laps[Index], Chunk.Progresses[Index]);
+			}
+		}
+
+		WriteText(Rows);
+	}
+
+	Writer->Close();
+
+	UE_LOG(LogWastelandRacers, Display, TEXT("Converted %d frames for %d karts to %s"), Reader.GetNumFrames(), Reader.GetNumKarts(), *OutputPath);
+	return 0;
+}
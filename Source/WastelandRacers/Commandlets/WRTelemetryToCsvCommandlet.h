@@ -0,0 +1,19 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "WRTelemetryToCsvCommandlet.generated.h"
+
+// Converts a binary telemetry file (.wrtl) to CSV with one row per kart per frame.
+//
+// UnrealEditor-Cmd WastelandRacers.uproject -run=WRTelemetryToCsv -Input=Saved/Telemetry/Race.wrtl [-Output=Race.csv]
+UCLASS()
+class UWRTelemetryToCsvCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UWRTelemetryToCsvCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
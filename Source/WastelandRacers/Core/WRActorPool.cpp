@@ -0,0 +1,364 @@
+#include "WRActorPool.h"
+#include "WastelandRacers/WastelandRacers.h"
+#include "WastelandRacers/Weapons/WRProjectile.h"
+#include "Components/ActorComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/MovementComponent.h"
+#include "GameFramework/Pawn.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "TimerManager.h"
+#include "UObject/UObjectGlobals.h"
+
+UWRActorPoolSubsystem* UWRActorPoolSubsystem::GetInstance(const UObject* WorldContext)
+{
+	if (const UWorld* World = GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::ReturnNull))
+	{
+		return World->GetSubsystem<UWRActorPoolSubsystem>();
+	}
+	return nullptr;
+}
+
+void UWRActorPoolSubsystem::ReleaseOrDestroy(AActor* Actor)
+{
+	if (UWRActorPoolSubsystem* Pool = GetInstance(Actor))
+	{
+		Pool->Release(Actor);
+	}
+	else if (Actor)
+	{
+		Actor->Destroy();
+	}
+}
+
+bool UWRActorPoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UWRActorPoolSubsystem::Deinitialize()
+{
+	Pools.Empty();
+	PooledActors.Empty();
+	ActiveActors.Empty();
+	Super::Deinitialize();
+}
+
+void UWRActorPoolSubsystem::Prewarm(TSubclassOf<AActor> Class, int32 Count)
+{
+	if (!Class)
+	{
+		return;
+	}
+
+	FWRActorPoolEntry& Pool = Pools.FindOrAdd(Class);
+	Pool.Free.Reserve(Pool.Free.Num() + Count);
+	for (int32 i = 0; i < Count; i++)
+	{
+		if (AActor* Actor = SpawnPooled(Class, FTransform::Identity, nullptr, nullptr))
+		{
+			Deactivate(Actor);
+			Pool.Free.Add(Actor);
+		}
+	}
+}
+
+AActor* UWRActorPoolSubsystem::AcquireActor(TSubclassOf<AActor> Class, const FTransform& Transform, AActor* Owner, APawn* Instigator)
+{
+	if (!Class)
+	{
+		return nullptr;
+	}
+
+	FWRActorPoolEntry& Pool = Pools.FindOrAdd(Class);
+	Pool.Stats.NumAcquired++;
+
+	// Level teardown or other code may have destroyed an actor while it sat in the pool
+	AActor* Actor = nullptr;
+	while (!Actor && Pool.Free.Num() > 0)
+	{
+		Actor = Pool.Free.Pop(EAllowShrinking::No);
+		if (!IsValid(Actor))
+		{
+			Actor = nullptr;
+		}
+	}
+
+	if (Actor)
+	{
+		Pool.Stats.NumReused++;
+		Actor->SetOwner(Owner);
+		Actor->SetInstigator(Instigator);
+		Actor->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+		Activate(Actor);
+
+		if (IWRPooledActor* PooledActor = Cast<IWRPooledActor>(Actor))
+		{
+			PooledActor->ResetForReuse();
+		}
+	}
+	else
+	{
+		Actor = SpawnPooled(Class, Transform, Owner, Instigator);
+		if (!Actor)
+		{
+			return nullptr;
+		}
+	}
+
+	ActiveActors.Add(Actor);
+	Pool.Stats.NumActive++;
+	Pool.Stats.HighWaterMark = FMath::Max(Pool.Stats.HighWaterMark, Pool.Stats.NumActive);
+	return Actor;
+}
+
+void UWRActorPoolSubsystem::Release(AActor* Actor)
+{
+	if (!IsValid(Actor))
+	{
+		return;
+	}
+
+	if (ActiveActors.Remove(Actor) == 0)
+	{
+		// Released twice is harmless; anything the pool never spawned goes the usual way
+		if (!PooledActors.Contains(Actor))
+		{
+			Actor->Destroy();
+		}
+		return;
+	}
+
+	Deactivate(Actor);
+
+	FWRActorPoolEntry& Pool = Pools.FindOrAdd(Actor->GetClass());
+	Pool.Stats.NumActive--;
+	Pool.Free.Add(Actor);
+}
+
+FWRActorPoolStats UWRActorPoolSubsystem::GetStats(TSubclassOf<AActor> Class) const
+{
+	const FWRActorPoolEntry* Pool = Pools.Find(Class);
+	if (!Pool)
+	{
+		return FWRActorPoolStats();
+	}
+
+	FWRActorPoolStats Stats = Pool->Stats;
+	Stats.NumFree = Pool->Free.Num();
+	return Stats;
+}
+
+void UWRActorPoolSubsystem::LogStats() const
+{
+	for (const TPair<UClass*, FWRActorPoolEntry>& Pair : Pools)
+	{
+		const FWRActorPoolStats Stats = GetStats(Pair.Key);
+		UE_LOG(LogWastelandRacers, Display, TEXT("ActorPool %s: %d active, %d free, high water %d, %d spawned, %d of %d acquires reused"),
+			*GetNameSafe(Pair.Key), Stats.NumActive, Stats.NumFree, Stats.HighWaterMark, Stats.NumSpawned, Stats.NumReused, Stats.NumAcquired);
+	}
+}
+
+AActor* UWRActorPoolSubsystem::SpawnPooled(UClass* Class, const FTransform& Transform, AActor* Owner, APawn* Instigator)
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return nullptr;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.Owner = Owner;
+	SpawnParams.Instigator = Instigator;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	PruneDestroyedActors();
+
+	AActor* Actor = World->SpawnActor<AActor>(Class, Transform, SpawnParams);
+	if (Actor)
+	{
+		PooledActors.Add(Actor);
+		Pools.FindOrAdd(Class).Stats.NumSpawned++;
+	}
+	return Actor;
+}
+
+void UWRActorPoolSubsystem::PruneDestroyedActors()
+{
+	for (TSet<FObjectKey>* Keys : { &PooledActors, &ActiveActors })
+	{
+		for (TSet<FObjectKey>::TIterator It = Keys->CreateIterator(); It; ++It)
+		{
+			if (!It->ResolveObjectPtr())
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+}
+
+void UWRActorPoolSubsystem::Activate(AActor* Actor)
+{
+	Actor->SetActorHiddenInGame(false);
+	Actor->SetActorEnableCollision(true);
+	Actor->SetActorTickEnabled(true);
+
+	// Components switched on at spawn are switched on again; anything else is up to ResetForReuse
+	TInlineComponentArray<UActorComponent*> Components(Actor);
+	for (UActorComponent* Component : Components)
+	{
+		if (Component->bAutoActivate)
+		{
+			Component->Activate(true);
+		}
+		else if (Component->PrimaryComponentTick.bStartWithTickEnabled)
+		{
+			Component->SetComponentTickEnabled(true);
+		}
+	}
+}
+
+void UWRActorPoolSubsystem::Deactivate(AActor* Actor)
+{
+	Actor->SetActorHiddenInGame(true);
+	Actor->SetActorEnableCollision(false);
+	Actor->SetActorTickEnabled(false);
+	Actor->SetLifeSpan(0.0f);
+	Actor->GetWorldTimerManager().ClearAllTimersForObject(Actor);
+
+	// Hidden effects such as projectile trails would otherwise keep simulating and ticking
+	TInlineComponentArray<UActorComponent*> Components(Actor);
+	for (UActorComponent* Component : Components)
+	{
+		if (UMovementComponent* Movement = Cast<UMovementComponent>(Component))
+		{
+			Movement->StopMovementImmediately();
+		}
+		Component->Deactivate();
+		Component->SetComponentTickEnabled(false);
+	}
+}
+
+static FAutoConsoleCommand PoolStatsCommand(
+	TEXT("wr.Pool.Stats"),
+	TEXT("Logs active, free and high-water counts for every pooled actor class"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UWRActorPoolSubsystem* Pool = UWRActorPoolSubsystem::GetInstance(World))
+		{
+			Pool->LogStats();
+		}
+	}));
+
+#if !UE_BUILD_SHIPPING
+// 8 karts holding the trigger: a machine gun round every 0.1 s each, plus a 5-pellet shotgun blast
+// every 0.8 s from half of them, every projectile living 1 s. Spawn and destroy against the pool,
+// then the garbage collection each leaves behind.
+static FAutoConsoleCommand BenchActorPoolCommand(
+	TEXT("wr.Bench.ActorPool"),
+	TEXT("Benchmarks 10 s of sustained fire from 8 karts with spawn and destroy against the actor pool"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		UWRActorPoolSubsystem* Pool = UWRActorPoolSubsystem::GetInstance(World);
+		if (!Pool)
+		{
+			UE_LOG(LogWastelandRacers, Display, TEXT("ActorPool: skipped, needs a game world"));
+			return;
+		}
+
+		const int32 NumKarts = 8;
+		const int32 NumFrames = 600;
+		const int32 MachineGunFrames = 6;
+		const int32 ShotgunFrames = 48;
+		const int32 LifeFrames = 60;
+		UClass* ProjectileClass = AWRProjectile::StaticClass();
+
+		for (const bool bPooled : { false, true })
+		{
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+
+			TArray<TPair<AActor*, int32>> Live;
+			int32 NumSpawns = 0;
+			int32 NumShots = 0;
+			const int32 SpawnedBefore = Pool->GetStats(ProjectileClass).NumSpawned;
+
+			const uint64 Start = FPlatformTime::Cycles64();
+			for (int32 Frame = 0; Frame < NumFrames; Frame++)
+			{
+				for (int32 i = Live.Num() - 1; i >= 0; i--)
+				{
+					if (Live[i].Value <= Frame)
+					{
+						if (bPooled)
+						{
+							Pool->Release(Live[i].Key);
+						}
+						else
+						{
+							Live[i].Key->Destroy();
+						}
+						Live.RemoveAtSwap(i, 1, EAllowShrinking::No);
+					}
+				}
+
+				for (int32 Kart = 0; Kart < NumKarts; Kart++)
+				{
+					int32 NumRounds = (Frame + Kart) % MachineGunFrames == 0 ? 1 : 0;
+					NumRounds += (Kart % 2 == 0 && (Frame + Kart) % ShotgunFrames == 0) ? 5 : 0;
+
+					const FTransform Transform(FVector(Kart * 1000.0f, Frame * 10.0f, -100000.0f));
+					for (int32 Round = 0; Round < NumRounds; Round++)
+					{
+						AActor* Projectile = nullptr;
+						if (bPooled)
+						{
+							Projectile = Pool->AcquireActor(ProjectileClass, Transform);
+						}
+						else
+						{
+							FActorSpawnParameters SpawnParams;
+							SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+							Projectile = World->SpawnActor<AActor>(ProjectileClass, Transform, SpawnParams);
+							NumSpawns++;
+						}
+
+						if (Projectile)
+						{
+							Live.Add(TPair<AActor*, int32>(Projectile, Frame + LifeFrames));
+							NumShots++;
+						}
+					}
+				}
+			}
+
+			for (const TPair<AActor*, int32>& Entry : Live)
+			{
+				if (bPooled)
+				{
+					Pool->Release(Entry.Key);
+				}
+				else
+				{
+					Entry.Key->Destroy();
+				}
+			}
+			const uint64 FireCycles = FPlatformTime::Cycles64() - Start;
+
+			const uint64 GCStart = FPlatformTime::Cycles64();
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+			const uint64 GCCycles = FPlatformTime::Cycles64() - GCStart;
+
+			if (bPooled)
+			{
+				NumSpawns = Pool->GetStats(ProjectileClass).NumSpawned - SpawnedBefore;
+			}
+
+			UE_LOG(LogWastelandRacers, Display, TEXT("ActorPool %s: %d shots, %d spawns, %.3f ms firing, %.3f ms garbage collection"),
+				bPooled ? TEXT("pooled  ") : TEXT("spawning"), NumShots, NumSpawns,
+				FPlatformTime::ToMilliseconds64(FireCycles), FPlatformTime::ToMilliseconds64(GCCycles));
+		}
+
+		Pool->LogStats();
+	}));
+#endif
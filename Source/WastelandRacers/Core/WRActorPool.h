@@ -0,0 +1,99 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/Interface.h"
+#include "UObject/ObjectKey.h"
+#include "WRActorPool.generated.h"
+
+UINTERFACE(MinimalAPI)
+class UWRPooledActor : public UInterface
+{
+	GENERATED_BODY()
+};
+
+// Actors handed out again by UWRActorPoolSubsystem implement this to restart cleanly
+class WASTELANDRACERS_API IWRPooledActor
+{
+	GENERATED_BODY()
+
+public:
+	// Called on reuse once the actor has been moved, shown, and had collision, ticking and its
+	// auto-activating components turned back on. Restores whatever BeginPlay set up: velocity,
+	// timers, lifespan, and effects started by hand.
+	virtual void ResetForReuse() {}
+};
+
+struct FWRActorPoolStats
+{
+	int32 NumSpawned = 0;
+	int32 NumActive = 0;
+	int32 NumFree = 0;
+
+	// Most actors of the class out of the pool at once; a good prewarm count
+	int32 HighWaterMark = 0;
+
+	int32 NumAcquired = 0;
+	int32 NumReused = 0;
+};
+
+USTRUCT()
+struct FWRActorPoolEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<AActor*> Free;
+
+	FWRActorPoolStats Stats;
+};
+
+// Keeps released gameplay actors (projectiles, pickups, transient effects) hidden and inert for reuse
+// instead of destroying them, so sustained fire does not churn UObjects and garbage collection.
+UCLASS()
+class WASTELANDRACERS_API UWRActorPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UWRActorPoolSubsystem* GetInstance(const UObject* WorldContext);
+
+	// Through the actor's world pool, or a plain Destroy when there is none
+	static void ReleaseOrDestroy(AActor* Actor);
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+
+	// Spawns Count more inactive actors of Class, so the first shots of a race do not spawn
+	void Prewarm(TSubclassOf<AActor> Class, int32 Count);
+
+	// A released actor of Class moved to Transform, or a newly spawned one when none is free
+	AActor* AcquireActor(TSubclassOf<AActor> Class, const FTransform& Transform, AActor* Owner = nullptr, APawn* Instigator = nullptr);
+
+	template <typename T>
+	T* Acquire(TSubclassOf<T> Class, const FTransform& Transform, AActor* Owner = nullptr, APawn* Instigator = nullptr)
+	{
+		return Cast<T>(AcquireActor(Class.Get(), Transform, Owner, Instigator));
+	}
+
+	// Hides the actor and turns off its collision, ticking, timers, lifespan and every component
+	// (movement, effects, audio) until it is acquired again. Actors the pool did not spawn are destroyed.
+	void Release(AActor* Actor);
+
+	FWRActorPoolStats GetStats(TSubclassOf<AActor> Class) const;
+	void LogStats() const;
+
+private:
+	UPROPERTY()
+	TMap<UClass*, FWRActorPoolEntry> Pools;
+
+	// Every actor the pool spawned, and those currently handed out. Actors destroyed outside the pool
+	// leave stale keys behind, pruned whenever the pool has to spawn.
+	TSet<FObjectKey> PooledActors;
+	TSet<FObjectKey> ActiveActors;
+
+	AActor* SpawnPooled(UClass* Class, const FTransform& Transform, AActor* Owner, APawn* Instigator);
+	void PruneDestroyedActors();
+	static void Activate(AActor* Actor);
+	static void Deactivate(AActor* Actor);
+};
@@ -15,6 +15,7 @@ enum class EGameMode : uint8
 	MainMenu,
 	FreeRoam,
 	Race,
+	TimeTrial,
 	Multiplayer,
 	ProShop
 };
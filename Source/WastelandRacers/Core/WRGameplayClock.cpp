@@ -0,0 +1,106 @@
+#include "WRGameplayClock.h"
+#include "WastelandRacers/WastelandRacers.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+static TAutoConsoleVariable<float> CVarFixedStepRate(
+	TEXT("wr.Gameplay.FixedStepRate"),
+	60.0f,
+	TEXT("Gameplay fixed steps per second."),
+	ECVF_Scalability);
+
+static TAutoConsoleVariable<int32> CVarMaxSubSteps(
+	TEXT("wr.Gameplay.MaxSubSteps"),
+	4,
+	TEXT("Most fixed gameplay steps run in one frame; any more are dropped."),
+	ECVF_Scalability);
+
+static TAutoConsoleVariable<float> CVarSubStepBudgetMs(
+	TEXT("wr.Gameplay.SubStepBudgetMs"),
+	4.0f,
+	TEXT("Once fixed steps have used this many milliseconds in a frame, remaining steps are dropped."),
+	ECVF_Scalability);
+
+UWRGameplayClock* UWRGameplayClock::GetInstance(const UObject* WorldContext)
+{
+	if (const UWorld* World = GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::ReturnNull))
+	{
+		return World->GetSubsystem<UWRGameplayClock>();
+	}
+	return nullptr;
+}
+
+bool UWRGameplayClock::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UWRGameplayClock::Deinitialize()
+{
+	for (FWROnFixedStep& Delegate : PhaseDelegates)
+	{
+		Delegate.Clear();
+	}
+
+	Super::Deinitialize();
+}
+
+TStatId UWRGameplayClock::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UWRGameplayClock, STATGROUP_Tickables);
+}
+
+FDelegateHandle UWRGameplayClock::Register(EWRFixedStepPhase Phase, FWROnFixedStep::FDelegate&& Delegate)
+{
+	return PhaseDelegates[(int32)Phase].Add(MoveTemp(Delegate));
+}
+
+void UWRGameplayClock::Unregister(EWRFixedStepPhase Phase, FDelegateHandle& Handle)
+{
+	PhaseDelegates[(int32)Phase].Remove(Handle);
+	Handle.Reset();
+}
+
+float UWRGameplayClock::GetFixedDeltaTime() const
+{
+	return 1.0f / FMath::Max(1.0f, CVarFixedStepRate.GetValueOnGameThread());
+}
+
+void UWRGameplayClock::Tick(float DeltaTime)
+{
+	const double FixedDeltaTime = GetFixedDeltaTime();
+	const int32 MaxSubSteps = FMath::Max(1, CVarMaxSubSteps.GetValueOnGameThread());
+	const double BudgetSeconds = CVarSubStepBudgetMs.GetValueOnGameThread() / 1000.0;
+
+	// A hitch (loading, breakpoint) is never worth more than a quarter second of catch-up
+	Accumulator += FMath::Min(DeltaTime, 0.25f);
+
+	const double StartSeconds = FPlatformTime::Seconds();
+	int32 Steps = 0;
+
+	// Small tolerance so a fixed-rate frame equal to the step never rounds down to zero steps
+	while (Accumulator + UE_KINDA_SMALL_NUMBER * FixedDeltaTime >= FixedDeltaTime)
+	{
+		if (Steps >= MaxSubSteps || (Steps > 0 && FPlatformTime::Seconds() - StartSeconds > BudgetSeconds))
+		{
+			const int32 Dropped = FMath::Max(1, FMath::FloorToInt(Accumulator / FixedDeltaTime));
+			Accumulator = FMath::Max(0.0, Accumulator - Dropped * FixedDeltaTime);
+			DroppedSteps += Dropped;
+			break;
+		}
+
+		for (const FWROnFixedStep& Delegate : PhaseDelegates)
+		{
+			Delegate.Broadcast((float)FixedDeltaTime);
+		}
+
+		Accumulator = FMath::Max(0.0, Accumulator - FixedDeltaTime);
+		SimulationTime += FixedDeltaTime;
+		StepCount++;
+		Steps++;
+	}
+
+	InterpolationAlpha = (float)FMath::Clamp(Accumulator / FixedDeltaTime, 0.0, 1.0);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WRGameplayClock.generated.h"
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FWROnFixedStep, float /*FixedDeltaTime*/);
+
+// Phases run in this order within every fixed step
+enum class EWRFixedStepPhase : uint8
+{
+	Vehicles,
+	Weapons,
+	Hazards,
+	Race,
+	Count
+};
+
+// Previous and current value of something integrated on the fixed step, so visuals can
+// blend between steps using UWRGameplayClock::GetInterpolationAlpha
+template <typename T>
+struct TWRFixedStepValue
+{
+	T Previous = T();
+	T Current = T();
+
+	void Reset(const T& Value) { Previous = Value; Current = Value; }
+	void Push(const T& Value) { Previous = Current; Current = Value; }
+	T Get(float Alpha) const { return FMath::Lerp(Previous, Current, Alpha); }
+};
+
+// Runs gameplay integration (boost, reloads, hazard damage, race timing) at a fixed rate
+// independent of the render frame rate. Sub-steps are capped per frame and by a time
+// budget; steps that do not fit are dropped so a slow device runs slower rather than spiralling.
+UCLASS()
+class WASTELANDRACERS_API UWRGameplayClock : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UWRGameplayClock* GetInstance(const UObject* WorldContext);
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	FDelegateHandle Register(EWRFixedStepPhase Phase, FWROnFixedStep::FDelegate&& Delegate);
+	void Unregister(EWRFixedStepPhase Phase, FDelegateHandle& Handle);
+
+	float GetFixedDeltaTime() const;
+
+	// Fraction of a step left in the accumulator, for blending previous and current state
+	float GetInterpolationAlpha() const { return InterpolationAlpha; }
+
+	double GetSimulationTime() const { return SimulationTime; }
+	int64 GetStepCount() const { return StepCount; }
+	int32 GetDroppedSteps() const { return DroppedSteps; }
+
+private:
+	FWROnFixedStep PhaseDelegates[(int32)EWRFixedStepPhase::Count];
+
+	double Accumulator = 0.0;
+	double SimulationTime = 0.0;
+	int64 StepCount = 0;
+	int32 DroppedSteps = 0;
+	float InterpolationAlpha = 0.0f;
+};
@@ -0,0 +1,66 @@
+#include "WRGameplayProfiler.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Crc.h"
+
+bool FWRGameplayProfiler::bEnabled = false;
+uint64 FWRGameplayProfiler::FrameCycles[(int32)EWRProfileCategory::Count] = {};
+
+static TAutoConsoleVariable<int32> CVarGameplayRandomSeed(
+	TEXT("wr.RandomSeed"),
+	0,
+	TEXT("Seed for gameplay random streams (AI, weapons, spawners). 0 = non-deterministic."),
+	ECVF_Default);
+
+void FWRGameplayProfiler::BeginFrame()
+{
+	FMemory::Memzero(FrameCycles, sizeof(FrameCycles));
+}
+
+double FWRGameplayProfiler::GetFrameMilliseconds(EWRProfileCategory Category)
+{
+	return FPlatformTime::ToMilliseconds64(FrameCycles[(int32)Category]);
+}
+
+const TCHAR* FWRGameplayProfiler::GetCategoryName(EWRProfileCategory Category)
+{
+	switch (Category)
+	{
+		case EWRProfileCategory::RaceManager: return TEXT("RaceManager");
+		case EWRProfileCategory::AI: return TEXT("AI");
+		case EWRProfileCategory::Weapons: return TEXT("Weapons");
+		case EWRProfileCategory::Projectiles: return TEXT("Projectiles");
+		case EWRProfileCategory::Hazards: return TEXT("Hazards");
+		case EWRProfileCategory::Spawners: return TEXT("Spawners");
+		default: return TEXT("Unknown");
+	}
+}
+
+FRandomStream FWRGameplayRandom::MakeStream(const UObject* Owner, uint32 Salt)
+{
+	const int32 GlobalSeed = GetGlobalSeed();
+	if (GlobalSeed == 0)
+	{
+		FRandomStream Stream;
+		Stream.GenerateNewSeed();
+		return Stream;
+	}
+
+	// Object names are assigned in spawn order, which is fixed for a given benchmark setup.
+	// Hash the string rather than the FName, whose index depends on name table history.
+	uint32 Hash = HashCombine(GetTypeHash(GlobalSeed), Salt);
+	if (Owner)
+	{
+		Hash = HashCombine(Hash, FCrc::StrCrc32(*Owner->GetName()));
+	}
+	return FRandomStream((int32)Hash);
+}
+
+void FWRGameplayRandom::SetGlobalSeed(int32 Seed)
+{
+	CVarGameplayRandomSeed->Set(Seed, ECVF_SetByCode);
+}
+
+int32 FWRGameplayRandom::GetGlobalSeed()
+{
+	return CVarGameplayRandomSeed.GetValueOnGameThread();
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+enum class EWRProfileCategory : uint8
+{
+	RaceManager,
+	AI,
+	Weapons,
+	Projectiles,
+	Hazards,
+	Spawners,
+	Count
+};
+
+// Lightweight per-frame gameplay timers used by the race benchmark.
+// Scopes cost a single branch when profiling is disabled.
+class WASTELANDRACERS_API FWRGameplayProfiler
+{
+public:
+	static bool IsEnabled() { return bEnabled; }
+	static void SetEnabled(bool bInEnabled) { bEnabled = bInEnabled; }
+
+	static void BeginFrame();
+	static void Accumulate(EWRProfileCategory Category, uint64 Cycles) { FrameCycles[(int32)Category] += Cycles; }
+	static double GetFrameMilliseconds(EWRProfileCategory Category);
+	static const TCHAR* GetCategoryName(EWRProfileCategory Category);
+
+private:
+	static bool bEnabled;
+	static uint64 FrameCycles[(int32)EWRProfileCategory::Count];
+};
+
+struct FWRProfileScope
+{
+	explicit FWRProfileScope(EWRProfileCategory InCategory)
+		: Category(InCategory)
+		, StartCycles(FWRGameplayProfiler::IsEnabled() ? FPlatformTime::Cycles64() : 0)
+	{
+	}
+
+	~FWRProfileScope()
+	{
+		if (StartCycles != 0)
+		{
+			FWRGameplayProfiler::Accumulate(Category, FPlatformTime::Cycles64() - StartCycles);
+		}
+	}
+
+	EWRProfileCategory Category;
+	uint64 StartCycles;
+};
+
+#define WR_PROFILE_SCOPE(Category) FWRProfileScope ANONYMOUS_VARIABLE(WRProfileScope_)(EWRProfileCategory::Category)
+
+// Seeded random streams for gameplay code, so headless benchmark runs are reproducible.
+// wr.RandomSeed 0 keeps the previous non-deterministic behaviour.
+class WASTELANDRACERS_API FWRGameplayRandom
+{
+public:
+	static FRandomStream MakeStream(const UObject* Owner, uint32 Salt = 0);
+	static void SetGlobalSeed(int32 Seed);
+	static int32 GetGlobalSeed();
+};
@@ -0,0 +1,329 @@
+#include "WRCheckpointGates.h"
+#include "WastelandRacers/WastelandRacers.h"
+#include "Components/BoxComponent.h"
+#include "Engine/OverlapResult.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+void FWRCheckpointGates::Reset()
+{
+	for (TArray<float>* Array : { &OriginX, &OriginY, &OriginZ, &NormalX, &NormalY, &NormalZ, &RightX, &RightY, &RightZ, &UpX, &UpY, &UpZ, &HalfWidth, &HalfHeight })
+	{
+		Array->Reset();
+	}
+	CheckpointIndices.Reset();
+	FinishLines.Reset();
+	TrackDistances.Reset();
+	ExpectedGates.Reset();
+}
+
+void FWRCheckpointGates::AddGate(const FVector& Origin, const FVector& Normal, const FVector& Up, const FVector2f& HalfExtents, int32 CheckpointIndex, bool bFinishLine)
+{
+	const FVector GateNormal = Normal.GetSafeNormal();
+	const FVector GateRight = FVector::CrossProduct(Up, GateNormal).GetSafeNormal();
+	const FVector GateUp = FVector::CrossProduct(GateNormal, GateRight);
+
+	OriginX.Add(Origin.X);
+	OriginY.Add(Origin.Y);
+	OriginZ.Add(Origin.Z);
+	NormalX.Add(GateNormal.X);
+	NormalY.Add(GateNormal.Y);
+	NormalZ.Add(GateNormal.Z);
+	RightX.Add(GateRight.X);
+	RightY.Add(GateRight.Y);
+	RightZ.Add(GateRight.Z);
+	UpX.Add(GateUp.X);
+	UpY.Add(GateUp.Y);
+	UpZ.Add(GateUp.Z);
+	HalfWidth.Add(HalfExtents.X);
+	HalfHeight.Add(HalfExtents.Y);
+	CheckpointIndices.Add(CheckpointIndex);
+	FinishLines.Add(bFinishLine ? 1 : 0);
+}
+
+void FWRCheckpointGates::FinalizeGates()
+{
+	// Checkpoints are not guaranteed to face along the track; make each gate face the next one
+	if (Num() < 2)
+	{
+		return;
+	}
+
+	for (int32 Gate = 0; Gate < Num(); Gate++)
+	{
+		const FVector ToNext = GetOrigin((Gate + 1) % Num()) - GetOrigin(Gate);
+		if (FVector::DotProduct(ToNext, FVector(NormalX[Gate], NormalY[Gate], NormalZ[Gate])) < 0.0f)
+		{
+			NormalX[Gate] = -NormalX[Gate];
+			NormalY[Gate] = -NormalY[Gate];
+			NormalZ[Gate] = -NormalZ[Gate];
+			RightX[Gate] = -RightX[Gate];
+			RightY[Gate] = -RightY[Gate];
+			RightZ[Gate] = -RightZ[Gate];
+		}
+	}
+}
+
+void FWRCheckpointGates::ResetKarts(int32 NumKarts)
+{
+	ExpectedGates.Reset();
+	ExpectedGates.AddZeroed(NumKarts);
+	ScratchAlpha.SetNumUninitialized(NumKarts);
+	ScratchHit.SetNumUninitialized(NumKarts);
+	ScratchGate.SetNumUninitialized(NumKarts);
+}
+
+uint64 FWRCheckpointGates::GetCheckpointMask(TArrayView<const int32> Checkpoints) const
+{
+	uint64 Mask = 0;
+	for (int32 Gate = 0; Gate < Num(); Gate++)
+	{
+		if (Checkpoints.Contains(CheckpointIndices[Gate]))
+		{
+			Mask |= GetGateBit(Gate);
+		}
+	}
+	return Mask;
+}
+
+void FWRCheckpointGates::SkipGates(int32 KartIndex, uint64 GateMask)
+{
+	if (!ExpectedGates.IsValidIndex(KartIndex) || Num() == 0)
+	{
+		return;
+	}
+
+	for (int32 Skipped = 0; Skipped < Num() && (GateMask & GetGateBit(GetExpectedGate(KartIndex))); Skipped++)
+	{
+		ExpectedGates[KartIndex]++;
+	}
+}
+
+void FWRCheckpointGates::SetTrackDistances(TArrayView<const float> Distances)
+{
+	check(Distances.Num() == Num());
+	TrackDistances = Distances;
+}
+
+int32 FWRCheckpointGates::FindGateAfter(float TrackDistance) const
+{
+	// Nearest gate ahead, or the first of the lap when the kart is past the last one
+	int32 Ahead = INDEX_NONE;
+	int32 First = INDEX_NONE;
+	for (int32 Gate = 0; Gate < TrackDistances.Num(); Gate++)
+	{
+		if (TrackDistances[Gate] > TrackDistance && (Ahead == INDEX_NONE || TrackDistances[Gate] < TrackDistances[Ahead]))
+		{
+			Ahead = Gate;
+		}
+		if (First == INDEX_NONE || TrackDistances[Gate] < TrackDistances[First])
+		{
+			First = Gate;
+		}
+	}
+	return Ahead != INDEX_NONE ? Ahead : First;
+}
+
+int32 FWRCheckpointGates::GetMissedGates(int32 KartIndex, float TrackDistance) const
+{
+	if (!ExpectedGates.IsValidIndex(KartIndex) || TrackDistances.Num() != Num() || Num() == 0)
+	{
+		return 0;
+	}
+
+	const int32 Missed = (FindGateAfter(TrackDistance) - GetExpectedGate(KartIndex) + Num()) % Num();
+	return Missed <= Num() / 2 ? Missed : 0;
+}
+
+void FWRCheckpointGates::ResyncKart(int32 KartIndex, float TrackDistance)
+{
+	if (!ExpectedGates.IsValidIndex(KartIndex) || TrackDistances.Num() != Num() || Num() == 0)
+	{
+		return;
+	}
+
+	// Only the gate within the lap matters, so the running count just moves on to it
+	ExpectedGates[KartIndex] += (FindGateAfter(TrackDistance) - GetExpectedGate(KartIndex) + Num()) % Num();
+}
+
+void FWRCheckpointGates::Sweep(TArrayView<const FVector> Previous, TArrayView<const FVector> Current, TArray<FWRGateCrossing>& OutCrossings)
+{
+	const int32 NumGates = Num();
+	const int32 NumKarts = FMath::Min3(ExpectedGates.Num(), Previous.Num(), Current.Num());
+	if (NumGates == 0 || NumKarts == 0)
+	{
+		return;
+	}
+
+	for (int32 Kart = 0; Kart < NumKarts; Kart++)
+	{
+		ScratchGate[Kart] = ExpectedGates[Kart];
+	}
+
+	for (int32 Pass = 0; Pass < FMath::Min(Lookahead, NumGates); Pass++)
+	{
+		// Straight-line and branch-free over karts so the compiler can vectorize it
+		for (int32 Kart = 0; Kart < NumKarts; Kart++)
+		{
+			const int32 Gate = (ScratchGate[Kart] + Pass) % NumGates;
+
+			const float StartX = (float)Previous[Kart].X - OriginX[Gate];
+			const float StartY = (float)Previous[Kart].Y - OriginY[Gate];
+			const float StartZ = (float)Previous[Kart].Z - OriginZ[Gate];
+			const float DeltaX = (float)Current[Kart].X - OriginX[Gate] - StartX;
+			const float DeltaY = (float)Current[Kart].Y - OriginY[Gate] - StartY;
+			const float DeltaZ = (float)Current[Kart].Z - OriginZ[Gate] - StartZ;
+
+			const float StartDistance = StartX * NormalX[Gate] + StartY * NormalY[Gate] + StartZ * NormalZ[Gate];
+			const float Travel = DeltaX * NormalX[Gate] + DeltaY * NormalY[Gate] + DeltaZ * NormalZ[Gate];
+			const float Alpha = -StartDistance / FMath::Max(Travel, UE_SMALL_NUMBER);
+
+			const float HitX = StartX + DeltaX * Alpha;
+			const float HitY = StartY + DeltaY * Alpha;
+			const float HitZ = StartZ + DeltaZ * Alpha;
+			const float Across = HitX * RightX[Gate] + HitY * RightY[Gate] + HitZ * RightZ[Gate];
+			const float Height = HitX * UpX[Gate] + HitY * UpY[Gate] + HitZ * UpZ[Gate];
+
+			ScratchHit[Kart] = (uint8)(StartDistance < 0.0f)
+				& (uint8)(StartDistance + Travel >= 0.0f)
+				& (uint8)(FMath::Abs(Across) <= HalfWidth[Gate])
+				& (uint8)(FMath::Abs(Height) <= HalfHeight[Gate]);
+			ScratchAlpha[Kart] = Alpha;
+		}
+
+		for (int32 Kart = 0; Kart < NumKarts; Kart++)
+		{
+			if (ScratchHit[Kart])
+			{
+				FWRGateCrossing& Crossing = OutCrossings.AddDefaulted_GetRef();
+				Crossing.KartIndex = Kart;
+				Crossing.GateIndex = (ScratchGate[Kart] + Pass) % NumGates;
+				Crossing.Alpha = ScratchAlpha[Kart];
+				ExpectedGates[Kart] = ScratchGate[Kart] + Pass + 1;
+			}
+		}
+	}
+}
+
+#if !UE_BUILD_SHIPPING
+// Compares the swept gate test with physics overlap queries against box volumes, on a ring of gates
+static FAutoConsoleCommand BenchCheckpointsCommand(
+	TEXT("wr.Bench.Checkpoints"),
+	TEXT("Benchmarks swept checkpoint gates against box overlap queries (64 gates, 32 karts)"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		const int32 NumGates = 64;
+		const int32 NumKarts = 32;
+		const int32 NumTicks = 2000;
+		const float Radius = 20000.0f;
+		const FVector2f GateHalfExtents(500.0f, 200.0f);
+
+		auto RingPoint = [Radius](float Angle)
+		{
+			return FVector(FMath::Cos(Angle) * Radius, FMath::Sin(Angle) * Radius, 100.0f);
+		};
+
+		FWRCheckpointGates Gates;
+		for (int32 Gate = 0; Gate < NumGates; Gate++)
+		{
+			const float Angle = UE_TWO_PI * Gate / NumGates;
+			const FVector Tangent(-FMath::Sin(Angle), FMath::Cos(Angle), 0.0f);
+			Gates.AddGate(RingPoint(Angle), Tangent, FVector::UpVector, GateHalfExtents, Gate, Gate == 0);
+		}
+		Gates.FinalizeGates();
+		Gates.ResetKarts(NumKarts);
+
+		// Karts lap the ring at 200cc-like speeds, roughly 60 m/s at a 60 Hz step
+		FRandomStream Random(42);
+		TArray<float> Angles;
+		TArray<float> AngularSpeeds;
+		TArray<FVector> Previous;
+		TArray<FVector> Current;
+		for (int32 Kart = 0; Kart < NumKarts; Kart++)
+		{
+			Angles.Add(-0.01f * (Kart + 1));
+			AngularSpeeds.Add(Random.FRandRange(5500.0f, 6500.0f) / 60.0f / Radius);
+			Previous.Add(RingPoint(Angles[Kart]));
+			Current.Add(Previous[Kart]);
+		}
+
+		TArray<FWRGateCrossing> Crossings;
+		Crossings.Reserve(NumKarts * FWRCheckpointGates::Lookahead);
+
+		int32 SweptCrossings = 0;
+		uint64 SweptCycles = 0;
+		for (int32 Tick = 0; Tick < NumTicks; Tick++)
+		{
+			for (int32 Kart = 0; Kart < NumKarts; Kart++)
+			{
+				Previous[Kart] = Current[Kart];
+				Angles[Kart] += AngularSpeeds[Kart];
+				Current[Kart] = RingPoint(Angles[Kart]);
+			}
+
+			Crossings.Reset();
+			const uint64 Start = FPlatformTime::Cycles64();
+			Gates.Sweep(Previous, Current, Crossings);
+			SweptCycles += FPlatformTime::Cycles64() - Start;
+			SweptCrossings += Crossings.Num();
+		}
+
+		const double SweptUs = FPlatformTime::ToMilliseconds64(SweptCycles) * 1000.0 / NumTicks;
+		UE_LOG(LogWastelandRacers, Display, TEXT("Checkpoints swept:  %d gates, %d karts, %.3f us per tick, %d crossings"),
+			NumGates, NumKarts, SweptUs, SweptCrossings);
+
+		// Baseline: the scene queries overlap volumes boil down to, one kart-sized overlap per kart per tick
+		if (!World || !World->GetPhysicsScene())
+		{
+			UE_LOG(LogWastelandRacers, Display, TEXT("Checkpoints overlap: skipped, needs a world with physics"));
+			return;
+		}
+
+		AActor* GateActor = World->SpawnActor<AActor>();
+		TArray<UBoxComponent*> Boxes;
+		for (int32 Gate = 0; Gate < NumGates; Gate++)
+		{
+			const float Angle = UE_TWO_PI * Gate / NumGates;
+			UBoxComponent* Box = NewObject<UBoxComponent>(GateActor);
+			Box->SetBoxExtent(FVector(100.0f, GateHalfExtents.X, GateHalfExtents.Y));
+			Box->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+			Box->SetCollisionObjectType(ECollisionChannel::ECC_WorldStatic);
+			Box->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Overlap);
+			Box->SetWorldLocationAndRotation(RingPoint(Angle), FRotator(0.0f, FMath::RadiansToDegrees(Angle) + 90.0f, 0.0f));
+			Box->RegisterComponent();
+			Boxes.Add(Box);
+		}
+
+		const FCollisionShape KartShape = FCollisionShape::MakeSphere(100.0f);
+		const FCollisionObjectQueryParams ObjectParams(ECollisionChannel::ECC_WorldStatic);
+		TArray<FOverlapResult> Overlaps;
+
+		int32 OverlapHits = 0;
+		uint64 OverlapCycles = 0;
+		for (int32 Tick = 0; Tick < NumTicks; Tick++)
+		{
+			for (int32 Kart = 0; Kart < NumKarts; Kart++)
+			{
+				Angles[Kart] += AngularSpeeds[Kart];
+				Current[Kart] = RingPoint(Angles[Kart]);
+			}
+
+			const uint64 Start = FPlatformTime::Cycles64();
+			for (int32 Kart = 0; Kart < NumKarts; Kart++)
+			{
+				Overlaps.Reset();
+				World->OverlapMultiByObjectType(Overlaps, Current[Kart], FQuat::Identity, ObjectParams, KartShape);
+				OverlapHits += Overlaps.Num();
+			}
+			OverlapCycles += FPlatformTime::Cycles64() - Start;
+		}
+
+		GateActor->Destroy();
+
+		const double OverlapUs = FPlatformTime::ToMilliseconds64(OverlapCycles) * 1000.0 / NumTicks;
+		UE_LOG(LogWastelandRacers, Display, TEXT("Checkpoints overlap: %d boxes, %d karts, %.3f us per tick, %d overlapping pairs (%.1fx swept)"),
+			NumGates, NumKarts, OverlapUs, OverlapHits, SweptUs > 0.0 ? OverlapUs / SweptUs : 0.0);
+	}));
+#endif
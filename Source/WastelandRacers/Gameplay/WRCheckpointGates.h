@@ -0,0 +1,90 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// One kart passing through a gate during a step. Alpha is the fraction of the step's
+// previous-to-current segment at which the gate plane was crossed.
+struct FWRGateCrossing
+{
+	int32 KartIndex = INDEX_NONE;
+	int32 GateIndex = INDEX_NONE;
+	float Alpha = 0.0f;
+};
+
+// Checkpoint gates stored as bounded planes in flat arrays. Every step each kart's movement
+// segment is swept against its next expected gates, so no physics overlap volumes are needed
+// and fast karts cannot tunnel through a checkpoint between frames.
+class WASTELANDRACERS_API FWRCheckpointGates
+{
+public:
+	// Gates after the expected one that are also tested, so a single missed gate does not stall a kart
+	static constexpr int32 Lookahead = 2;
+
+	// Lap validation keeps one bit per gate in a uint64
+	static constexpr int32 MaxGates = 64;
+
+	// Gates a kart can be past without a match before its expected gate is resynced from its track
+	// distance; past Lookahead gates the sweep would never match again
+	static constexpr int32 MaxMissedGates = Lookahead;
+
+	void Reset();
+
+	// Gates must be added in race order. Normals are flipped to face the following gate.
+	void AddGate(const FVector& Origin, const FVector& Normal, const FVector& Up, const FVector2f& HalfExtents, int32 CheckpointIndex, bool bFinishLine);
+	void FinalizeGates();
+
+	void ResetKarts(int32 NumKarts);
+
+	// Appends every gate crossed between Previous[i] and Current[i], advancing each kart's expected gate
+	void Sweep(TArrayView<const FVector> Previous, TArrayView<const FVector> Current, TArray<FWRGateCrossing>& OutCrossings);
+
+	int32 Num() const { return CheckpointIndices.Num(); }
+	bool IsValid() const { return Num() > 0; }
+
+	int32 GetCheckpointIndex(int32 Gate) const { return CheckpointIndices[Gate]; }
+	bool IsFinishLine(int32 Gate) const { return FinishLines[Gate] != 0; }
+	FVector GetOrigin(int32 Gate) const { return FVector(OriginX[Gate], OriginY[Gate], OriginZ[Gate]); }
+
+	// Gate each kart has to pass next, as an index into this gate list
+	int32 GetExpectedGate(int32 KartIndex) const { return ExpectedGates[KartIndex] % Num(); }
+
+	static uint64 GetGateBit(int32 Gate) { return 1ull << Gate; }
+	uint64 GetAllGatesMask() const { return Num() >= MaxGates ? ~0ull : GetGateBit(Num()) - 1; }
+
+	// Bits for the gates of the given checkpoint indices; unknown indices are ignored
+	uint64 GetCheckpointMask(TArrayView<const int32> Checkpoints) const;
+
+	// Moves a kart's expected gate past any run of gates in GateMask, e.g. after a shortcut
+	void SkipGates(int32 KartIndex, uint64 GateMask);
+
+	// Distance along the track centre-line of each gate, in gate order; without them karts are never resynced
+	void SetTrackDistances(TArrayView<const float> Distances);
+
+	// First gate ahead of a track distance, wrapping round the lap
+	int32 FindGateAfter(float TrackDistance) const;
+
+	// Gates between the kart's expected gate and the first one ahead of its track distance. Karts
+	// behind their expected gate, e.g. just short of a gate they were matched on, count none.
+	int32 GetMissedGates(int32 KartIndex, float TrackDistance) const;
+
+	// Makes the first gate ahead of TrackDistance the kart's expected gate, e.g. after a respawn
+	void ResyncKart(int32 KartIndex, float TrackDistance);
+
+private:
+	TArray<float> OriginX, OriginY, OriginZ;
+	TArray<float> NormalX, NormalY, NormalZ;
+	TArray<float> RightX, RightY, RightZ;
+	TArray<float> UpX, UpY, UpZ;
+	TArray<float> HalfWidth, HalfHeight;
+	TArray<int32> CheckpointIndices;
+	TArray<uint8> FinishLines;
+	TArray<float> TrackDistances;
+
+	// Per kart running count of gates passed; modulo Num() gives the expected gate
+	TArray<int32> ExpectedGates;
+
+	// Per-sweep scratch, one entry per kart
+	TArray<float> ScratchAlpha;
+	TArray<uint8> ScratchHit;
+	TArray<int32> ScratchGate;
+};
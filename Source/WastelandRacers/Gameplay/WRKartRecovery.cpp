@@ -0,0 +1,120 @@
+#include "WRKartRecovery.h"
+#include "WastelandRacers/Gameplay/WRTrackProgress.h"
+
+void FWRKartRecovery::ResetKarts(int32 NumKarts)
+{
+	WrongWayTimes.Reset();
+	WrongWayTimes.AddZeroed(NumKarts);
+	OffTrackTimes.Reset();
+	OffTrackTimes.AddZeroed(NumKarts);
+	DestroyedTimes.Reset();
+	DestroyedTimes.AddZeroed(NumKarts);
+	ValidDistances.Init(-1.0f, NumKarts);
+}
+
+void FWRKartRecovery::ResetKart(int32 KartIndex)
+{
+	if (WrongWayTimes.IsValidIndex(KartIndex))
+	{
+		WrongWayTimes[KartIndex] = 0.0f;
+		OffTrackTimes[KartIndex] = 0.0f;
+		DestroyedTimes[KartIndex] = 0.0f;
+		ValidDistances[KartIndex] = -1.0f;
+	}
+}
+
+void FWRKartRecovery::Evaluate(const FWRTrackProgress& Track, TArrayView<const FWRTrackProgressState> TrackStates, TArrayView<const FVector> Locations,
+	TArrayView<const FVector> Velocities, TArrayView<const uint8> KartFlags, float DeltaTime, const FWRKartRecoverySettings& Settings,
+	TArray<FWRKartRespawn>& OutRespawns)
+{
+	if (!Track.IsValid())
+	{
+		return;
+	}
+
+	// Karts registered since the last reset start with clear timers
+	if (WrongWayTimes.Num() < KartFlags.Num())
+	{
+		const int32 NumAdded = KartFlags.Num() - WrongWayTimes.Num();
+		WrongWayTimes.AddZeroed(NumAdded);
+		OffTrackTimes.AddZeroed(NumAdded);
+		DestroyedTimes.AddZeroed(NumAdded);
+		for (int32 Added = 0; Added < NumAdded; Added++)
+		{
+			ValidDistances.Add(-1.0f);
+		}
+	}
+
+	const float OffTrackDistanceSq = FMath::Square(Settings.OffTrackDistance);
+
+	for (int32 i = 0; i < KartFlags.Num(); i++)
+	{
+		if (KartFlags[i] & KartIgnored)
+		{
+			WrongWayTimes[i] = 0.0f;
+			OffTrackTimes[i] = 0.0f;
+			DestroyedTimes[i] = 0.0f;
+			ValidDistances[i] = -1.0f;
+			continue;
+		}
+
+		FVector TrackLocation, TrackDirection;
+		Track.GetPointAtDistance(TrackStates[i].Distance, TrackLocation, TrackDirection);
+
+		const FVector Offset = Locations[i] - TrackLocation;
+		const bool bWrongWay = FVector::DotProduct(Velocities[i], TrackDirection) < -Settings.WrongWaySpeed;
+		const bool bOffTrack = Offset.SizeSquared2D() > OffTrackDistanceSq || Offset.Z < -Settings.FallDistance;
+		const bool bDestroyed = (KartFlags[i] & KartDestroyed) != 0;
+
+		// Far from the centre-line the projection can land on a later section; only steady tracking on the track counts
+		const float Distance = TrackStates[i].Distance;
+		if (!bOffTrack && !bDestroyed)
+		{
+			float Step = FMath::Abs(Distance - ValidDistances[i]);
+			if (Track.IsClosedLoop())
+			{
+				Step = FMath::Min(Step, Track.GetLapLength() - Step);
+			}
+			if (ValidDistances[i] < 0.0f || Step <= Velocities[i].Size() * DeltaTime + MaxTrackedDistanceSlack)
+			{
+				ValidDistances[i] = Distance;
+			}
+		}
+
+		WrongWayTimes[i] = bWrongWay ? WrongWayTimes[i] + DeltaTime : 0.0f;
+		OffTrackTimes[i] = bOffTrack ? OffTrackTimes[i] + DeltaTime : 0.0f;
+		DestroyedTimes[i] = bDestroyed ? DestroyedTimes[i] + DeltaTime : 0.0f;
+
+		EWRRespawnReason Reason;
+		if (bDestroyed && DestroyedTimes[i] >= Settings.DestroyedRespawnTime)
+		{
+			Reason = EWRRespawnReason::Destroyed;
+		}
+		else if (bOffTrack && OffTrackTimes[i] >= Settings.OffTrackRespawnTime)
+		{
+			Reason = EWRRespawnReason::OffTrack;
+		}
+		else if (bWrongWay && WrongWayTimes[i] >= Settings.WrongWayRespawnTime)
+		{
+			Reason = EWRRespawnReason::WrongWay;
+		}
+		else
+		{
+			continue;
+		}
+
+		// Back where the kart was last tracked on the track, so leaving it can never move a kart ahead
+		FVector RespawnLocation = TrackLocation;
+		FVector RespawnDirection = TrackDirection;
+		if (ValidDistances[i] >= 0.0f)
+		{
+			Track.GetPointAtDistance(ValidDistances[i], RespawnLocation, RespawnDirection);
+		}
+
+		FWRKartRespawn& Respawn = OutRespawns.AddDefaulted_GetRef();
+		Respawn.KartIndex = i;
+		Respawn.Reason = Reason;
+		Respawn.Location = RespawnLocation + FVector::UpVector * Settings.RespawnHeight;
+		Respawn.Rotation = FRotator(0.0f, RespawnDirection.Rotation().Yaw, 0.0f);
+	}
+}
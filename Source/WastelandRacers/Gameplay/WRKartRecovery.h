@@ -0,0 +1,90 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WRKartRecovery.generated.h"
+
+class FWRTrackProgress;
+struct FWRTrackProgressState;
+
+UENUM(BlueprintType)
+enum class EWRRespawnReason : uint8
+{
+	WrongWay,
+	OffTrack,
+	Destroyed
+};
+
+USTRUCT(BlueprintType)
+struct FWRKartRecoverySettings
+{
+	GENERATED_BODY()
+
+	// Speed against the track direction above which a kart counts as going the wrong way
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Recovery", meta = (ClampMin = "0.0"))
+	float WrongWaySpeed = 300.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Recovery", meta = (ClampMin = "0.0"))
+	float WrongWayRespawnTime = 4.0f;
+
+	// Horizontal distance from the centre-line beyond which a kart is off the track
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Recovery", meta = (ClampMin = "0.0"))
+	float OffTrackDistance = 2500.0f;
+
+	// Height below the centre-line at which a kart is treated as fallen off
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Recovery", meta = (ClampMin = "0.0"))
+	float FallDistance = 1500.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Recovery", meta = (ClampMin = "0.0"))
+	float OffTrackRespawnTime = 1.5f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Recovery", meta = (ClampMin = "0.0"))
+	float DestroyedRespawnTime = 2.0f;
+
+	// Respawned karts are dropped this far above the centre-line
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Recovery")
+	float RespawnHeight = 100.0f;
+};
+
+struct FWRKartRespawn
+{
+	int32 KartIndex = INDEX_NONE;
+	EWRRespawnReason Reason = EWRRespawnReason::OffTrack;
+	FVector Location = FVector::ZeroVector;
+	FRotator Rotation = FRotator::ZeroRotator;
+};
+
+// Wrong-way, off-track and destroyed detection for every kart in one pass per race step.
+// Each kart's velocity is compared with the centre-line direction at its projected distance;
+// karts that stay in a bad state long enough are returned as respawns on the centre-line at the
+// last distance they were tracked at while on the track.
+class WASTELANDRACERS_API FWRKartRecovery
+{
+public:
+	// Per kart input flags
+	static constexpr uint8 KartIgnored = 1 << 0;
+	static constexpr uint8 KartDestroyed = 1 << 1;
+
+	// Distance along the track a kart may move in a step beyond what its speed covers before the
+	// projection is treated as having jumped to another section, e.g. across a hairpin
+	static constexpr float MaxTrackedDistanceSlack = 500.0f;
+
+	void ResetKarts(int32 NumKarts);
+	void ResetKart(int32 KartIndex);
+
+	// Arrays are indexed by kart; karts flagged KartIgnored are skipped and keep no timers
+	void Evaluate(const FWRTrackProgress& Track, TArrayView<const FWRTrackProgressState> TrackStates, TArrayView<const FVector> Locations,
+		TArrayView<const FVector> Velocities, TArrayView<const uint8> KartFlags, float DeltaTime, const FWRKartRecoverySettings& Settings,
+		TArray<FWRKartRespawn>& OutRespawns);
+
+	bool IsWrongWay(int32 KartIndex) const { return WrongWayTimes.IsValidIndex(KartIndex) && WrongWayTimes[KartIndex] > 0.0f; }
+	bool IsOffTrack(int32 KartIndex) const { return OffTrackTimes.IsValidIndex(KartIndex) && OffTrackTimes[KartIndex] > 0.0f; }
+
+private:
+	// Seconds spent continuously in each state, zero when not in it
+	TArray<float> WrongWayTimes;
+	TArray<float> OffTrackTimes;
+	TArray<float> DestroyedTimes;
+
+	// Last distance each kart was tracked at on the track, negative until there is one
+	TArray<float> ValidDistances;
+};
@@ -0,0 +1,478 @@
+#include "WRKartSpatialHash.h"
+#include "WastelandRacers/WastelandRacers.h"
+#include "WastelandRacers/Vehicles/WRKart.h"
+#include "Components/SphereComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/OverlapResult.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+static TAutoConsoleVariable<float> CVarSpatialCellSize(
+	TEXT("wr.Spatial.CellSize"),
+	2000.0f,
+	TEXT("Cell size in cm of the kart spatial hash. Around the most common query radius works best."),
+	ECVF_Default);
+
+// Keeps OutIndices sorted by distance, dropping the farthest once full
+static void InsertNearest(int32 Index, float DistanceSq, TArrayView<int32> OutIndices, TArrayView<float> OutDistancesSq, int32& NumFound)
+{
+	const int32 Capacity = OutIndices.Num();
+	if (NumFound == Capacity && DistanceSq >= OutDistancesSq[Capacity - 1])
+	{
+		return;
+	}
+
+	int32 Slot = FMath::Min(NumFound, Capacity - 1);
+	while (Slot > 0 && OutDistancesSq[Slot - 1] > DistanceSq)
+	{
+		OutIndices[Slot] = OutIndices[Slot - 1];
+		OutDistancesSq[Slot] = OutDistancesSq[Slot - 1];
+		Slot--;
+	}
+
+	OutIndices[Slot] = Index;
+	OutDistancesSq[Slot] = DistanceSq;
+	NumFound = FMath::Min(NumFound + 1, Capacity);
+}
+
+void FWRKartSpatialHash::Reserve(int32 MaxEntries)
+{
+	BucketStarts.Reserve(NumBuckets + 1);
+	for (TArray<int32>* Array : { &SortedIndices, &SortedCellX, &SortedCellY, &ScratchBuckets })
+	{
+		Array->Reserve(MaxEntries);
+	}
+	for (TArray<float>* Array : { &SortedX, &SortedY, &SortedZ })
+	{
+		Array->Reserve(MaxEntries);
+	}
+}
+
+void FWRKartSpatialHash::Build(TArrayView<const FVector> Locations, float InCellSize)
+{
+	CellSize = FMath::Max(InCellSize, 1.0f);
+	InvCellSize = 1.0f / CellSize;
+
+	const int32 NumEntries = Locations.Num();
+	for (TArray<int32>* Array : { &SortedIndices, &SortedCellX, &SortedCellY, &ScratchBuckets })
+	{
+		Array->SetNumUninitialized(NumEntries, EAllowShrinking::No);
+	}
+	for (TArray<float>* Array : { &SortedX, &SortedY, &SortedZ })
+	{
+		Array->SetNumUninitialized(NumEntries, EAllowShrinking::No);
+	}
+
+	// Counting sort: count into BucketStarts[B + 1], prefix sum, then scatter using BucketStarts[B] as the cursor
+	BucketStarts.Reset();
+	BucketStarts.AddZeroed(NumBuckets + 1);
+
+	for (int32 i = 0; i < NumEntries; i++)
+	{
+		const int32 Bucket = GetBucket(GetCell(Locations[i].X), GetCell(Locations[i].Y));
+		ScratchBuckets[i] = Bucket;
+		BucketStarts[Bucket + 1]++;
+	}
+
+	for (int32 Bucket = 0; Bucket < NumBuckets; Bucket++)
+	{
+		BucketStarts[Bucket + 1] += BucketStarts[Bucket];
+	}
+
+	for (int32 i = 0; i < NumEntries; i++)
+	{
+		const int32 Slot = BucketStarts[ScratchBuckets[i]]++;
+		SortedIndices[Slot] = i;
+		SortedX[Slot] = Locations[i].X;
+		SortedY[Slot] = Locations[i].Y;
+		SortedZ[Slot] = Locations[i].Z;
+		SortedCellX[Slot] = GetCell(Locations[i].X);
+		SortedCellY[Slot] = GetCell(Locations[i].Y);
+	}
+
+	// The scatter left every start pointing at the next bucket's
+	for (int32 Bucket = NumBuckets; Bucket > 0; Bucket--)
+	{
+		BucketStarts[Bucket] = BucketStarts[Bucket - 1];
+	}
+	BucketStarts[0] = 0;
+}
+
+template <typename FunctionType>
+void FWRKartSpatialHash::ForEachInCell(int32 CellX, int32 CellY, FunctionType&& Function) const
+{
+	const int32 Bucket = GetBucket(CellX, CellY);
+	for (int32 Slot = BucketStarts[Bucket]; Slot < BucketStarts[Bucket + 1]; Slot++)
+	{
+		if (SortedCellX[Slot] == CellX && SortedCellY[Slot] == CellY)
+		{
+			Function(Slot);
+		}
+	}
+}
+
+template <typename FunctionType>
+void FWRKartSpatialHash::ForEachInRange(const FVector& Center, float Range, FunctionType&& Function) const
+{
+	// Once the range covers more cells than there are entries, walking the entries is cheaper
+	const float CellSpan = 2.0f * Range * InvCellSize + 2.0f;
+	if (CellSpan * CellSpan > FMath::Min(NumBuckets, Num()))
+	{
+		for (int32 Slot = 0; Slot < Num(); Slot++)
+		{
+			Function(Slot);
+		}
+		return;
+	}
+
+	const int32 MaxCellX = GetCell(Center.X + Range);
+	const int32 MaxCellY = GetCell(Center.Y + Range);
+	for (int32 CellY = GetCell(Center.Y - Range); CellY <= MaxCellY; CellY++)
+	{
+		for (int32 CellX = GetCell(Center.X - Range); CellX <= MaxCellX; CellX++)
+		{
+			ForEachInCell(CellX, CellY, Function);
+		}
+	}
+}
+
+int32 FWRKartSpatialHash::QueryRadius(const FVector& Center, float Radius, TArrayView<int32> OutIndices, int32 IgnoreIndex) const
+{
+	if (OutIndices.Num() == 0 || Num() == 0)
+	{
+		return 0;
+	}
+
+	const float RadiusSq = FMath::Square(Radius);
+	int32 NumFound = 0;
+	ForEachInRange(Center, Radius, [&](int32 Slot)
+	{
+		const float DistanceSq = FMath::Square(SortedX[Slot] - (float)Center.X) + FMath::Square(SortedY[Slot] - (float)Center.Y)
+			+ FMath::Square(SortedZ[Slot] - (float)Center.Z);
+		if (NumFound < OutIndices.Num() && DistanceSq <= RadiusSq && SortedIndices[Slot] != IgnoreIndex)
+		{
+			OutIndices[NumFound++] = SortedIndices[Slot];
+		}
+	});
+	return NumFound;
+}
+
+int32 FWRKartSpatialHash::QueryCone(const FVector& Origin, const FVector& Direction, float Range, float HalfAngleDegrees, TArrayView<int32> OutIndices,
+	int32 IgnoreIndex) const
+{
+	if (OutIndices.Num() == 0 || Num() == 0)
+	{
+		return 0;
+	}
+
+	TArray<float, TInlineAllocator<32>> DistancesSq;
+	DistancesSq.SetNumUninitialized(OutIndices.Num());
+
+	const float RangeSq = FMath::Square(Range);
+	const float CosHalfAngle = FMath::Cos(FMath::DegreesToRadians(HalfAngleDegrees));
+	int32 NumFound = 0;
+	ForEachInRange(Origin, Range, [&](int32 Slot)
+	{
+		const FVector3f Offset(SortedX[Slot] - (float)Origin.X, SortedY[Slot] - (float)Origin.Y, SortedZ[Slot] - (float)Origin.Z);
+		const float DistanceSq = Offset.SizeSquared();
+		if (DistanceSq <= RangeSq && SortedIndices[Slot] != IgnoreIndex
+			&& FVector3f::DotProduct(Offset, FVector3f(Direction)) >= CosHalfAngle * FMath::Sqrt(DistanceSq))
+		{
+			InsertNearest(SortedIndices[Slot], DistanceSq, OutIndices, DistancesSq, NumFound);
+		}
+	});
+	return NumFound;
+}
+
+int32 FWRKartSpatialHash::QueryNearest(const FVector& Point, float MaxDistance, TArrayView<int32> OutIndices, int32 IgnoreIndex) const
+{
+	if (OutIndices.Num() == 0 || Num() == 0)
+	{
+		return 0;
+	}
+
+	TArray<float, TInlineAllocator<32>> DistancesSq;
+	DistancesSq.SetNumUninitialized(OutIndices.Num());
+
+	const float MaxDistanceSq = FMath::Square(MaxDistance);
+	int32 NumFound = 0;
+	int32 NumVisited = 0;
+	auto Visit = [&](int32 Slot)
+	{
+		NumVisited++;
+		const float DistanceSq = FMath::Square(SortedX[Slot] - (float)Point.X) + FMath::Square(SortedY[Slot] - (float)Point.Y)
+			+ FMath::Square(SortedZ[Slot] - (float)Point.Z);
+		if (DistanceSq <= MaxDistanceSq && SortedIndices[Slot] != IgnoreIndex)
+		{
+			InsertNearest(SortedIndices[Slot], DistanceSq, OutIndices, DistancesSq, NumFound);
+		}
+	};
+
+	const float CellSpan = 2.0f * MaxDistance * InvCellSize + 2.0f;
+	if (CellSpan * CellSpan > NumBuckets)
+	{
+		for (int32 Slot = 0; Slot < Num(); Slot++)
+		{
+			Visit(Slot);
+		}
+		return NumFound;
+	}
+
+	// Grow square rings of cells outwards; anything beyond ring R is at least R cells away
+	const int32 CenterX = GetCell(Point.X);
+	const int32 CenterY = GetCell(Point.Y);
+	const int32 MaxRing = FMath::FloorToInt32(MaxDistance * InvCellSize) + 1;
+	for (int32 Ring = 0; Ring <= MaxRing; Ring++)
+	{
+		if (Ring == 0)
+		{
+			ForEachInCell(CenterX, CenterY, Visit);
+		}
+		else
+		{
+			for (int32 CellX = CenterX - Ring; CellX <= CenterX + Ring; CellX++)
+			{
+				ForEachInCell(CellX, CenterY - Ring, Visit);
+				ForEachInCell(CellX, CenterY + Ring, Visit);
+			}
+			for (int32 CellY = CenterY - Ring + 1; CellY < CenterY + Ring; CellY++)
+			{
+				ForEachInCell(CenterX - Ring, CellY, Visit);
+				ForEachInCell(CenterX + Ring, CellY, Visit);
+			}
+		}
+
+		const bool bFull = NumFound == OutIndices.Num() && DistancesSq[NumFound - 1] <= FMath::Square(Ring * CellSize);
+		if (bFull || NumVisited == Num())
+		{
+			break;
+		}
+	}
+	return NumFound;
+}
+
+UWRKartSpatialSubsystem* UWRKartSpatialSubsystem::GetInstance(const UObject* WorldContext)
+{
+	if (const UWorld* World = GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::ReturnNull))
+	{
+		return World->GetSubsystem<UWRKartSpatialSubsystem>();
+	}
+	return nullptr;
+}
+
+bool UWRKartSpatialSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UWRKartSpatialSubsystem::Deinitialize()
+{
+	Karts.Empty();
+	Locations.Empty();
+	Super::Deinitialize();
+}
+
+TStatId UWRKartSpatialSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UWRKartSpatialSubsystem, STATGROUP_Tickables);
+}
+
+void UWRKartSpatialSubsystem::RegisterKart(AWRKart* Kart)
+{
+	if (Kart)
+	{
+		Karts.AddUnique(Kart);
+		Hash.Reserve(Karts.Num());
+		Rebuild();
+	}
+}
+
+void UWRKartSpatialSubsystem::UnregisterKart(AWRKart* Kart)
+{
+	// Rebuilt straight away so no query can return an index past the removed kart
+	if (Karts.Remove(Kart) > 0)
+	{
+		Rebuild();
+	}
+}
+
+void UWRKartSpatialSubsystem::Tick(float DeltaTime)
+{
+	Karts.RemoveAll([](const AWRKart* Kart) { return !IsValid(Kart); });
+	Rebuild();
+}
+
+void UWRKartSpatialSubsystem::Rebuild()
+{
+	Locations.SetNumUninitialized(Karts.Num(), EAllowShrinking::No);
+	for (int32 i = 0; i < Karts.Num(); i++)
+	{
+		Locations[i] = Karts[i] ? Karts[i]->GetActorLocation() : FVector::ZeroVector;
+	}
+	Hash.Build(Locations, CVarSpatialCellSize.GetValueOnGameThread());
+}
+
+int32 UWRKartSpatialSubsystem::ResolveKarts(TArrayView<const int32> Indices, TArrayView<AWRKart*> OutKarts) const
+{
+	int32 NumKarts = 0;
+	for (const int32 Index : Indices)
+	{
+		if (IsValid(Karts[Index]))
+		{
+			OutKarts[NumKarts++] = Karts[Index];
+		}
+	}
+	return NumKarts;
+}
+
+int32 UWRKartSpatialSubsystem::QueryRadius(const FVector& Center, float Radius, TArrayView<AWRKart*> OutKarts, const AWRKart* Ignore) const
+{
+	TArray<int32, TInlineAllocator<32>> Indices;
+	Indices.SetNumUninitialized(OutKarts.Num());
+	const int32 NumFound = Hash.QueryRadius(Center, Radius, Indices, Karts.IndexOfByKey(Ignore));
+	return ResolveKarts(MakeArrayView(Indices.GetData(), NumFound), OutKarts);
+}
+
+int32 UWRKartSpatialSubsystem::QueryCone(const FVector& Origin, const FVector& Direction, float Range, float HalfAngleDegrees, TArrayView<AWRKart*> OutKarts,
+	const AWRKart* Ignore) const
+{
+	TArray<int32, TInlineAllocator<32>> Indices;
+	Indices.SetNumUninitialized(OutKarts.Num());
+	const int32 NumFound = Hash.QueryCone(Origin, Direction, Range, HalfAngleDegrees, Indices, Karts.IndexOfByKey(Ignore));
+	return ResolveKarts(MakeArrayView(Indices.GetData(), NumFound), OutKarts);
+}
+
+int32 UWRKartSpatialSubsystem::QueryNearest(const FVector& Point, float MaxDistance, TArrayView<AWRKart*> OutKarts, const AWRKart* Ignore) const
+{
+	TArray<int32, TInlineAllocator<32>> Indices;
+	Indices.SetNumUninitialized(OutKarts.Num());
+	const int32 NumFound = Hash.QueryNearest(Point, MaxDistance, Indices, Karts.IndexOfByKey(Ignore));
+	return ResolveKarts(MakeArrayView(Indices.GetData(), NumFound), OutKarts);
+}
+
+#if !UE_BUILD_SHIPPING
+// Compares the hash with physics overlap queries against sphere components, at a constant density
+static FAutoConsoleCommand BenchKartSpatialHashCommand(
+	TEXT("wr.Bench.KartSpatialHash"),
+	TEXT("Benchmarks kart spatial hash radius queries against OverlapMultiByChannel (8, 64 and 256 entities)"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		const int32 NumTicks = 500;
+		const float QueryRadius = 1500.0f;
+		const float EntityRadius = 100.0f;
+		const float CellSize = CVarSpatialCellSize.GetValueOnGameThread();
+
+		for (const int32 NumEntities : { 8, 64, 256 })
+		{
+			// Roughly one entity per 20 m square, moving at kart speeds on a 60 Hz step
+			const float HalfSize = FMath::Sqrt((float)NumEntities) * 1000.0f;
+			FRandomStream Random(42);
+			TArray<FVector> Locations;
+			TArray<FVector> Velocities;
+			for (int32 i = 0; i < NumEntities; i++)
+			{
+				Locations.Add(FVector(Random.FRandRange(-HalfSize, HalfSize), Random.FRandRange(-HalfSize, HalfSize), 100.0f));
+				Velocities.Add(FVector(Random.FRandRange(-100.0f, 100.0f), Random.FRandRange(-100.0f, 100.0f), 0.0f));
+			}
+
+			auto Step = [&Locations, &Velocities, HalfSize]()
+			{
+				for (int32 i = 0; i < Locations.Num(); i++)
+				{
+					Locations[i] += Velocities[i];
+					if (FMath::Abs(Locations[i].X) > HalfSize) { Velocities[i].X = -Velocities[i].X; }
+					if (FMath::Abs(Locations[i].Y) > HalfSize) { Velocities[i].Y = -Velocities[i].Y; }
+				}
+			};
+			const TArray<FVector> StartLocations = Locations;
+			const TArray<FVector> StartVelocities = Velocities;
+
+			FWRKartSpatialHash Hash;
+			Hash.Reserve(NumEntities);
+			int32 Results[256];
+
+			int32 HashHits = 0;
+			uint64 BuildCycles = 0;
+			uint64 HashQueryCycles = 0;
+			for (int32 Tick = 0; Tick < NumTicks; Tick++)
+			{
+				Step();
+
+				const uint64 BuildStart = FPlatformTime::Cycles64();
+				Hash.Build(Locations, CellSize);
+				const uint64 QueryStart = FPlatformTime::Cycles64();
+				for (int32 i = 0; i < NumEntities; i++)
+				{
+					HashHits += Hash.QueryRadius(Locations[i], QueryRadius, Results, i);
+				}
+				HashQueryCycles += FPlatformTime::Cycles64() - QueryStart;
+				BuildCycles += QueryStart - BuildStart;
+			}
+
+			const double BuildUs = FPlatformTime::ToMilliseconds64(BuildCycles) * 1000.0 / NumTicks;
+			const double HashQueryUs = FPlatformTime::ToMilliseconds64(HashQueryCycles) * 1000.0 / NumTicks;
+			UE_LOG(LogWastelandRacers, Display, TEXT("KartSpatialHash hash:    %d entities, build %.3f us, %d queries %.3f us per tick, %d hits"),
+				NumEntities, BuildUs, NumEntities, HashQueryUs, HashHits);
+
+			if (!World || !World->GetPhysicsScene())
+			{
+				UE_LOG(LogWastelandRacers, Display, TEXT("KartSpatialHash overlap: skipped, needs a world with physics"));
+				continue;
+			}
+
+			Locations = StartLocations;
+			Velocities = StartVelocities;
+
+			AActor* EntityActor = World->SpawnActor<AActor>();
+			TArray<USphereComponent*> Spheres;
+			for (int32 i = 0; i < NumEntities; i++)
+			{
+				USphereComponent* Sphere = NewObject<USphereComponent>(EntityActor);
+				Sphere->SetSphereRadius(EntityRadius);
+				Sphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+				Sphere->SetCollisionObjectType(ECollisionChannel::ECC_WorldDynamic);
+				Sphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Overlap);
+				Sphere->SetWorldLocation(Locations[i]);
+				Sphere->RegisterComponent();
+				Spheres.Add(Sphere);
+			}
+
+			// Shrunk by the entity radius so the same centres count as hits
+			const FCollisionShape QueryShape = FCollisionShape::MakeSphere(QueryRadius - EntityRadius);
+			TArray<FOverlapResult> Overlaps;
+
+			int32 OverlapHits = 0;
+			uint64 MoveCycles = 0;
+			uint64 OverlapQueryCycles = 0;
+			for (int32 Tick = 0; Tick < NumTicks; Tick++)
+			{
+				Step();
+
+				const uint64 MoveStart = FPlatformTime::Cycles64();
+				for (int32 i = 0; i < NumEntities; i++)
+				{
+					Spheres[i]->SetWorldLocation(Locations[i]);
+				}
+				const uint64 QueryStart = FPlatformTime::Cycles64();
+				for (int32 i = 0; i < NumEntities; i++)
+				{
+					Overlaps.Reset();
+					World->OverlapMultiByChannel(Overlaps, Locations[i], FQuat::Identity, ECollisionChannel::ECC_WorldDynamic, QueryShape);
+					OverlapHits += Overlaps.Num() - 1;
+				}
+				OverlapQueryCycles += FPlatformTime::Cycles64() - QueryStart;
+				MoveCycles += QueryStart - MoveStart;
+			}
+
+			EntityActor->Destroy();
+
+			const double MoveUs = FPlatformTime::ToMilliseconds64(MoveCycles) * 1000.0 / NumTicks;
+			const double OverlapQueryUs = FPlatformTime::ToMilliseconds64(OverlapQueryCycles) * 1000.0 / NumTicks;
+			const double HashUs = BuildUs + HashQueryUs;
+			UE_LOG(LogWastelandRacers, Display, TEXT("KartSpatialHash overlap: %d entities, move %.3f us, %d queries %.3f us per tick, %d hits (%.1fx hash)"),
+				NumEntities, MoveUs, NumEntities, OverlapQueryUs, OverlapHits, HashUs > 0.0 ? (MoveUs + OverlapQueryUs) / HashUs : 0.0);
+		}
+	}));
+#endif
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WRKartSpatialHash.generated.h"
+
+// Uniform planar grid over entity positions, hashed into a fixed number of buckets and stored
+// cell-sorted in flat arrays. Rebuilding is a counting sort with no allocation once reserved.
+// Queries write entity indices into caller-provided arrays and return how many were written.
+class WASTELANDRACERS_API FWRKartSpatialHash
+{
+public:
+	// Power of two so the hash is a mask
+	static constexpr int32 NumBuckets = 1024;
+
+	void Reserve(int32 MaxEntries);
+	void Build(TArrayView<const FVector> Locations, float InCellSize);
+
+	int32 Num() const { return SortedIndices.Num(); }
+	float GetCellSize() const { return CellSize; }
+
+	// Entities within Radius, in no particular order; stops once OutIndices is full
+	int32 QueryRadius(const FVector& Center, float Radius, TArrayView<int32> OutIndices, int32 IgnoreIndex = INDEX_NONE) const;
+
+	// Entities within Range and HalfAngleDegrees of Direction (unit length), nearest first
+	int32 QueryCone(const FVector& Origin, const FVector& Direction, float Range, float HalfAngleDegrees, TArrayView<int32> OutIndices,
+		int32 IgnoreIndex = INDEX_NONE) const;
+
+	// The OutIndices.Num() nearest entities within MaxDistance, nearest first
+	int32 QueryNearest(const FVector& Point, float MaxDistance, TArrayView<int32> OutIndices, int32 IgnoreIndex = INDEX_NONE) const;
+
+private:
+	float CellSize = 1.0f;
+	float InvCellSize = 1.0f;
+
+	// Start of each bucket in the sorted arrays; bucket B spans [BucketStarts[B], BucketStarts[B + 1])
+	TArray<int32> BucketStarts;
+
+	// Entries sorted by bucket. The cell is kept so cells that collide in a bucket can be told apart.
+	TArray<int32> SortedIndices;
+	TArray<float> SortedX, SortedY, SortedZ;
+	TArray<int32> SortedCellX, SortedCellY;
+	TArray<int32> ScratchBuckets;
+
+	int32 GetCell(float Value) const { return FMath::FloorToInt32(Value * InvCellSize); }
+	static int32 GetBucket(int32 CellX, int32 CellY) { return (int32)(((uint32)CellX * 73856093u) ^ ((uint32)CellY * 19349663u)) & (NumBuckets - 1); }
+
+	template <typename FunctionType>
+	void ForEachInCell(int32 CellX, int32 CellY, FunctionType&& Function) const;
+
+	template <typename FunctionType>
+	void ForEachInRange(const FVector& Center, float Range, FunctionType&& Function) const;
+};
+
+// Kart positions for proximity queries (explosions, weapon targeting, awareness), rebuilt once per
+// tick. Results are as of the last rebuild, so at most one frame old.
+UCLASS()
+class WASTELANDRACERS_API UWRKartSpatialSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UWRKartSpatialSubsystem* GetInstance(const UObject* WorldContext);
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterKart(class AWRKart* Kart);
+	void UnregisterKart(class AWRKart* Kart);
+
+	// Same contracts as FWRKartSpatialHash, returning karts; Ignore is typically the querying kart
+	int32 QueryRadius(const FVector& Center, float Radius, TArrayView<class AWRKart*> OutKarts, const class AWRKart* Ignore = nullptr) const;
+	int32 QueryCone(const FVector& Origin, const FVector& Direction, float Range, float HalfAngleDegrees, TArrayView<class AWRKart*> OutKarts,
+		const class AWRKart* Ignore = nullptr) const;
+	int32 QueryNearest(const FVector& Point, float MaxDistance, TArrayView<class AWRKart*> OutKarts, const class AWRKart* Ignore = nullptr) const;
+
+	int32 GetNumKarts() const { return Karts.Num(); }
+
+private:
+	UPROPERTY()
+	TArray<class AWRKart*> Karts;
+
+	TArray<FVector> Locations;
+	FWRKartSpatialHash Hash;
+
+	void Rebuild();
+	int32 ResolveKarts(TArrayView<const int32> Indices, TArrayView<class AWRKart*> OutKarts) const;
+};
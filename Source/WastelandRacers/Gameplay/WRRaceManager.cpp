@@ -1,8 +1,30 @@
 #include "WRRaceManager.h"
 #include "WastelandRacers/Vehicles/WRKart.h"
+#include "WastelandRacers/AI/WRAIController.h"
 #include "WastelandRacers/Core/WRGameInstance.h"
 #include "WastelandRacers/Shop/WRProShop.h"
+#include "WastelandRacers/Tracks/WRTrackVariations.h"
+#include "WastelandRacers/Tracks/WRTrackCheckpoint.h"
+#include "WastelandRacers/Tracks/WRShortcutSystem.h"
+#include "WastelandRacers/Core/WRGameplayProfiler.h"
+#include "WastelandRacers/Core/WRGameplayClock.h"
+#include "WastelandRacers/Replay/WRReplaySubsystem.h"
+#include "WastelandRacers/Replay/WRGhostSubsystem.h"
+#include "WastelandRacers/Audio/WRAudioManager.h"
+#include "NiagaraFunctionLibrary.h"
+#include "Components/SplineComponent.h"
 #include "Engine/Engine.h"
+#include "EngineUtils.h"
+#include "Kismet/GameplayStatics.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+
+static TAutoConsoleVariable<int32> CVarRecordTelemetry(
+	TEXT("wr.Telemetry"),
+	0,
+	TEXT("1 = record kart telemetry to Saved/Telemetry for every race."),
+	ECVF_Default);
 
 AWRRaceManager::AWRRaceManager()
 {
@@ -12,16 +34,61 @@ AWRRaceManager::AWRRaceManager()
 void AWRRaceManager::BeginPlay()
 {
 	Super::BeginPlay();
+
+	// Race phase runs after vehicles, weapons and hazards in every fixed step
+	if (UWRGameplayClock* Clock = UWRGameplayClock::GetInstance(this))
+	{
+		FixedStepHandle = Clock->Register(EWRFixedStepPhase::Race, FWROnFixedStep::FDelegate::CreateUObject(this, &AWRRaceManager::FixedStep));
+		SetActorTickEnabled(false);
+	}
+
+	if (UWRRaceWorldSubsystem* RaceWorld = UWRRaceWorldSubsystem::GetInstance(this))
+	{
+		RaceWorld->RegisterRaceManager(this);
+		RaceEventsHandle = RaceWorld->OnRaceEvents.AddUObject(this, &AWRRaceManager::HandleRaceEvents);
+	}
+}
+
+void AWRRaceManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UWRRaceWorldSubsystem* RaceWorld = UWRRaceWorldSubsystem::GetInstance(this))
+	{
+		RaceWorld->OnRaceEvents.Remove(RaceEventsHandle);
+		RaceWorld->UnregisterRaceManager(this);
+	}
+
+	if (UWRGameplayClock* Clock = UWRGameplayClock::GetInstance(this))
+	{
+		Clock->Unregister(EWRFixedStepPhase::Race, FixedStepHandle);
+	}
+
+	Telemetry.Stop();
+	Super::EndPlay(EndPlayReason);
 }
 
 void AWRRaceManager::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+	if (!FixedStepHandle.IsValid())
+	{
+		FixedStep(DeltaTime);
+	}
+}
+
+void AWRRaceManager::FixedStep(float FixedDeltaTime)
+{
+	WR_PROFILE_SCOPE(RaceManager);
+
+	if (bSuspended)
+	{
+		return;
+	}
+
 	switch (CurrentRaceState)
 	{
 		case ERaceState::Countdown:
-			CountdownTimer -= DeltaTime;
+			CountdownTimer -= FixedDeltaTime;
 			if (CountdownTimer <= 0.0f)
 			{
 				UpdateRaceState(ERaceState::Racing);
@@ -29,9 +96,21 @@ void AWRRaceManager::Tick(float DeltaTime)
 			break;
 
 		case ERaceState::Racing:
-			RaceTime += DeltaTime;
+		{
+			// Physics moves karts once per frame, so later steps in the same frame have no new motion to sweep
+			const bool bSampled = SampleStepLocations();
+			RaceTime += FixedDeltaTime;
+			if (bSampled)
+			{
+				SweepCheckpointGates();
+			}
 			UpdateKartPositions();
+			ResyncMissedGates();
+			RecoverKarts(FixedDeltaTime);
+			UpdateRubberBanding(FixedDeltaTime);
+			RecordTelemetry(FixedDeltaTime);
 			break;
+		}
 	}
 }
 
@@ -39,6 +118,24 @@ void AWRRaceManager::Initialize(int32 InTotalLaps, int32 InMaxPlayers)
 {
 	TotalLaps = InTotalLaps;
 	MaxPlayers = InMaxPlayers;
+
+	// Sized up front so the per-tick standings update never reallocates
+	RegisteredKarts.Reserve(MaxPlayers);
+	KartTrackStates.Reserve(MaxPlayers);
+	KartRaceProgress.Reserve(MaxPlayers);
+	KartLapTimings.Reserve(MaxPlayers);
+	PreviousStepLocations.Reserve(MaxPlayers);
+	StepLocations.Reserve(MaxPlayers);
+	StepVelocities.Reserve(MaxPlayers);
+	StepRecoveryFlags.Reserve(MaxPlayers);
+	StepRespawns.Reserve(MaxPlayers);
+	StepRubberBandFlags.Reserve(MaxPlayers);
+	StepDifficulties.Reserve(MaxPlayers);
+	KartTorqueScales.Reserve(MaxPlayers);
+	KartPassedGates.Reserve(MaxPlayers);
+	KartBypassedGates.Reserve(MaxPlayers);
+	StepCrossings.Reserve(MaxPlayers * FWRCheckpointGates::Lookahead);
+	Standings.Reserve(MaxPlayers);
 	UpdateRaceState(ERaceState::Waiting);
 }
 
@@ -46,6 +143,12 @@ void AWRRaceManager::StartRace()
 {
 	if (CurrentRaceState == ERaceState::Waiting)
 	{
+		if (!TrackProgress.IsValid())
+		{
+			BuildTrackProgress();
+		}
+		BuildRouteGraph();
+
 		CountdownTimer = CountdownTime;
 		UpdateRaceState(ERaceState::Countdown);
 		UE_LOG(LogTemp, Warning, TEXT("Race countdown started"));
@@ -66,26 +169,60 @@ void AWRRaceManager::RegisterKart(AWRKart* Kart)
 	if (Kart && !RegisteredKarts.Contains(Kart))
 	{
 		RegisteredKarts.Add(Kart);
+		KartTrackStates.AddDefaulted();
+		KartRaceProgress.Add(0.0f);
+		KartLapTimings.AddDefaulted();
+		PreviousStepLocations.Add(Kart->GetActorLocation());
+		StepLocations.Add(Kart->GetActorLocation());
+		StepVelocities.Add(FVector::ZeroVector);
+		StepRecoveryFlags.Add(FWRKartRecovery::KartIgnored);
+		StepRubberBandFlags.Add(0);
+		StepDifficulties.Add(0.0f);
+		KartTorqueScales.Add(1.0f);
+		KartPassedGates.Add(0);
+		KartBypassedGates.Add(0);
+		Standings.Add(RegisteredKarts.Num() - 1);
+		Kart->SetRacePosition(Standings.Num());
 		UE_LOG(LogTemp, Warning, TEXT("Registered kart: %s"), *Kart->GetName());
 	}
 }
 
-void AWRRaceManager::OnKartPassedCheckpoint(AWRKart* Kart, int32 CheckpointIndex)
+void AWRRaceManager::OnKartPassedCheckpoint(AWRKart* Kart, int32 CheckpointIndex, float CrossingTime)
 {
 	if (!Kart || CurrentRaceState != ERaceState::Racing)
 		return;
 
-	// Update kart progress tracking
-	UE_LOG(LogTemp, Warning, TEXT("Kart %s passed checkpoint %d"), *Kart->GetName(), CheckpointIndex);
+	const int32 KartIndex = RegisteredKarts.IndexOfByKey(Kart);
+	if (KartLapTimings.IsValidIndex(KartIndex))
+	{
+		FWRKartLapTiming& Timing = KartLapTimings[KartIndex];
+		const int32 Sector = Timing.CloseSector(CrossingTime >= 0.0f ? CrossingTime : RaceTime);
+		UE_LOG(LogWastelandRacers, Verbose, TEXT("Kart %s passed checkpoint %d, sector %d: %.3f"), *Kart->GetName(), CheckpointIndex, Sector + 1, Timing.CurrentSectorTimes[Sector]);
+	}
 }
 
-void AWRRaceManager::OnKartCompletedLap(AWRKart* Kart)
+void AWRRaceManager::OnKartCompletedLap(AWRKart* Kart, float CrossingTime)
 {
 	if (!Kart || CurrentRaceState != ERaceState::Racing)
 		return;
 
+	const float Time = CrossingTime >= 0.0f ? CrossingTime : RaceTime;
+	const int32 KartIndex = RegisteredKarts.IndexOfByKey(Kart);
+	FWRKartLapTiming* Timing = KartLapTimings.IsValidIndex(KartIndex) ? &KartLapTimings[KartIndex] : nullptr;
+	if (Timing && Timing->HasFinished())
+		return;
+
+	Kart->SetCurrentLap(Kart->GetCurrentLap() + 1);
+
 	int32 CurrentLap = Kart->GetCurrentLap();
-	UE_LOG(LogTemp, Warning, TEXT("Kart %s completed lap %d"), *Kart->GetName(), CurrentLap);
+	const float LapTime = Timing ? Timing->CompleteLap(Time) : -1.0f;
+	UE_LOG(LogWastelandRacers, Verbose, TEXT("Kart %s completed lap %d in %.3f"), *Kart->GetName(), CurrentLap, LapTime);
+
+	UWRRaceWorldSubsystem* RaceWorld = UWRRaceWorldSubsystem::GetInstance(this);
+	if (RaceWorld)
+	{
+		RaceWorld->PostEvent(EWRRaceEventType::LapCompleted, Kart, this, CurrentLap, Kart->GetActorLocation());
+	}
 
 	// Check if kart finished the race
 	if (CurrentLap >= TotalLaps)
@@ -93,12 +230,24 @@ void AWRRaceManager::OnKartCompletedLap(AWRKart* Kart)
 		FRaceResult Result;
 		Result.Kart = Kart;
 		Result.Position = ++FinishedKarts;
-		Result.FinishTime = RaceTime;
+		Result.FinishTime = Time;
 		Result.LapsCompleted = CurrentLap;
 
+		if (Timing)
+		{
+			Timing->FinishTime = Time;
+			Timing->FinishPosition = Result.Position;
+			Result.BestLapTime = Timing->BestLapTime;
+		}
+
 		RaceResults.Add(Result);
 		OnKartFinished.Broadcast(Result);
 
+		if (RaceWorld)
+		{
+			RaceWorld->PostEvent(EWRRaceEventType::KartFinished, Kart, this, Result.Position, Kart->GetActorLocation());
+		}
+
 		UE_LOG(LogTemp, Warning, TEXT("Kart %s finished in position %d"), *Kart->GetName(), Result.Position);
 
 		// End race if all karts finished or first place is determined
@@ -183,57 +332,674 @@ int32 AWRRaceManager::GetKartPosition(AWRKart* Kart) const
 	return Kart->GetPosition();
 }
 
+AWRKart* AWRRaceManager::GetKartAtPosition(int32 Position) const
+{
+	const int32 KartIndex = Standings.GetKartIndexAtPosition(Position);
+	return RegisteredKarts.IsValidIndex(KartIndex) ? RegisteredKarts[KartIndex] : nullptr;
+}
+
+void AWRRaceManager::SetTrackSpline(USplineComponent* Spline)
+{
+	TrackProgress.Build(Spline);
+
+	// Cached segments belong to the previous track
+	for (FWRTrackProgressState& State : KartTrackStates)
+	{
+		State = FWRTrackProgressState();
+	}
+}
+
+float AWRRaceManager::GetKartRaceProgress(AWRKart* Kart) const
+{
+	const int32 KartIndex = RegisteredKarts.IndexOfByKey(Kart);
+	return KartRaceProgress.IsValidIndex(KartIndex) ? KartRaceProgress[KartIndex] : 0.0f;
+}
+
+FWRKartLapTiming AWRRaceManager::GetKartLapTiming(AWRKart* Kart) const
+{
+	const FWRKartLapTiming* Timing = FindKartLapTiming(Kart);
+	return Timing ? *Timing : FWRKartLapTiming();
+}
+
+float AWRRaceManager::GetKartCurrentLapTime(AWRKart* Kart) const
+{
+	const FWRKartLapTiming* Timing = FindKartLapTiming(Kart);
+	if (!Timing)
+	{
+		return 0.0f;
+	}
+	return Timing->HasFinished() ? Timing->LastLapTime : RaceTime - Timing->LapStartTime;
+}
+
+const FWRKartLapTiming* AWRRaceManager::FindKartLapTiming(const AWRKart* Kart) const
+{
+	const int32 KartIndex = RegisteredKarts.IndexOfByKey(Kart);
+	return KartLapTimings.IsValidIndex(KartIndex) ? &KartLapTimings[KartIndex] : nullptr;
+}
+
+float AWRRaceManager::GetKartTrackDistance(const AWRKart* Kart) const
+{
+	const int32 KartIndex = RegisteredKarts.IndexOfByKey(Kart);
+	if (!TrackProgress.IsValid() || !KartTrackStates.IsValidIndex(KartIndex) || KartTrackStates[KartIndex].SegmentIndex == INDEX_NONE)
+	{
+		return -1.0f;
+	}
+	return KartTrackStates[KartIndex].Distance;
+}
+
+void AWRRaceManager::GetTrafficSnapshot(TArray<float>& OutDistances, TArray<float>& OutLateralOffsets, TArray<float>& OutSpeeds) const
+{
+	const int32 NumKarts = RegisteredKarts.Num();
+	OutDistances.SetNumUninitialized(NumKarts, EAllowShrinking::No);
+	OutLateralOffsets.SetNumUninitialized(NumKarts, EAllowShrinking::No);
+	OutSpeeds.SetNumUninitialized(NumKarts, EAllowShrinking::No);
+
+	for (int32 i = 0; i < NumKarts; i++)
+	{
+		OutDistances[i] = -1.0f;
+		OutLateralOffsets[i] = 0.0f;
+		OutSpeeds[i] = 0.0f;
+		if (!TrackProgress.IsValid() || KartTrackStates[i].SegmentIndex == INDEX_NONE || (StepRecoveryFlags[i] & FWRKartRecovery::KartIgnored))
+		{
+			continue;
+		}
+
+		FVector Centre, Direction;
+		TrackProgress.GetPointAtDistance(KartTrackStates[i].Distance, Centre, Direction);
+		const FVector Right = FVector::CrossProduct(FVector::UpVector, Direction).GetSafeNormal();
+
+		OutDistances[i] = KartTrackStates[i].Distance;
+		OutLateralOffsets[i] = FVector::DotProduct(StepLocations[i] - Centre, Right);
+		OutSpeeds[i] = FVector::DotProduct(StepVelocities[i], Direction);
+	}
+}
+
+bool AWRRaceManager::IsKartWrongWay(AWRKart* Kart) const
+{
+	return KartRecovery.IsWrongWay(RegisteredKarts.IndexOfByKey(Kart));
+}
+
+bool AWRRaceManager::IsKartOffTrack(AWRKart* Kart) const
+{
+	return KartRecovery.IsOffTrack(RegisteredKarts.IndexOfByKey(Kart));
+}
+
+void AWRRaceManager::BuildTrackProgress()
+{
+	// Done once per race, so a world scan is acceptable here
+	for (TActorIterator<AWRTrackVariations> ActorItr(GetWorld()); ActorItr; ++ActorItr)
+	{
+		if (USplineComponent* Spline = ActorItr->GetTrackSpline())
+		{
+			SetTrackSpline(Spline);
+			return;
+		}
+	}
+
+	UE_LOG(LogWastelandRacers, Warning, TEXT("No track spline found - race positions will only use lap counts"));
+}
+
+void AWRRaceManager::BuildRouteGraph()
+{
+	// Once per race, after the track variation has placed its shortcuts
+	ShortcutSystem = nullptr;
+	for (TActorIterator<AWRShortcutSystem> ActorItr(GetWorld()); ActorItr; ++ActorItr)
+	{
+		ShortcutSystem = *ActorItr;
+		break;
+	}
+
+	RouteGraph.Build(TrackProgress, RacingLine, ShortcutSystem ? ShortcutSystem->GetShortcuts() : TArrayView<const FShortcutData>());
+}
+
 void AWRRaceManager::UpdateRaceState(ERaceState NewState)
 {
 	if (CurrentRaceState != NewState)
 	{
 		CurrentRaceState = NewState;
+
+		UWRReplaySubsystem* Replay = UWRReplaySubsystem::GetInstance(this);
+		if (NewState == ERaceState::Racing)
+		{
+			ResetLapTimings();
+			StartTelemetry();
+			if (Replay)
+			{
+				Replay->StartRecording(RegisteredKarts);
+			}
+			StartTimeTrial();
+		}
+		else if (NewState == ERaceState::Finished)
+		{
+			Telemetry.Stop();
+			if (Replay)
+			{
+				Replay->StopRecording();
+			}
+			if (UWRGhostSubsystem* Ghosts = UWRGhostSubsystem::GetInstance(this))
+			{
+				Ghosts->StopTimeTrial();
+			}
+		}
+
 		OnRaceStateChanged.Broadcast(NewState);
 	}
 }
 
 void AWRRaceManager::UpdateKartPositions()
 {
-	// Sort karts by race progress
-	TArray<TPair<AWRKart*, float>> KartProgress;
+	for (int32 i = 0; i < RegisteredKarts.Num(); i++)
+	{
+		CalculateKartProgress(i);
+	}
 
-	for (AWRKart* Kart : RegisteredKarts)
+	Standings.Update(KartRaceProgress);
+
+	// Write back and notify only where something changed
+	for (const int32 KartIndex : Standings.GetMovedKarts())
 	{
-		if (Kart)
+		AWRKart* Kart = RegisteredKarts[KartIndex];
+		const int32 NewPosition = Standings.GetPosition(KartIndex);
+		if (Kart && Kart->GetPosition() != NewPosition)
 		{
-			float Progress;
-			CalculateKartProgress(Kart, Progress);
-			KartProgress.Add(TPair<AWRKart*, float>(Kart, Progress));
+			const int32 OldPosition = Kart->GetPosition();
+			Kart->SetRacePosition(NewPosition);
+			OnPositionChanged.Broadcast(Kart, OldPosition, NewPosition);
 		}
 	}
+}
 
-	// Sort by progress (highest first)
-	KartProgress.Sort([](const TPair<AWRKart*, float>& A, const TPair<AWRKart*, float>& B) {
-		return A.Value > B.Value;
+void AWRRaceManager::CalculateKartProgress(int32 KartIndex)
+{
+	AWRKart* Kart = RegisteredKarts[KartIndex];
+	if (!Kart)
+	{
+		// Unloaded karts drop to the back of the standings
+		KartRaceProgress[KartIndex] = -1.0f;
+		return;
+	}
+
+	// Finished karts are held ahead of everyone still racing, in finish order
+	if (KartLapTimings[KartIndex].HasFinished())
+	{
+		KartRaceProgress[KartIndex] = (float)(TotalLaps + 1) + 1.0f / (float)KartLapTimings[KartIndex].FinishPosition;
+		return;
+	}
+
+	// Without a centre-line fall back to whole laps
+	if (!TrackProgress.IsValid())
+	{
+		KartRaceProgress[KartIndex] = (float)Kart->GetCurrentLap();
+		return;
+	}
+
+	float Distance = TrackProgress.ProjectPoint(Kart->GetActorLocation(), KartTrackStates[KartIndex]);
+
+	// On a closed loop the grid sits near the end of the lap, behind the start line. Before the first
+	// lap and its first gate that stretch counts as negative, so crossing the line moves a kart forward.
+	const bool bStartingLap = Kart->GetCurrentLap() == 0 && (!KartPassedGates.IsValidIndex(KartIndex) || KartPassedGates[KartIndex] == 0);
+	if (bStartingLap && TrackProgress.IsClosedLoop() && Distance > TrackProgress.GetLapLength() * 0.5f)
+	{
+		Distance -= TrackProgress.GetLapLength();
+	}
+	KartRaceProgress[KartIndex] = TrackProgress.CalculateProgress(Kart->GetCurrentLap(), Distance);
+}
+
+void AWRRaceManager::ResetLapTimings()
+{
+	for (FWRKartLapTiming& Timing : KartLapTimings)
+	{
+		Timing.Reset(RaceTime);
+	}
+
+	BuildCheckpointGates();
+	KartRecovery.ResetKarts(RegisteredKarts.Num());
+
+	// Nothing is swept across the start
+	RestartStepSampling();
+}
+
+void AWRRaceManager::RestartStepSampling()
+{
+	StepSampleFrame = MAX_uint64;
+	SampleStepLocations();
+	PreviousStepLocations = StepLocations;
+	PreviousStepSampleTime = StepSampleTime;
+}
+
+void AWRRaceManager::SetSuspended(bool bInSuspended)
+{
+	if (bSuspended == bInSuspended)
+	{
+		return;
+	}
+
+	bSuspended = bInSuspended;
+
+	// Playback left the karts wherever the replay ended
+	if (!bSuspended && CurrentRaceState == ERaceState::Racing)
+	{
+		RestartStepSampling();
+	}
+}
+
+bool AWRRaceManager::SampleStepLocations()
+{
+	if (StepSampleFrame == GFrameCounter)
+	{
+		return false;
+	}
+	StepSampleFrame = GFrameCounter;
+
+	Swap(PreviousStepLocations, StepLocations);
+	PreviousStepSampleTime = StepSampleTime;
+	StepSampleTime = RaceTime;
+	for (int32 i = 0; i < RegisteredKarts.Num(); i++)
+	{
+		if (const AWRKart* Kart = RegisteredKarts[i])
+		{
+			StepLocations[i] = Kart->GetActorLocation();
+			StepVelocities[i] = Kart->GetVelocity();
+			StepRecoveryFlags[i] = KartLapTimings[i].HasFinished() ? FWRKartRecovery::KartIgnored
+				: Kart->IsDestroyed() ? FWRKartRecovery::KartDestroyed : 0;
+		}
+		else
+		{
+			StepLocations[i] = PreviousStepLocations[i];
+			StepVelocities[i] = FVector::ZeroVector;
+			StepRecoveryFlags[i] = FWRKartRecovery::KartIgnored;
+		}
+	}
+	return true;
+}
+
+void AWRRaceManager::BuildCheckpointGates()
+{
+	CheckpointGates.Reset();
+	GateCheckpoints.Reset();
+
+	// The registry keeps checkpoints sorted by index, which is race order
+	if (UWRRaceWorldSubsystem* RaceWorld = UWRRaceWorldSubsystem::GetInstance(this))
+	{
+		for (AWRTrackCheckpoint* Checkpoint : RaceWorld->GetCheckpoints())
+		{
+			if (CheckpointGates.Num() == FWRCheckpointGates::MaxGates)
+			{
+				UE_LOG(LogWastelandRacers, Error, TEXT("More than %d checkpoints registered - %s and later are ignored"), FWRCheckpointGates::MaxGates, *Checkpoint->GetName());
+				break;
+			}
+
+			FVector Origin, Normal, Up;
+			FVector2f HalfExtents;
+			Checkpoint->GetGate(Origin, Normal, Up, HalfExtents);
+			CheckpointGates.AddGate(Origin, Normal, Up, HalfExtents, Checkpoint->GetCheckpointIndex(), Checkpoint->IsFinishLine());
+			GateCheckpoints.Add(Checkpoint);
+		}
+	}
+
+	CheckpointGates.FinalizeGates();
+	CheckpointGates.ResetKarts(RegisteredKarts.Num());
+
+	// Where each gate sits along the lap, so karts that miss gates can be put back in step
+	TArray<float> GateDistances;
+	if (TrackProgress.IsValid())
+	{
+		for (int32 Gate = 0; Gate < CheckpointGates.Num(); Gate++)
+		{
+			FWRTrackProgressState GateState;
+			GateDistances.Add(TrackProgress.ProjectPoint(CheckpointGates.GetOrigin(Gate), GateState));
+		}
+		CheckpointGates.SetTrackDistances(GateDistances);
+	}
+	AssignShortcutCheckpoints(GateDistances);
+
+	// The finish line closes a lap rather than being required within it
+	RequiredGates = 0;
+	for (int32 Gate = 0; Gate < CheckpointGates.Num(); Gate++)
+	{
+		if (!CheckpointGates.IsFinishLine(Gate))
+		{
+			RequiredGates |= FWRCheckpointGates::GetGateBit(Gate);
+		}
+	}
+
+	KartPassedGates.Reset();
+	KartPassedGates.AddZeroed(RegisteredKarts.Num());
+	KartBypassedGates.Reset();
+	KartBypassedGates.AddZeroed(RegisteredKarts.Num());
+
+	if (!CheckpointGates.IsValid())
+	{
+		UE_LOG(LogWastelandRacers, Warning, TEXT("No checkpoints registered - laps will not be counted"));
+	}
+}
+
+void AWRRaceManager::AssignShortcutCheckpoints(TArrayView<const float> GateDistances)
+{
+	if (!ShortcutSystem || CheckpointGates.Num() == 0)
+	{
+		return;
+	}
+
+	const TArrayView<const FShortcutData> Shortcuts = ShortcutSystem->GetShortcuts();
+	for (int32 ShortcutIndex = 0; ShortcutIndex < Shortcuts.Num(); ShortcutIndex++)
+	{
+		const FShortcutData& Shortcut = Shortcuts[ShortcutIndex];
+		if (Shortcut.BypassedCheckpoints.Num() == 0 && GateDistances.Num() == CheckpointGates.Num())
+		{
+			// Stock shortcuts only know their entry and exit, not the level's checkpoints
+			FWRTrackProgressState EntryState, ExitState;
+			const float LapLength = TrackProgress.GetLapLength();
+			const float EntryDistance = TrackProgress.ProjectPoint(Shortcut.EntryPoint, EntryState);
+			float Span = TrackProgress.ProjectPoint(Shortcut.ExitPoint, ExitState) - EntryDistance;
+			if (TrackProgress.IsClosedLoop() && Span < 0.0f)
+			{
+				Span += LapLength;
+			}
+
+			// Anything longer than half a lap is a shortcut running backwards or a bad projection
+			TArray<int32> Bypassed;
+			if (Span > 0.0f && Span < LapLength * 0.5f)
+			{
+				for (int32 Gate = 0; Gate < CheckpointGates.Num(); Gate++)
+				{
+					float Ahead = GateDistances[Gate] - EntryDistance;
+					if (TrackProgress.IsClosedLoop() && Ahead < 0.0f)
+					{
+						Ahead += LapLength;
+					}
+					if (!CheckpointGates.IsFinishLine(Gate) && Ahead > 0.0f && Ahead < Span)
+					{
+						Bypassed.Add(GateCheckpoints[Gate]->GetCheckpointIndex());
+					}
+				}
+			}
+			ShortcutSystem->SetBypassedCheckpoints(ShortcutIndex, MoveTemp(Bypassed));
+		}
+
+		if (Shortcut.BypassedCheckpoints.Num() == 0)
+		{
+			UE_LOG(LogWastelandRacers, Warning, TEXT("Shortcut %s bypasses no checkpoints - laps through it must still pass every gate"), *Shortcut.ShortcutName);
+		}
+	}
+}
+
+void AWRRaceManager::SweepCheckpointGates()
+{
+	// Lap validation is the server's call; a non-replicated manager always has authority
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	StepCrossings.Reset();
+	CheckpointGates.Sweep(PreviousStepLocations, StepLocations, StepCrossings);
+
+	// Applied in crossing order so karts finishing within the same step are ranked by interpolated time
+	StepCrossings.Sort([](const FWRGateCrossing& A, const FWRGateCrossing& B)
+	{
+		return A.Alpha < B.Alpha;
 	});
 
-	// Update positions
-	for (int32 i = 0; i < KartProgress.Num(); i++)
+	UWRRaceWorldSubsystem* RaceWorld = UWRRaceWorldSubsystem::GetInstance(this);
+	for (const FWRGateCrossing& Crossing : StepCrossings)
 	{
-		if (KartProgress[i].Key)
+		AWRKart* Kart = RegisteredKarts[Crossing.KartIndex];
+		const float CrossingTime = FMath::Lerp(PreviousStepSampleTime, StepSampleTime, Crossing.Alpha);
+
+		if (CheckpointGates.IsFinishLine(Crossing.GateIndex))
+		{
+			ApplyFinishLineCrossing(Crossing.KartIndex, CrossingTime);
+		}
+		else
+		{
+			KartPassedGates[Crossing.KartIndex] |= FWRCheckpointGates::GetGateBit(Crossing.GateIndex);
+			OnKartPassedCheckpoint(Kart, CheckpointGates.GetCheckpointIndex(Crossing.GateIndex), CrossingTime);
+		}
+
+		// Gates a shortcut has already credited are not waited for
+		CheckpointGates.SkipGates(Crossing.KartIndex, KartBypassedGates[Crossing.KartIndex] & ~KartPassedGates[Crossing.KartIndex]);
+
+		if (RaceWorld)
 		{
-			// Set position on kart (this would need to be implemented in AWRKart)
-			// KartProgress[i].Key->SetRacePosition(i + 1);
+			RaceWorld->PostEvent(EWRRaceEventType::CheckpointCrossed, Kart, GateCheckpoints[Crossing.GateIndex],
+				CheckpointGates.GetCheckpointIndex(Crossing.GateIndex), StepLocations[Crossing.KartIndex]);
 		}
 	}
 }
 
-void AWRRaceManager::CalculateKartProgress(AWRKart* Kart, float& Progress) const
+void AWRRaceManager::ResyncMissedGates()
 {
-	if (!Kart)
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	// Past MaxMissedGates the sweep never matches the expected gate again, and the kart's laps stop counting
+	for (int32 i = 0; i < RegisteredKarts.Num(); i++)
+	{
+		if (!RegisteredKarts[i] || KartLapTimings[i].HasFinished())
+		{
+			continue;
+		}
+
+		const float Distance = KartTrackStates[i].Distance;
+		const int32 MissedGates = CheckpointGates.GetMissedGates(i, Distance);
+		if (MissedGates >= FWRCheckpointGates::MaxMissedGates)
+		{
+			UE_LOG(LogWastelandRacers, Log, TEXT("Kart %s missed %d gates in a row - resyncing to its track position"),
+				*RegisteredKarts[i]->GetName(), MissedGates);
+			CheckpointGates.ResyncKart(i, Distance);
+		}
+	}
+}
+
+void AWRRaceManager::RecoverKarts(float DeltaTime)
+{
+	// Respawning moves karts, so only the authority decides
+	if (!TrackProgress.IsValid() || !HasAuthority())
+	{
+		return;
+	}
+
+	StepRespawns.Reset();
+	KartRecovery.Evaluate(TrackProgress, KartTrackStates, StepLocations, StepVelocities, StepRecoveryFlags, DeltaTime, RecoverySettings, StepRespawns);
+
+	UWRRaceWorldSubsystem* RaceWorld = UWRRaceWorldSubsystem::GetInstance(this);
+	UWRAudioManager* AudioManager = RespawnSound ? UWRAudioManager::GetInstance(this) : nullptr;
+	for (const FWRKartRespawn& Respawn : StepRespawns)
+	{
+		AWRKart* Kart = RegisteredKarts[Respawn.KartIndex];
+		Kart->Respawn(Respawn.Location, Respawn.Rotation);
+		KartRecovery.ResetKart(Respawn.KartIndex);
+
+		// The next gate sweep starts from the respawn point so the teleport cannot cross a checkpoint,
+		// and looks for the first gate ahead of it, which may not be the one the kart was expecting
+		StepLocations[Respawn.KartIndex] = Respawn.Location;
+		KartTrackStates[Respawn.KartIndex] = FWRTrackProgressState();
+		CheckpointGates.ResyncKart(Respawn.KartIndex, TrackProgress.ProjectPoint(Respawn.Location, KartTrackStates[Respawn.KartIndex]));
+
+		if (RespawnEffect)
+		{
+			UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), RespawnEffect, Respawn.Location, Respawn.Rotation,
+				FVector::OneVector, true, true, ENCPoolMethod::AutoRelease);
+		}
+
+		if (AudioManager)
+		{
+			AudioManager->PlaySoundEffect(RespawnSound, Respawn.Location);
+		}
+
+		if (RaceWorld)
+		{
+			RaceWorld->PostEvent(EWRRaceEventType::KartRespawned, Kart, this, (int32)Respawn.Reason, Respawn.Location);
+		}
+	}
+}
+
+void AWRRaceManager::UpdateRubberBanding(float DeltaTime)
+{
+	// Torque is physics state, so like respawns only the authority decides
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	// Finished karts neither lead nor get banded
+	for (int32 i = 0; i < RegisteredKarts.Num(); i++)
+	{
+		const AWRKart* Kart = RegisteredKarts[i];
+		const AWRAIController* Bot = Kart ? Cast<AWRAIController>(Kart->GetController()) : nullptr;
+
+		uint8 Flags = 0;
+		if (Kart && !KartLapTimings[i].HasFinished())
+		{
+			Flags |= Kart->IsPlayerControlled() ? FWRRubberBanding::KartHuman : 0;
+			Flags |= Bot && Bot->IsRubberBandingEnabled() ? FWRRubberBanding::KartBanded : 0;
+		}
+		StepRubberBandFlags[i] = Flags;
+		StepDifficulties[i] = Bot ? Bot->GetDifficulty() : 0.0f;
+	}
+
+	FWRRubberBanding::Update(RubberBandSettings, KartRaceProgress, StepRubberBandFlags, StepDifficulties, TrackProgress.GetLapLength(), DeltaTime, KartTorqueScales);
+
+	for (int32 i = 0; i < RegisteredKarts.Num(); i++)
+	{
+		if (AWRKart* Kart = RegisteredKarts[i])
+		{
+			Kart->SetEngineTorqueScale(KartTorqueScales[i]);
+		}
+	}
+}
+
+void AWRRaceManager::ApplyFinishLineCrossing(int32 KartIndex, float CrossingTime)
+{
+	AWRKart* Kart = RegisteredKarts[KartIndex];
+	const uint64 PassedGates = KartPassedGates[KartIndex];
+	const uint64 MissingGates = RequiredGates & ~(PassedGates | KartBypassedGates[KartIndex]);
+
+	if (MissingGates == 0)
+	{
+		KartPassedGates[KartIndex] = 0;
+		KartBypassedGates[KartIndex] = 0;
+		OnKartCompletedLap(Kart, CrossingTime);
+		return;
+	}
+
+	// Rolling over the line from the grid starts the first lap rather than completing one
+	if (PassedGates == 0 && Kart && Kart->GetCurrentLap() == 0)
+	{
+		KartLapTimings[KartIndex].Reset(CrossingTime);
+		return;
+	}
+
+	// The masks are kept, so the kart has to go round again and pass what it missed
+	UE_LOG(LogWastelandRacers, Log, TEXT("Kart %s crossed the finish line having missed %d checkpoints - lap not counted"), *GetNameSafe(Kart), FMath::CountBits(MissingGates));
+	if (UWRRaceWorldSubsystem* RaceWorld = UWRRaceWorldSubsystem::GetInstance(this))
+	{
+		RaceWorld->PostEvent(EWRRaceEventType::LapRejected, Kart, this, FMath::CountBits(MissingGates), StepLocations[KartIndex]);
+	}
+}
+
+void AWRRaceManager::CreditShortcut(int32 KartIndex, const FShortcutData& Shortcut)
+{
+	const uint64 BypassedGates = CheckpointGates.GetCheckpointMask(Shortcut.BypassedCheckpoints) & RequiredGates;
+	KartBypassedGates[KartIndex] |= BypassedGates;
+	CheckpointGates.SkipGates(KartIndex, BypassedGates & ~KartPassedGates[KartIndex]);
+}
+
+void AWRRaceManager::HandleRaceEvents(TArrayView<const FWRRaceEvent> Events)
+{
+	if (CurrentRaceState != ERaceState::Racing || !HasAuthority())
 	{
-		Progress = 0.0f;
 		return;
 	}
 
-	// Calculate progress based on laps completed and current position
-	// This is a simplified calculation - in a real implementation,
-	// you'd use checkpoint system and track distance
-	float LapProgress = (float)Kart->GetCurrentLap() / (float)TotalLaps;
-	Progress = LapProgress * 100.0f;
+	for (const FWRRaceEvent& Event : Events)
+	{
+		if (Event.Type != EWRRaceEventType::ShortcutUsed)
+		{
+			continue;
+		}
+
+		const AWRShortcutSystem* EventShortcuts = Cast<AWRShortcutSystem>(Event.Source.Get());
+		const FShortcutData* Shortcut = EventShortcuts ? EventShortcuts->GetShortcut(Event.Payload) : nullptr;
+		const int32 KartIndex = RegisteredKarts.IndexOfByKey(Event.Kart.Get());
+		if (Shortcut && KartBypassedGates.IsValidIndex(KartIndex))
+		{
+			CreditShortcut(KartIndex, *Shortcut);
+		}
+	}
+}
+
+void AWRRaceManager::StartTelemetry()
+{
+	if (!bRecordTelemetry && CVarRecordTelemetry.GetValueOnGameThread() == 0)
+	{
+		return;
+	}
+
+	TArray<FString> KartNames;
+	for (const AWRKart* Kart : RegisteredKarts)
+	{
+		KartNames.Add(Kart ? Kart->GetName() : TEXT("None"));
+	}
+
+	const FString Path = FPaths::ProjectSavedDir() / TEXT("Telemetry") / FString::Printf(TEXT("Race_%s.wrtl"), *FDateTime::Now().ToString());
+	if (Telemetry.Start(Path, KartNames, TelemetrySampleRate))
+	{
+		TelemetrySamples.SetNum(KartNames.Num());
+	}
+}
+
+void AWRRaceManager::RecordTelemetry(float DeltaTime)
+{
+	if (!Telemetry.IsRecording() || !Telemetry.ShouldSample(DeltaTime))
+	{
+		return;
+	}
+
+	// Karts registered after the race started are not part of the file
+	const int32 NumKarts = FMath::Min(TelemetrySamples.Num(), RegisteredKarts.Num());
+	for (int32 i = 0; i < NumKarts; i++)
+	{
+		const AWRKart* Kart = RegisteredKarts[i];
+		FWRTelemetrySample& Sample = TelemetrySamples[i];
+		if (!Kart)
+		{
+			Sample = FWRTelemetrySample();
+			continue;
+		}
+
+		Sample.Location = FVector3f(Kart->GetActorLocation());
+		Sample.Velocity = FVector3f(Kart->GetVelocity());
+		Sample.Throttle = Kart->GetThrottleInput();
+		Sample.Steering = Kart->GetSteeringInput();
+		Sample.BoostEnergy = Kart->CurrentBoostEnergy;
+		Sample.Health = Kart->CurrentHealth;
+		Sample.Lap = Kart->GetCurrentLap();
+		Sample.Progress = KartRaceProgress[i];
+	}
+
+	Telemetry.RecordFrame(RaceTime, TelemetrySamples);
+}
+
+void AWRRaceManager::StartTimeTrial()
+{
+	UWRGameInstance* GameInstance = Cast<UWRGameInstance>(GetGameInstance());
+	UWRGhostSubsystem* Ghosts = UWRGhostSubsystem::GetInstance(this);
+	if (!GameInstance || !Ghosts || GameInstance->GetCurrentGameMode() != EGameMode::TimeTrial)
+	{
+		return;
+	}
+
+	for (AWRKart* Kart : RegisteredKarts)
+	{
+		if (Kart && Kart->IsPlayerControlled())
+		{
+			// Each track has its own level, so the level name identifies the ghost set
+			Ghosts->StartTimeTrial(this, Kart, FName(UGameplayStatics::GetCurrentLevelName(this)));
+			return;
+		}
+	}
 }
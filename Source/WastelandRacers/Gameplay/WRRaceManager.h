@@ -3,6 +3,15 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "WastelandRacers/Story/WRStoryManager.h"
+#include "WastelandRacers/Gameplay/WRTrackProgress.h"
+#include "WastelandRacers/Gameplay/WRRaceStandings.h"
+#include "WastelandRacers/Gameplay/WRRaceTiming.h"
+#include "WastelandRacers/Gameplay/WRCheckpointGates.h"
+#include "WastelandRacers/Gameplay/WRKartRecovery.h"
+#include "WastelandRacers/Gameplay/WRRubberBanding.h"
+#include "WastelandRacers/Gameplay/WRRaceWorldSubsystem.h"
+#include "WastelandRacers/Telemetry/WRTelemetryRecorder.h"
+#include "WastelandRacers/AI/WRRouteGraph.h"
 #include "WRRaceManager.generated.h"
 
 UENUM(BlueprintType)
@@ -30,10 +39,14 @@ struct FRaceResult
 
 	UPROPERTY(BlueprintReadWrite)
 	int32 LapsCompleted;
+
+	UPROPERTY(BlueprintReadWrite)
+	float BestLapTime = -1.0f;
 };
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnRaceStateChanged, ERaceState, NewState);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnKartFinished, const FRaceResult&, Result);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnPositionChanged, class AWRKart*, Kart, int32, OldPosition, int32, NewPosition);
 
 UCLASS()
 class WASTELANDRACERS_API AWRRaceManager : public AActor
@@ -44,8 +57,16 @@ public:
 	AWRRaceManager();
 
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void Tick(float DeltaTime) override;
 
+	// Countdown, race time and standings, run by UWRGameplayClock in the Race phase
+	void FixedStep(float FixedDeltaTime);
+
+	// Held while a replay poses the karts, so the race clock, gates, recovery and rubber-banding stop
+	void SetSuspended(bool bInSuspended);
+	bool IsSuspended() const { return bSuspended; }
+
 	UFUNCTION(BlueprintCallable, Category = "Race")
 	void Initialize(int32 TotalLaps, int32 MaxPlayers);
 
@@ -58,11 +79,12 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Race")
 	void RegisterKart(class AWRKart* Kart);
 
+	// A negative CrossingTime uses the current race time
 	UFUNCTION(BlueprintCallable, Category = "Race")
-	void OnKartPassedCheckpoint(class AWRKart* Kart, int32 CheckpointIndex);
+	void OnKartPassedCheckpoint(class AWRKart* Kart, int32 CheckpointIndex, float CrossingTime = -1.0f);
 
 	UFUNCTION(BlueprintCallable, Category = "Race")
-	void OnKartCompletedLap(class AWRKart* Kart);
+	void OnKartCompletedLap(class AWRKart* Kart, float CrossingTime = -1.0f);
 
 	UFUNCTION(BlueprintPure, Category = "Race")
 	ERaceState GetRaceState() const { return CurrentRaceState; }
@@ -73,6 +95,58 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Race")
 	int32 GetKartPosition(class AWRKart* Kart) const;
 
+	UFUNCTION(BlueprintCallable, Category = "Race")
+	void SetTrackSpline(class USplineComponent* Spline);
+
+	// Completed laps plus the fraction of the current lap, measured along the track centre-line
+	UFUNCTION(BlueprintPure, Category = "Race")
+	float GetKartRaceProgress(class AWRKart* Kart) const;
+
+	UFUNCTION(BlueprintPure, Category = "Race")
+	float GetTrackLength() const { return TrackProgress.GetLapLength(); }
+
+	const FWRTrackProgress& GetTrackProgress() const { return TrackProgress; }
+
+	// Distance along the centre-line from the last race step, or -1 if the kart is not being tracked
+	float GetKartTrackDistance(const class AWRKart* Kart) const;
+
+	// Slot in the race step arrays and traffic snapshot, or INDEX_NONE for an unregistered kart
+	int32 GetKartIndex(const class AWRKart* Kart) const { return RegisteredKarts.IndexOfByKey(Kart); }
+
+	// Every registered kart at the last race step: centre-line distance, offset to the right of the
+	// centre-line and speed along it. Karts not being tracked get a distance of -1.
+	void GetTrafficSnapshot(TArray<float>& OutDistances, TArray<float>& OutLateralOffsets, TArray<float>& OutSpeeds) const;
+
+	UFUNCTION(BlueprintPure, Category = "AI")
+	class UWRRacingLineData* GetRacingLine() const { return RacingLine; }
+
+	// Centre-line and shortcuts as compiled at race start, for AI branch choice
+	const FWRRouteGraph& GetRouteGraph() const { return RouteGraph; }
+	class AWRShortcutSystem* GetShortcutSystem() const { return ShortcutSystem; }
+
+	UFUNCTION(BlueprintPure, Category = "Race")
+	class AWRKart* GetKartAtPosition(int32 Position) const;
+
+	UFUNCTION(BlueprintPure, Category = "Race")
+	int32 GetNumRacers() const { return Standings.Num(); }
+
+	UFUNCTION(BlueprintPure, Category = "Race")
+	int32 GetTotalLaps() const { return TotalLaps; }
+
+	UFUNCTION(BlueprintPure, Category = "Timing")
+	FWRKartLapTiming GetKartLapTiming(class AWRKart* Kart) const;
+
+	UFUNCTION(BlueprintPure, Category = "Timing")
+	float GetKartCurrentLapTime(class AWRKart* Kart) const;
+
+	const FWRKartLapTiming* FindKartLapTiming(const class AWRKart* Kart) const;
+
+	UFUNCTION(BlueprintPure, Category = "Recovery")
+	bool IsKartWrongWay(class AWRKart* Kart) const;
+
+	UFUNCTION(BlueprintPure, Category = "Recovery")
+	bool IsKartOffTrack(class AWRKart* Kart) const;
+
 	UFUNCTION(BlueprintCallable, Category = "Race")
 	void OnRaceCompleted();
 
@@ -85,6 +159,10 @@ public:
 	UPROPERTY(BlueprintAssignable)
 	FOnKartFinished OnKartFinished;
 
+	// Fired from the standings update only for karts whose position actually changed
+	UPROPERTY(BlueprintAssignable)
+	FOnPositionChanged OnPositionChanged;
+
 protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Race")
 	int32 TotalLaps = 3;
@@ -107,12 +185,109 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rewards")
 	TArray<int32> PositionRewards = {1000, 750, 500, 300, 200};
 
+	// Also enabled for every race by wr.Telemetry 1
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Telemetry")
+	bool bRecordTelemetry = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Telemetry", meta = (ClampMin = "1.0"))
+	float TelemetrySampleRate = 60.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Recovery")
+	FWRKartRecoverySettings RecoverySettings;
+
+	// Bots are scaled by their race distance to the leading human; per bot opt-out on AWRAIController
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	FWRRubberBandSettings RubberBandSettings;
+
+	// Baked by the WRRacingLineBake commandlet for this track; AI drives the centre-line without it
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	class UWRRacingLineData* RacingLine = nullptr;
+
+	// Spawned from the Niagara component pool
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Recovery")
+	class UNiagaraSystem* RespawnEffect = nullptr;
+
+	// Played through UWRAudioManager's audio component pool
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Recovery")
+	class USoundBase* RespawnSound = nullptr;
+
 private:
 	float RaceTime = 0.0f;
 	float CountdownTimer = 0.0f;
 	int32 FinishedKarts = 0;
+	bool bSuspended = false;
+	FDelegateHandle FixedStepHandle;
+
+	FWRTrackProgress TrackProgress;
+
+	// Indexed in parallel with RegisteredKarts
+	TArray<FWRTrackProgressState> KartTrackStates;
+	TArray<float> KartRaceProgress;
+	TArray<FWRKartLapTiming> KartLapTimings;
+
+	// Kart locations at the previous and current sample, swept against the checkpoint gates. Karts
+	// are sampled once per frame, stamped with the race time as the frame's first step begins.
+	TArray<FVector> PreviousStepLocations;
+	TArray<FVector> StepLocations;
+	float PreviousStepSampleTime = 0.0f;
+	float StepSampleTime = 0.0f;
+	uint64 StepSampleFrame = 0;
+	TArray<FVector> StepVelocities;
+	TArray<uint8> StepRecoveryFlags;
+
+	FWRKartRecovery KartRecovery;
+	TArray<FWRKartRespawn> StepRespawns;
+
+	TArray<uint8> StepRubberBandFlags;
+	TArray<float> StepDifficulties;
+	TArray<float> KartTorqueScales;
+
+	FWRCheckpointGates CheckpointGates;
+	TArray<FWRGateCrossing> StepCrossings;
+
+	// One bit per gate, indexed in parallel with RegisteredKarts. A lap only counts once every
+	// required gate has been passed this lap or skipped by a shortcut the kart actually took.
+	TArray<uint64> KartPassedGates;
+	TArray<uint64> KartBypassedGates;
+	uint64 RequiredGates = 0;
+
+	FDelegateHandle RaceEventsHandle;
+
+	// Checkpoint actor for each gate, for effects when a kart passes
+	UPROPERTY()
+	TArray<class AWRTrackCheckpoint*> GateCheckpoints;
+
+	FWRRaceStandings Standings;
+
+	UPROPERTY()
+	class AWRShortcutSystem* ShortcutSystem = nullptr;
+
+	FWRRouteGraph RouteGraph;
+
+	FWRTelemetryRecorder Telemetry;
+	TArray<FWRTelemetrySample> TelemetrySamples;
 
 	void UpdateRaceState(ERaceState NewState);
 	void UpdateKartPositions();
-	void CalculateKartProgress(class AWRKart* Kart, float& Progress) const;
+	void BuildTrackProgress();
+	void BuildRouteGraph();
+	void CalculateKartProgress(int32 KartIndex);
+	void ResetLapTimings();
+	// False when the karts were already sampled this frame
+	bool SampleStepLocations();
+	// Starts the next sweep from where the karts are now, so a jump between samples crosses nothing
+	void RestartStepSampling();
+	void BuildCheckpointGates();
+	// Shortcuts without authored bypassed checkpoints get the gates between their entry and exit
+	void AssignShortcutCheckpoints(TArrayView<const float> GateDistances);
+	void SweepCheckpointGates();
+	void ResyncMissedGates();
+	void RecoverKarts(float DeltaTime);
+	void UpdateRubberBanding(float DeltaTime);
+	void ApplyFinishLineCrossing(int32 KartIndex, float CrossingTime);
+	void CreditShortcut(int32 KartIndex, const struct FShortcutData& Shortcut);
+	void HandleRaceEvents(TArrayView<const FWRRaceEvent> Events);
+	void StartTelemetry();
+	void StartTimeTrial();
+	void RecordTelemetry(float DeltaTime);
 };
@@ -0,0 +1,132 @@
+#include "WRRaceStandings.h"
+#include "WastelandRacers/WastelandRacers.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Algo/StableSort.h"
+
+void FWRRaceStandings::Reserve(int32 Capacity)
+{
+	Order.Reserve(Capacity);
+	Positions.Reserve(Capacity);
+	MovedKarts.Reserve(Capacity);
+}
+
+void FWRRaceStandings::Reset()
+{
+	Order.Reset();
+	Positions.Reset();
+	MovedKarts.Reset();
+}
+
+void FWRRaceStandings::Add(int32 KartIndex)
+{
+	check(KartIndex == Positions.Num());
+	Order.Add(KartIndex);
+	Positions.Add(Order.Num());
+}
+
+void FWRRaceStandings::Update(TArrayView<const float> Progress)
+{
+	for (int32 i = 1; i < Order.Num(); i++)
+	{
+		const int32 KartIndex = Order[i];
+		const float KartProgress = Progress[KartIndex];
+
+		int32 j = i - 1;
+		while (j >= 0 && Progress[Order[j]] < KartProgress)
+		{
+			Order[j + 1] = Order[j];
+			j--;
+		}
+		Order[j + 1] = KartIndex;
+	}
+
+	MovedKarts.Reset();
+	for (int32 i = 0; i < Order.Num(); i++)
+	{
+		if (Positions[Order[i]] != i + 1)
+		{
+			Positions[Order[i]] = i + 1;
+			MovedKarts.Add(Order[i]);
+		}
+	}
+}
+
+#if !UE_BUILD_SHIPPING
+// Runs the standings update on a simulated pack of karts, verifies the buffers never reallocate, and
+// checks every tick's order and moved karts (the position notifications UpdateKartPositions sends)
+// against a stable sort of the previous order
+static FAutoConsoleCommand BenchStandingsCommand(
+	TEXT("wr.Bench.Standings"),
+	TEXT("Benchmarks FWRRaceStandings updates and checks their order, moved karts and that steady-state ticks do not allocate"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		const int32 NumTicks = 10000;
+
+		for (int32 NumKarts : { 8, 32, 128 })
+		{
+			FRandomStream Random(42);
+			FWRRaceStandings Standings;
+			TArray<float> Progress;
+			TArray<float> Speeds;
+
+			Standings.Reserve(NumKarts);
+			for (int32 k = 0; k < NumKarts; k++)
+			{
+				Standings.Add(k);
+				Progress.Add(0.0f);
+				Speeds.Add(Random.FRandRange(0.9f, 1.1f));
+			}
+
+			const int32* OrderData = Standings.GetOrder().GetData();
+			const int32 OrderMax = Standings.GetOrder().Max();
+			const int32* MovedData = Standings.GetMovedKarts().GetData();
+
+			TArray<int32> ExpectedOrder;
+			TArray<int32> ExpectedMoved;
+			int32 FailedTick = INDEX_NONE;
+			int32 NumMoved = 0;
+
+			uint64 Cycles = 0;
+			for (int32 Tick = 0; Tick < NumTicks; Tick++)
+			{
+				for (int32 k = 0; k < NumKarts; k++)
+				{
+					Progress[k] += Speeds[k] * Random.FRandRange(0.0f, 0.0002f);
+				}
+
+				ExpectedOrder = Standings.GetOrder();
+				Algo::StableSort(ExpectedOrder, [&Progress](int32 A, int32 B) { return Progress[A] > Progress[B]; });
+				ExpectedMoved.Reset();
+				for (int32 i = 0; i < ExpectedOrder.Num(); i++)
+				{
+					if (Standings.GetPosition(ExpectedOrder[i]) != i + 1)
+					{
+						ExpectedMoved.Add(ExpectedOrder[i]);
+					}
+				}
+
+				const uint64 Start = FPlatformTime::Cycles64();
+				Standings.Update(Progress);
+				Cycles += FPlatformTime::Cycles64() - Start;
+
+				NumMoved += Standings.GetMovedKarts().Num();
+				if (FailedTick == INDEX_NONE && (Standings.GetOrder() != ExpectedOrder || Standings.GetMovedKarts() != ExpectedMoved))
+				{
+					FailedTick = Tick;
+				}
+			}
+
+			const bool bAllocated = Standings.GetOrder().GetData() != OrderData || Standings.GetOrder().Max() != OrderMax
+				|| Standings.GetMovedKarts().GetData() != MovedData;
+			const double TotalUs = FPlatformTime::ToMilliseconds64(Cycles) * 1000.0;
+			UE_LOG(LogWastelandRacers, Display, TEXT("Standings: %3d karts, %.3f us per tick, %.2f position changes per tick, allocations: %s"),
+				NumKarts, TotalUs / (double)NumTicks, NumMoved / (double)NumTicks, bAllocated ? TEXT("FAILED") : TEXT("none"));
+			if (FailedTick != INDEX_NONE)
+			{
+				UE_LOG(LogWastelandRacers, Error, TEXT("Standings: %d karts, order or position changes wrong from tick %d"), NumKarts, FailedTick);
+			}
+		}
+	}));
+#endif
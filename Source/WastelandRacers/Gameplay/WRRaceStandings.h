@@ -0,0 +1,39 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Persistent race order kept as indices into the race manager's kart array.
+// Standings change by at most a few swaps per tick, so an insertion pass over
+// the previous order is close to linear and never touches the heap once reserved.
+class WASTELANDRACERS_API FWRRaceStandings
+{
+public:
+	void Reserve(int32 Capacity);
+	void Reset();
+
+	// Kart indices are added in order, starting from 0, and join at the back
+	void Add(int32 KartIndex);
+
+	// Reorders by descending progress; ties keep their previous order. Karts whose position changed
+	// are listed in GetMovedKarts until the next update.
+	void Update(TArrayView<const float> Progress);
+
+	int32 Num() const { return Order.Num(); }
+	int32 GetKartIndexAtPosition(int32 Position) const
+	{
+		return Order.IsValidIndex(Position - 1) ? Order[Position - 1] : INDEX_NONE;
+	}
+
+	// 1-based
+	int32 GetPosition(int32 KartIndex) const { return Positions.IsValidIndex(KartIndex) ? Positions[KartIndex] : 0; }
+
+	const TArray<int32>& GetOrder() const { return Order; }
+	const TArray<int32>& GetMovedKarts() const { return MovedKarts; }
+
+private:
+	TArray<int32> Order;
+
+	// Indexed by kart
+	TArray<int32> Positions;
+	TArray<int32> MovedKarts;
+};
@@ -0,0 +1,49 @@
+#include "WRRaceTiming.h"
+
+void FWRKartLapTiming::Reset(float StartTime)
+{
+	LapStartTime = StartTime;
+	LastSplitTime = StartTime;
+	LastLapTime = -1.0f;
+	BestLapTime = -1.0f;
+	FinishTime = -1.0f;
+	FinishPosition = 0;
+	CurrentSectorTimes.Reset();
+	LastLapSectorTimes.Reset();
+	BestSectorTimes.Reset();
+	SplitSerial = 0;
+}
+
+int32 FWRKartLapTiming::CloseSector(float Time)
+{
+	const int32 Sector = CurrentSectorTimes.Add(Time - LastSplitTime);
+	LastSplitTime = Time;
+
+	if (!BestSectorTimes.IsValidIndex(Sector))
+	{
+		BestSectorTimes.Add(CurrentSectorTimes[Sector]);
+	}
+	else if (CurrentSectorTimes[Sector] < BestSectorTimes[Sector])
+	{
+		BestSectorTimes[Sector] = CurrentSectorTimes[Sector];
+	}
+
+	SplitSerial++;
+	return Sector;
+}
+
+float FWRKartLapTiming::CompleteLap(float Time)
+{
+	CloseSector(Time);
+
+	LastLapTime = Time - LapStartTime;
+	if (BestLapTime < 0.0f || LastLapTime < BestLapTime)
+	{
+		BestLapTime = LastLapTime;
+	}
+
+	Swap(LastLapSectorTimes, CurrentSectorTimes);
+	CurrentSectorTimes.Reset();
+	LapStartTime = Time;
+	return LastLapTime;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WRRaceTiming.generated.h"
+
+// Lap and sector times for one kart. Times are race times in seconds; -1 means not set yet.
+USTRUCT(BlueprintType)
+struct FWRKartLapTiming
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Timing")
+	float LapStartTime = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Timing")
+	float LastLapTime = -1.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Timing")
+	float BestLapTime = -1.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Timing")
+	float FinishTime = -1.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Timing")
+	int32 FinishPosition = 0;
+
+	// Sector times closed so far on the current lap
+	UPROPERTY(BlueprintReadOnly, Category = "Timing")
+	TArray<float> CurrentSectorTimes;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Timing")
+	TArray<float> LastLapSectorTimes;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Timing")
+	TArray<float> BestSectorTimes;
+
+	// Bumped whenever a sector closes, so the HUD only reacts to new splits
+	UPROPERTY(BlueprintReadOnly, Category = "Timing")
+	int32 SplitSerial = 0;
+
+	float LastSplitTime = 0.0f;
+
+	void Reset(float StartTime);
+
+	// Closes the current sector at Time and returns its index
+	int32 CloseSector(float Time);
+
+	// Closes the final sector and the lap; returns the lap time
+	float CompleteLap(float Time);
+
+	bool HasFinished() const { return FinishTime >= 0.0f; }
+};
@@ -0,0 +1,125 @@
+#include "WRRaceWorldSubsystem.h"
+#include "WastelandRacers/WastelandRacers.h"
+#include "WastelandRacers/Gameplay/WRRaceManager.h"
+#include "WastelandRacers/Tracks/WRTrackCheckpoint.h"
+#include "Algo/BinarySearch.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+UWRRaceWorldSubsystem* UWRRaceWorldSubsystem::GetInstance(const UObject* WorldContext)
+{
+	if (const UWorld* World = GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::ReturnNull))
+	{
+		return World->GetSubsystem<UWRRaceWorldSubsystem>();
+	}
+	return nullptr;
+}
+
+bool UWRRaceWorldSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UWRRaceWorldSubsystem::Deinitialize()
+{
+	OnRaceEvents.Clear();
+	PendingEvents.Reset();
+	RaceManager = nullptr;
+	Checkpoints.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UWRRaceWorldSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UWRRaceWorldSubsystem, STATGROUP_Tickables);
+}
+
+void UWRRaceWorldSubsystem::RegisterRaceManager(AWRRaceManager* InRaceManager)
+{
+	if (RaceManager && RaceManager != InRaceManager)
+	{
+		UE_LOG(LogWastelandRacers, Warning, TEXT("Second race manager %s registered; replacing %s"), *GetNameSafe(InRaceManager), *GetNameSafe(RaceManager));
+	}
+	RaceManager = InRaceManager;
+}
+
+void UWRRaceWorldSubsystem::UnregisterRaceManager(AWRRaceManager* InRaceManager)
+{
+	if (RaceManager == InRaceManager)
+	{
+		RaceManager = nullptr;
+	}
+}
+
+void UWRRaceWorldSubsystem::RegisterCheckpoint(AWRTrackCheckpoint* Checkpoint)
+{
+	if (!Checkpoint || Checkpoints.Contains(Checkpoint))
+	{
+		return;
+	}
+
+	const int32 InsertIndex = Algo::UpperBoundBy(Checkpoints, Checkpoint->GetCheckpointIndex(),
+		[](const AWRTrackCheckpoint* Existing) { return Existing->GetCheckpointIndex(); });
+	Checkpoints.Insert(Checkpoint, InsertIndex);
+}
+
+void UWRRaceWorldSubsystem::UnregisterCheckpoint(AWRTrackCheckpoint* Checkpoint)
+{
+	Checkpoints.Remove(Checkpoint);
+}
+
+bool UWRRaceWorldSubsystem::PostEvent(EWRRaceEventType Type, AWRKart* Kart, AActor* Source, int32 Payload, const FVector& Location)
+{
+	if (PendingEvents.Num() >= MaxQueuedEvents)
+	{
+		if (DroppedEvents++ == 0)
+		{
+			UE_LOG(LogWastelandRacers, Warning, TEXT("Race event queue full (%d); dropping events"), MaxQueuedEvents);
+		}
+		return false;
+	}
+
+	FWRRaceEvent& Event = PendingEvents.AddDefaulted_GetRef();
+	Event.Type = Type;
+	Event.Kart = Kart;
+	Event.Source = Source;
+	Event.Payload = Payload;
+	Event.Location = Location;
+	return true;
+}
+
+void UWRRaceWorldSubsystem::Tick(float DeltaTime)
+{
+	if (PendingEvents.Num() == 0)
+	{
+		return;
+	}
+
+	// Swapped out first so listeners can post follow-up events for the next tick
+	DispatchingEvents = PendingEvents;
+	PendingEvents.Reset();
+
+	DispatchingEvents.RemoveAll([](const FWRRaceEvent& Event)
+	{
+		return Event.Kart.IsStale() || Event.Source.IsStale();
+	});
+	if (DispatchingEvents.Num() == 0)
+	{
+		return;
+	}
+
+	// Checkpoints play their own effects and fire their Blueprint delegate outside the overlap callback
+	for (const FWRRaceEvent& Event : DispatchingEvents)
+	{
+		if (Event.Type == EWRRaceEventType::CheckpointCrossed)
+		{
+			if (AWRTrackCheckpoint* Checkpoint = Cast<AWRTrackCheckpoint>(Event.Source.Get()))
+			{
+				Checkpoint->NotifyKartPassed(Event.Kart.Get());
+			}
+		}
+	}
+
+	OnRaceEvents.Broadcast(DispatchingEvents);
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WRRaceWorldSubsystem.generated.h"
+
+UENUM(BlueprintType)
+enum class EWRRaceEventType : uint8
+{
+	CheckpointCrossed,	// Payload: checkpoint index
+	LapCompleted,		// Payload: laps completed
+	KartFinished,		// Payload: finishing position
+	PowerUpCollected,	// Payload: power-up type
+	HazardEntered,		// Payload: hazard type
+	HazardActivated,	// Payload: hazard type
+	ShortcutUsed,		// Payload: shortcut index, Source: the AWRShortcutSystem
+	LapRejected,		// Payload: number of checkpoints missed
+	KartRespawned		// Payload: EWRRespawnReason
+};
+
+// Actors are held weakly while the event waits in the queue; events whose actor was destroyed before
+// dispatch are dropped, so listeners only see null where none was posted
+USTRUCT(BlueprintType)
+struct FWRRaceEvent
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Race")
+	EWRRaceEventType Type = EWRRaceEventType::CheckpointCrossed;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Race")
+	TWeakObjectPtr<class AWRKart> Kart;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Race")
+	TWeakObjectPtr<AActor> Source;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Race")
+	int32 Payload = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Race")
+	FVector Location = FVector::ZeroVector;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FWROnRaceEvents, TArrayView<const FWRRaceEvent>);
+
+// Per-world registry of the race manager and checkpoints, plus a fixed-capacity event queue.
+// Collision callbacks post events here instead of searching the world or calling into other
+// actors; the queue is handed to listeners as one batch per tick.
+UCLASS()
+class WASTELANDRACERS_API UWRRaceWorldSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static constexpr int32 MaxQueuedEvents = 256;
+
+	static UWRRaceWorldSubsystem* GetInstance(const UObject* WorldContext);
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Registry
+	void RegisterRaceManager(class AWRRaceManager* RaceManager);
+	void UnregisterRaceManager(class AWRRaceManager* RaceManager);
+	class AWRRaceManager* GetRaceManager() const { return RaceManager; }
+
+	void RegisterCheckpoint(class AWRTrackCheckpoint* Checkpoint);
+	void UnregisterCheckpoint(class AWRTrackCheckpoint* Checkpoint);
+
+	// Sorted by checkpoint index
+	const TArray<class AWRTrackCheckpoint*>& GetCheckpoints() const { return Checkpoints; }
+
+	// Events posted during dispatch are delivered next tick. Returns false if the queue is full.
+	bool PostEvent(EWRRaceEventType Type, class AWRKart* Kart, AActor* Source, int32 Payload, const FVector& Location);
+
+	int32 GetDroppedEvents() const { return DroppedEvents; }
+
+	FWROnRaceEvents OnRaceEvents;
+
+private:
+	UPROPERTY()
+	class AWRRaceManager* RaceManager = nullptr;
+
+	UPROPERTY()
+	TArray<class AWRTrackCheckpoint*> Checkpoints;
+
+	TArray<FWRRaceEvent, TFixedAllocator<MaxQueuedEvents>> PendingEvents;
+	TArray<FWRRaceEvent, TFixedAllocator<MaxQueuedEvents>> DispatchingEvents;
+	int32 DroppedEvents = 0;
+};
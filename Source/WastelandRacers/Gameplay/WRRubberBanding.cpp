@@ -0,0 +1,54 @@
+#include "WRRubberBanding.h"
+
+FWRRubberBandSettings::FWRRubberBandSettings()
+{
+	// Harder bots fight back harder when behind and give less away when ahead
+	MaxCatchUp.GetRichCurve()->AddKey(0.0f, 0.05f);
+	MaxCatchUp.GetRichCurve()->AddKey(1.0f, 0.2f);
+	MaxSlowDown.GetRichCurve()->AddKey(0.0f, 0.2f);
+	MaxSlowDown.GetRichCurve()->AddKey(1.0f, 0.05f);
+}
+
+float FWRRubberBanding::GetTargetScale(const FWRRubberBandSettings& Settings, float GapMetres, float Difficulty)
+{
+	const float Excess = FMath::Abs(GapMetres) - Settings.DeadZone;
+	if (!Settings.bEnabled || Excess <= 0.0f)
+	{
+		return 1.0f;
+	}
+
+	const float Alpha = FMath::SmoothStep(0.0f, 1.0f, Excess / FMath::Max(Settings.FullEffectGap, 1.0f));
+	if (GapMetres > 0.0f)
+	{
+		return 1.0f + Alpha * FMath::Max(0.0f, Settings.MaxCatchUp.GetRichCurveConst()->Eval(Difficulty, 0.0f));
+	}
+	return 1.0f - Alpha * FMath::Clamp(Settings.MaxSlowDown.GetRichCurveConst()->Eval(Difficulty, 0.0f), 0.0f, 0.9f);
+}
+
+void FWRRubberBanding::Update(const FWRRubberBandSettings& Settings, TArrayView<const float> RaceProgress, TArrayView<const uint8> KartFlags,
+	TArrayView<const float> Difficulties, float LapLength, float DeltaTime, TArrayView<float> InOutScales)
+{
+	float LeadHumanProgress = -1.0f;
+	bool bHasHuman = false;
+	for (int32 i = 0; i < KartFlags.Num(); i++)
+	{
+		if (KartFlags[i] & KartHuman)
+		{
+			LeadHumanProgress = bHasHuman ? FMath::Max(LeadHumanProgress, RaceProgress[i]) : RaceProgress[i];
+			bHasHuman = true;
+		}
+	}
+
+	// Progress is in laps and the lap length in cm
+	const float LapMetres = LapLength * 0.01f;
+	const float MaxChange = Settings.ResponseRate * DeltaTime;
+	for (int32 i = 0; i < KartFlags.Num(); i++)
+	{
+		float Target = 1.0f;
+		if (bHasHuman && (KartFlags[i] & KartBanded))
+		{
+			Target = GetTargetScale(Settings, (LeadHumanProgress - RaceProgress[i]) * LapMetres, Difficulties[i]);
+		}
+		InOutScales[i] = FMath::Clamp(Target, InOutScales[i] - MaxChange, InOutScales[i] + MaxChange);
+	}
+}
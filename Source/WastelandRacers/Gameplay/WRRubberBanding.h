@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Curves/CurveFloat.h"
+#include "WRRubberBanding.generated.h"
+
+USTRUCT(BlueprintType)
+struct FWRRubberBandSettings
+{
+	GENERATED_BODY()
+
+	FWRRubberBandSettings();
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rubber Banding")
+	bool bEnabled = true;
+
+	// Gap in metres to the lead human inside which bots drive unassisted
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rubber Banding", meta = (ClampMin = "0.0"))
+	float DeadZone = 15.0f;
+
+	// Gap in metres beyond the dead zone at which the full catch-up or slow-down applies
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rubber Banding", meta = (ClampMin = "1.0"))
+	float FullEffectGap = 150.0f;
+
+	// Engine torque added for a bot far behind, as a fraction, against difficulty from 0 to 1
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rubber Banding")
+	FRuntimeFloatCurve MaxCatchUp;
+
+	// Engine torque removed for a bot far ahead, as a fraction, against difficulty from 0 to 1
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rubber Banding")
+	FRuntimeFloatCurve MaxSlowDown;
+
+	// Largest change of the torque multiplier per second, so assistance fades in and out
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rubber Banding", meta = (ClampMin = "0.0"))
+	float ResponseRate = 0.2f;
+};
+
+// Rubber-banding for every bot from its race distance to the lead human, run once per race step.
+// Only race manager state is read, so replays and the headless benchmark reproduce it exactly.
+class WASTELANDRACERS_API FWRRubberBanding
+{
+public:
+	// Per kart input flags
+	static constexpr uint8 KartHuman = 1 << 0;
+	static constexpr uint8 KartBanded = 1 << 1;
+
+	// Torque multiplier for a bot GapMetres behind the lead human, negative when ahead
+	static float GetTargetScale(const FWRRubberBandSettings& Settings, float GapMetres, float Difficulty);
+
+	// Arrays are indexed by kart. Banded karts move their scale towards the target; every other
+	// kart, and every kart when no human is racing, eases back to 1.
+	static void Update(const FWRRubberBandSettings& Settings, TArrayView<const float> RaceProgress, TArrayView<const uint8> KartFlags,
+		TArrayView<const float> Difficulties, float LapLength, float DeltaTime, TArrayView<float> InOutScales);
+};
@@ -0,0 +1,276 @@
+#include "WRTrackProgress.h"
+#include "WastelandRacers/WastelandRacers.h"
+#include "Components/SplineComponent.h"
+#include "Algo/BinarySearch.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+void FWRTrackProgress::Build(const USplineComponent* Spline, float SampleSpacing)
+{
+	Reset();
+
+	if (!Spline || Spline->GetNumberOfSplinePoints() < 2)
+	{
+		return;
+	}
+
+	const float SplineLength = Spline->GetSplineLength();
+	const int32 NumSamples = FMath::Max(2, FMath::CeilToInt(SplineLength / FMath::Max(SampleSpacing, 1.0f)));
+	const bool bLoop = Spline->IsClosedLoop();
+
+	// Closed loops wrap back to the first sample, so the end point is not duplicated
+	const int32 NumPoints = bLoop ? NumSamples : NumSamples + 1;
+
+	TArray<FVector> Points;
+	Points.Reserve(NumPoints);
+	for (int32 i = 0; i < NumPoints; i++)
+	{
+		const float Distance = SplineLength * (float)i / (float)NumSamples;
+		Points.Add(Spline->GetLocationAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::World));
+	}
+
+	BuildFromPoints(Points, bLoop);
+
+	UE_LOG(LogWastelandRacers, Log, TEXT("Track progress table built: %d segments, lap length %.0f"), GetNumSegments(), LapLength);
+}
+
+void FWRTrackProgress::BuildFromPoints(TArrayView<const FVector> Points, bool bInClosedLoop)
+{
+	Reset();
+
+	bClosedLoop = bInClosedLoop;
+	const int32 NumSegments = bClosedLoop ? Points.Num() : Points.Num() - 1;
+	if (Points.Num() < 2 || NumSegments < 1)
+	{
+		return;
+	}
+
+	SegmentStarts.Reserve(NumSegments);
+	SegmentDirections.Reserve(NumSegments);
+	SegmentLengths.Reserve(NumSegments);
+	SegmentStartDistances.Reserve(NumSegments);
+
+	float Accumulated = 0.0f;
+	for (int32 i = 0; i < NumSegments; i++)
+	{
+		const FVector3f Start(Points[i]);
+		const FVector3f End(Points[(i + 1) % Points.Num()]);
+		const FVector3f Delta = End - Start;
+		const float Length = Delta.Size();
+
+		SegmentStarts.Add(Start);
+		SegmentDirections.Add(Length > KINDA_SMALL_NUMBER ? Delta / Length : FVector3f::ForwardVector);
+		SegmentLengths.Add(Length);
+		SegmentStartDistances.Add(Accumulated);
+
+		Accumulated += Length;
+	}
+
+	LapLength = Accumulated;
+}
+
+void FWRTrackProgress::Reset()
+{
+	SegmentStarts.Reset();
+	SegmentDirections.Reset();
+	SegmentLengths.Reset();
+	SegmentStartDistances.Reset();
+	LapLength = 0.0f;
+}
+
+float FWRTrackProgress::ProjectPoint(const FVector& Location, FWRTrackProgressState& State) const
+{
+	if (!IsValid())
+	{
+		State = FWRTrackProgressState();
+		return 0.0f;
+	}
+
+	const FVector3f Point(Location);
+	float BestAlong = 0.0f;
+	int32 BestSegment = State.SegmentIndex;
+
+	if (!SegmentLengths.IsValidIndex(BestSegment))
+	{
+		BestSegment = FindClosestSegmentFullScan(Point);
+	}
+
+	float BestDistSq = SegmentDistanceSq(BestSegment, Point, BestAlong);
+
+	// Walk from last frame's segment towards the closest one; karts rarely move more than a segment per tick
+	for (int32 Direction : { 1, -1 })
+	{
+		bool bMoved = false;
+		for (int32 Step = 0; Step < MaxLocalSearchSteps; Step++)
+		{
+			const int32 Candidate = WrapSegment(BestSegment + Direction);
+			if (Candidate == INDEX_NONE)
+			{
+				break;
+			}
+
+			float Along = 0.0f;
+			const float DistSq = SegmentDistanceSq(Candidate, Point, Along);
+			if (DistSq >= BestDistSq)
+			{
+				break;
+			}
+
+			BestSegment = Candidate;
+			BestDistSq = DistSq;
+			BestAlong = Along;
+			bMoved = true;
+		}
+
+		if (bMoved)
+		{
+			break;
+		}
+	}
+
+	// Respawns and teleports land far from the cached segment
+	if (BestDistSq > MaxLocalSearchDistanceSq)
+	{
+		BestSegment = FindClosestSegmentFullScan(Point);
+		BestDistSq = SegmentDistanceSq(BestSegment, Point, BestAlong);
+	}
+
+	State.SegmentIndex = BestSegment;
+	State.Distance = SegmentStartDistances[BestSegment] + BestAlong;
+	return State.Distance;
+}
+
+void FWRTrackProgress::GetPointAtDistance(float Distance, FVector& OutLocation, FVector& OutDirection) const
+{
+	if (!IsValid())
+	{
+		OutLocation = FVector::ZeroVector;
+		OutDirection = FVector::ForwardVector;
+		return;
+	}
+
+	Distance = bClosedLoop ? FMath::Fmod(Distance, LapLength) : Distance;
+	if (Distance < 0.0f)
+	{
+		Distance = bClosedLoop ? Distance + LapLength : 0.0f;
+	}
+
+	const int32 Segment = FMath::Clamp(Algo::UpperBound(SegmentStartDistances, Distance) - 1, 0, SegmentLengths.Num() - 1);
+	const float Along = FMath::Clamp(Distance - SegmentStartDistances[Segment], 0.0f, SegmentLengths[Segment]);
+	OutLocation = FVector(SegmentStarts[Segment] + SegmentDirections[Segment] * Along);
+	OutDirection = FVector(SegmentDirections[Segment]);
+}
+
+int32 FWRTrackProgress::WrapSegment(int32 Index) const
+{
+	const int32 NumSegments = SegmentLengths.Num();
+	if (Index >= 0 && Index < NumSegments)
+	{
+		return Index;
+	}
+
+	if (!bClosedLoop)
+	{
+		return INDEX_NONE;
+	}
+
+	return (Index % NumSegments + NumSegments) % NumSegments;
+}
+
+float FWRTrackProgress::SegmentDistanceSq(int32 Index, const FVector3f& Point, float& OutAlong) const
+{
+	const FVector3f ToPoint = Point - SegmentStarts[Index];
+	OutAlong = FMath::Clamp(FVector3f::DotProduct(ToPoint, SegmentDirections[Index]), 0.0f, SegmentLengths[Index]);
+	return (ToPoint - SegmentDirections[Index] * OutAlong).SizeSquared();
+}
+
+int32 FWRTrackProgress::FindClosestSegmentFullScan(const FVector3f& Point) const
+{
+	int32 BestSegment = 0;
+	float BestDistSq = TNumericLimits<float>::Max();
+
+	for (int32 i = 0; i < SegmentLengths.Num(); i++)
+	{
+		float Along = 0.0f;
+		const float DistSq = SegmentDistanceSq(i, Point, Along);
+		if (DistSq < BestDistSq)
+		{
+			BestDistSq = DistSq;
+			BestSegment = i;
+		}
+	}
+
+	return BestSegment;
+}
+
+#if !UE_BUILD_SHIPPING
+// Measures projection cost per kart per tick on a synthetic circuit similar to AWRTrackVariations::GenerateCircuitTrack
+static FAutoConsoleCommand BenchTrackProgressCommand(
+	TEXT("wr.Bench.TrackProgress"),
+	TEXT("Benchmarks FWRTrackProgress projection cost per kart per tick for 8, 32 and 128 karts"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		TArray<FVector> Points;
+		const int32 NumPoints = 200;
+		for (int32 i = 0; i < NumPoints; i++)
+		{
+			const float Angle = (float)i / (float)NumPoints * 2.0f * PI;
+			const float Radius = 6000.0f + FMath::Sin(Angle * 3.0f) * 1200.0f;
+			Points.Add(FVector(FMath::Cos(Angle) * Radius, FMath::Sin(Angle) * Radius, FMath::Sin(Angle * 2.0f) * 200.0f));
+		}
+
+		FWRTrackProgress Progress;
+		Progress.BuildFromPoints(Points, true);
+
+		const int32 NumTicks = 2000;
+		const float TickTime = 1.0f / 60.0f;
+		const float KartSpeed = 2500.0f;
+
+		for (int32 NumKarts : { 8, 32, 128 })
+		{
+			FRandomStream Random(1234);
+			TArray<FWRTrackProgressState> States;
+			TArray<float> Distances;
+			TArray<float> Offsets;
+			States.SetNum(NumKarts);
+			for (int32 k = 0; k < NumKarts; k++)
+			{
+				Distances.Add(Random.FRandRange(0.0f, Progress.GetLapLength()));
+				Offsets.Add(Random.FRandRange(-300.0f, 300.0f));
+			}
+
+			TArray<FVector> Locations;
+			Locations.SetNum(NumKarts);
+
+			double Checksum = 0.0;
+			uint64 Cycles = 0;
+			for (int32 Tick = 0; Tick < NumTicks; Tick++)
+			{
+				for (int32 k = 0; k < NumKarts; k++)
+				{
+					Distances[k] = FMath::Fmod(Distances[k] + KartSpeed * TickTime, Progress.GetLapLength());
+
+					// Reconstruct a kart position on the polyline with a lateral offset
+					const float Alpha = Distances[k] / Progress.GetLapLength() * NumPoints;
+					const int32 Index = FMath::FloorToInt(Alpha) % NumPoints;
+					const FVector A = Points[Index];
+					const FVector B = Points[(Index + 1) % NumPoints];
+					const FVector Right = FVector::CrossProduct(B - A, FVector::UpVector).GetSafeNormal();
+					Locations[k] = FMath::Lerp(A, B, (double)(Alpha - FMath::FloorToFloat(Alpha))) + Right * Offsets[k];
+				}
+
+				const uint64 Start = FPlatformTime::Cycles64();
+				for (int32 k = 0; k < NumKarts; k++)
+				{
+					Checksum += Progress.ProjectPoint(Locations[k], States[k]);
+				}
+				Cycles += FPlatformTime::Cycles64() - Start;
+			}
+
+			const double TotalNs = FPlatformTime::ToMilliseconds64(Cycles) * 1.0e6;
+			UE_LOG(LogWastelandRacers, Display, TEXT("TrackProgress: %3d karts, %.1f ns per kart per tick, %.4f ms per tick (checksum %.0f)"),
+				NumKarts, TotalNs / (double)(NumTicks * NumKarts), TotalNs / (double)NumTicks * 1.0e-6, Checksum);
+		}
+	}));
+#endif
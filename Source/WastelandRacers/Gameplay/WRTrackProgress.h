@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Per-kart cache used to make projection onto the centre-line O(1) in the common case
+struct FWRTrackProgressState
+{
+	int32 SegmentIndex = INDEX_NONE;
+	float Distance = 0.0f;
+};
+
+// Arc-length lookup table built from the track centre-line spline.
+// Karts are projected onto the sampled polyline starting from last frame's segment,
+// so the cost per kart stays close to constant regardless of track length.
+class WASTELANDRACERS_API FWRTrackProgress
+{
+public:
+	void Build(const class USplineComponent* Spline, float SampleSpacing = 100.0f);
+	void BuildFromPoints(TArrayView<const FVector> Points, bool bInClosedLoop);
+	void Reset();
+
+	bool IsValid() const { return SegmentLengths.Num() > 0; }
+	bool IsClosedLoop() const { return bClosedLoop; }
+	float GetLapLength() const { return LapLength; }
+	int32 GetNumSegments() const { return SegmentLengths.Num(); }
+
+	// Returns the distance along the track of the point closest to Location and updates State
+	float ProjectPoint(const FVector& Location, FWRTrackProgressState& State) const;
+
+	// Centre-line point and forward direction at a distance along the track; distances wrap on closed loops
+	void GetPointAtDistance(float Distance, FVector& OutLocation, FVector& OutDirection) const;
+
+	// Continuous race progress in laps: completed laps plus the fraction of the current lap
+	float CalculateProgress(int32 CompletedLaps, float Distance) const
+	{
+		return (float)CompletedLaps + (LapLength > 0.0f ? Distance / LapLength : 0.0f);
+	}
+
+private:
+	TArray<FVector3f> SegmentStarts;
+	TArray<FVector3f> SegmentDirections;
+	TArray<float> SegmentLengths;
+	TArray<float> SegmentStartDistances;
+	float LapLength = 0.0f;
+	bool bClosedLoop = true;
+
+	// Squared distance a kart may be from its cached segment before a full rescan is forced
+	float MaxLocalSearchDistanceSq = 1500.0f * 1500.0f;
+	static constexpr int32 MaxLocalSearchSteps = 32;
+
+	int32 WrapSegment(int32 Index) const;
+	float SegmentDistanceSq(int32 Index, const FVector3f& Point, float& OutAlong) const;
+	int32 FindClosestSegmentFullScan(const FVector3f& Point) const;
+};
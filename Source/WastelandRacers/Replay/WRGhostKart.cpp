@@ -0,0 +1,125 @@
+#include "WRGhostKart.h"
+#include "WastelandRacers/WastelandRacers.h"
+#include "Components/StaticMeshComponent.h"
+
+AWRGhostKart::AWRGhostKart()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+
+	GhostMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("GhostMesh"));
+	GhostMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	GhostMesh->SetGenerateOverlapEvents(false);
+	GhostMesh->SetSimulatePhysics(false);
+	GhostMesh->SetCastShadow(false);
+	GhostMesh->CanCharacterStepUpOn = ECB_No;
+	RootComponent = GhostMesh;
+
+	SetActorEnableCollision(false);
+}
+
+void AWRGhostKart::BeginPlay()
+{
+	Super::BeginPlay();
+
+	GameplayClock = UWRGameplayClock::GetInstance(this);
+	if (GameplayClock)
+	{
+		FixedStepHandle = GameplayClock->Register(EWRFixedStepPhase::Race, FWROnFixedStep::FDelegate::CreateUObject(this, &AWRGhostKart::FixedStep));
+	}
+}
+
+void AWRGhostKart::FixedStep(float FixedDeltaTime)
+{
+	if (!HasGhost())
+	{
+		return;
+	}
+
+	// Holds the final pose once the lap has been played out
+	PlaybackTime.Push(FMath::Min(PlaybackTime.Current + FixedDeltaTime, GetLapTime()));
+}
+
+void AWRGhostKart::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Without a gameplay clock (e.g. editor preview worlds) advance on the frame
+	if (!FixedStepHandle.IsValid())
+	{
+		FixedStep(DeltaTime);
+	}
+
+	const float Alpha = FixedStepHandle.IsValid() ? GameplayClock->GetInterpolationAlpha() : 1.0f;
+	Decoder.AdvanceTo(PlaybackTime.Get(Alpha));
+
+	FWRReplayKartState State;
+	Decoder.GetKartState(0, State);
+	SetActorLocationAndRotation(State.Location, State.Rotation);
+}
+
+void AWRGhostKart::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (GameplayClock)
+	{
+		GameplayClock->Unregister(EWRFixedStepPhase::Race, FixedStepHandle);
+		GameplayClock = nullptr;
+	}
+
+	UnloadGhost();
+	Super::EndPlay(EndPlayReason);
+}
+
+bool AWRGhostKart::LoadGhost(const FString& Path, EWRGhostType Type)
+{
+	UnloadGhost();
+
+	if (!Replay.Open(Path))
+	{
+		return false;
+	}
+
+	GhostType = Type;
+	Decoder.Initialize(Replay.GetView());
+
+	// Split events are few, so cache them rather than scanning the view per query
+	for (const FWRReplayEvent& Event : Replay.GetView().Events)
+	{
+		if (Event.Type == EWRReplayEventType::SectorCrossed && Event.Payload >= 0)
+		{
+			while (SplitTimes.Num() <= Event.Payload)
+			{
+				SplitTimes.Add(-1.0f);
+			}
+			SplitTimes[Event.Payload] = Event.Time;
+		}
+	}
+
+	RestartLap();
+	SetActorTickEnabled(true);
+	SetActorHiddenInGame(false);
+	OnGhostLoaded(Type);
+
+	UE_LOG(LogWastelandRacers, Log, TEXT("Loaded ghost %s: lap %.3f s"), *Path, GetLapTime());
+	return true;
+}
+
+void AWRGhostKart::UnloadGhost()
+{
+	SetActorTickEnabled(false);
+	SetActorHiddenInGame(true);
+	Decoder.Reset();
+	Replay.Close();
+	SplitTimes.Reset();
+}
+
+void AWRGhostKart::RestartLap(float StartTime)
+{
+	PlaybackTime.Reset(StartTime);
+	Decoder.Seek(StartTime);
+}
+
+float AWRGhostKart::GetSplitTime(int32 Sector) const
+{
+	return SplitTimes.IsValidIndex(Sector) ? SplitTimes[Sector] : -1.0f;
+}
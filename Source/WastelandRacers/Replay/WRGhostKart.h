@@ -0,0 +1,72 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "WastelandRacers/Replay/WRMappedReplay.h"
+#include "WastelandRacers/Core/WRGameplayClock.h"
+#include "WRGhostKart.generated.h"
+
+UENUM(BlueprintType)
+enum class EWRGhostType : uint8
+{
+	PersonalBest,
+	Friend,
+	Developer
+};
+
+// Visual-only kart that replays a single saved lap. It has no collision and no physics,
+// so each ghost costs one decoder step and one transform update per frame. Playback time
+// advances on the gameplay clock's race phase, alongside the lap timing it is compared against.
+UCLASS()
+class WASTELANDRACERS_API AWRGhostKart : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AWRGhostKart();
+
+	virtual void BeginPlay() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	bool LoadGhost(const FString& Path, EWRGhostType Type);
+	void UnloadGhost();
+
+	// Starts the ghost lap again, StartTime seconds past the line
+	void RestartLap(float StartTime = 0.0f);
+
+	UFUNCTION(BlueprintPure, Category = "Ghost")
+	bool HasGhost() const { return Replay.IsOpen(); }
+
+	UFUNCTION(BlueprintPure, Category = "Ghost")
+	EWRGhostType GetGhostType() const { return GhostType; }
+
+	UFUNCTION(BlueprintPure, Category = "Ghost")
+	float GetLapTime() const { return Replay.GetView().Duration; }
+
+	// Time into the lap at which the ghost finished the given sector, or -1 if unknown
+	UFUNCTION(BlueprintPure, Category = "Ghost")
+	float GetSplitTime(int32 Sector) const;
+
+protected:
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+	class UStaticMeshComponent* GhostMesh;
+
+	// Lets the blueprint pick a material per ghost type
+	UFUNCTION(BlueprintImplementableEvent, Category = "Ghost")
+	void OnGhostLoaded(EWRGhostType Type);
+
+private:
+	FWRMappedReplay Replay;
+	FWRReplayDecoder Decoder;
+	TArray<float> SplitTimes;
+	TWRFixedStepValue<float> PlaybackTime;
+	EWRGhostType GhostType = EWRGhostType::PersonalBest;
+
+	UPROPERTY()
+	UWRGameplayClock* GameplayClock = nullptr;
+
+	FDelegateHandle FixedStepHandle;
+
+	void FixedStep(float FixedDeltaTime);
+};
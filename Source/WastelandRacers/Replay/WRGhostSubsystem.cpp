@@ -0,0 +1,306 @@
+#include "WRGhostSubsystem.h"
+#include "WastelandRacers/WastelandRacers.h"
+#include "WastelandRacers/Gameplay/WRRaceManager.h"
+#include "WastelandRacers/Vehicles/WRKart.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/Paths.h"
+
+UWRGhostSubsystem* UWRGhostSubsystem::GetInstance(const UObject* WorldContext)
+{
+	if (const UWorld* World = GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::ReturnNull))
+	{
+		return World->GetSubsystem<UWRGhostSubsystem>();
+	}
+	return nullptr;
+}
+
+void UWRGhostSubsystem::Deinitialize()
+{
+	RaceManager = nullptr;
+	PlayerKart = nullptr;
+	Ghosts.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UWRGhostSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UWRGhostSubsystem, STATGROUP_Tickables);
+}
+
+void UWRGhostSubsystem::Tick(float DeltaTime)
+{
+	if (!PlayerKart || !RaceManager)
+	{
+		return;
+	}
+
+	const FWRKartLapTiming* Timing = RaceManager->FindKartLapTiming(PlayerKart);
+	if (!Timing)
+	{
+		return;
+	}
+
+	if (PlayerKart->GetCurrentLap() > CurrentLap)
+	{
+		CompleteLap(*Timing);
+		return;
+	}
+
+	// Rolling over the line from the grid restarts the lap without completing one
+	if (Timing->LapStartTime != LapStartTime)
+	{
+		BeginLap(Timing->LapStartTime);
+		return;
+	}
+
+	LapTime = RaceManager->GetRaceTime() - LapStartTime;
+	SampleAccumulator += DeltaTime;
+	if (SampleAccumulator + KINDA_SMALL_NUMBER >= 1.0f / RecordSampleRate)
+	{
+		SampleAccumulator = 0.0f;
+		SamplePlayer();
+	}
+
+	RecordSectors(Timing->CurrentSectorTimes);
+}
+
+void UWRGhostSubsystem::StartTimeTrial(AWRRaceManager* InRaceManager, AWRKart* InPlayerKart, FName InTrackId)
+{
+	StopTimeTrial();
+
+	if (!InRaceManager || !InPlayerKart || InTrackId.IsNone())
+	{
+		return;
+	}
+
+	RaceManager = InRaceManager;
+	PlayerKart = InPlayerKart;
+	TrackId = InTrackId;
+	RecordSampleRate = FMath::Max(1.0f, RecordSampleRate);
+	PlayerState.SetNum(1);
+
+	for (EWRGhostType Type : { EWRGhostType::PersonalBest, EWRGhostType::Friend, EWRGhostType::Developer })
+	{
+		SpawnGhost(Type);
+	}
+
+	LastLapDelta = 0.0f;
+	LastSectorDelta = 0.0f;
+	LastSplitSector = INDEX_NONE;
+	CurrentLap = PlayerKart->GetCurrentLap();
+	const FWRKartLapTiming* Timing = RaceManager->FindKartLapTiming(PlayerKart);
+	BeginLap(Timing ? Timing->LapStartTime : RaceManager->GetRaceTime());
+}
+
+void UWRGhostSubsystem::StopTimeTrial()
+{
+	for (AWRGhostKart* Ghost : Ghosts)
+	{
+		if (Ghost)
+		{
+			Ghost->Destroy();
+		}
+	}
+
+	Ghosts.Reset();
+	RaceManager = nullptr;
+	PlayerKart = nullptr;
+}
+
+float UWRGhostSubsystem::GetBestLapTime() const
+{
+	const AWRGhostKart* PersonalBest = FindGhost(EWRGhostType::PersonalBest);
+	return PersonalBest && PersonalBest->HasGhost() ? PersonalBest->GetLapTime() : -1.0f;
+}
+
+FString UWRGhostSubsystem::GetGhostPath(FName ForTrackId, EWRGhostType Type) const
+{
+	const FString TrackName = ForTrackId.ToString();
+	switch (Type)
+	{
+		case EWRGhostType::Friend:
+			return FPaths::ProjectSavedDir() / TEXT("Ghosts") / TrackName / TEXT("Friend.wrrp");
+
+		case EWRGhostType::Developer:
+			// Content/Ghosts is staged as a non-asset directory
+			return FPaths::ProjectContentDir() / TEXT("Ghosts") / TrackName / TEXT("Developer.wrrp");
+
+		default:
+			return FPaths::ProjectSavedDir() / TEXT("Ghosts") / TrackName / TEXT("PersonalBest.wrrp");
+	}
+}
+
+AWRGhostKart* UWRGhostSubsystem::SpawnGhost(EWRGhostType Type)
+{
+	const FString Path = GetGhostPath(TrackId, Type);
+	if (!FPaths::FileExists(Path))
+	{
+		return nullptr;
+	}
+
+	UClass* Class = GhostClass.IsNull() ? AWRGhostKart::StaticClass() : GhostClass.LoadSynchronous();
+	if (!Class)
+	{
+		Class = AWRGhostKart::StaticClass();
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	AWRGhostKart* Ghost = GetWorld()->SpawnActor<AWRGhostKart>(Class, FTransform::Identity, SpawnParams);
+	if (Ghost && !Ghost->LoadGhost(Path, Type))
+	{
+		Ghost->Destroy();
+		return nullptr;
+	}
+
+	if (Ghost)
+	{
+		Ghosts.Add(Ghost);
+	}
+	return Ghost;
+}
+
+AWRGhostKart* UWRGhostSubsystem::FindGhost(EWRGhostType Type) const
+{
+	for (AWRGhostKart* Ghost : Ghosts)
+	{
+		if (Ghost && Ghost->GetGhostType() == Type)
+		{
+			return Ghost;
+		}
+	}
+	return nullptr;
+}
+
+const AWRGhostKart* UWRGhostSubsystem::GetReferenceGhost() const
+{
+	for (EWRGhostType Type : { EWRGhostType::PersonalBest, EWRGhostType::Friend, EWRGhostType::Developer })
+	{
+		const AWRGhostKart* Ghost = FindGhost(Type);
+		if (Ghost && Ghost->HasGhost())
+		{
+			return Ghost;
+		}
+	}
+	return nullptr;
+}
+
+void UWRGhostSubsystem::BeginLap(float InLapStartTime)
+{
+	// Detected a step after the crossing, so the lap is already a little way in
+	LapStartTime = InLapStartTime;
+	LapTime = FMath::Max(0.0f, RaceManager->GetRaceTime() - LapStartTime);
+	SampleAccumulator = 0.0f;
+	RecordedSectors = 0;
+	SplitTime = 0.0f;
+
+	const FString KartName = PlayerKart->GetName();
+	LapRecorder.Begin(MakeArrayView(&KartName, 1), RecordSampleRate, FMath::CeilToInt(RecordSampleRate * 2.0f));
+	SamplePlayer();
+
+	for (AWRGhostKart* Ghost : Ghosts)
+	{
+		if (Ghost)
+		{
+			Ghost->RestartLap(LapTime);
+		}
+	}
+}
+
+void UWRGhostSubsystem::SamplePlayer()
+{
+	FWRReplayKartState& State = PlayerState[0];
+	State.Location = PlayerKart->GetActorLocation();
+	State.Rotation = PlayerKart->GetActorRotation();
+	State.Throttle = PlayerKart->GetThrottleInput();
+	State.Steering = PlayerKart->GetSteeringInput();
+	State.Flags = (PlayerKart->IsBoosting() ? WRReplay::Flag_Boosting : 0)
+		| (PlayerKart->IsDrifting() ? WRReplay::Flag_Drifting : 0);
+
+	LapRecorder.AddFrame(LapTime, PlayerState);
+}
+
+void UWRGhostSubsystem::RecordSectors(TArrayView<const float> SectorTimes)
+{
+	for (; RecordedSectors < SectorTimes.Num(); RecordedSectors++)
+	{
+		SplitTime += SectorTimes[RecordedSectors];
+		CompleteSector(RecordedSectors);
+	}
+}
+
+void UWRGhostSubsystem::CompleteSector(int32 Sector)
+{
+	FWRReplayEvent Event;
+	Event.Time = SplitTime;
+	Event.Type = EWRReplayEventType::SectorCrossed;
+	Event.KartIndex = 0;
+	Event.Payload = Sector;
+	Event.Location = FVector3f(PlayerKart->GetActorLocation());
+	LapRecorder.AddEvent(Event);
+
+	const AWRGhostKart* Reference = GetReferenceGhost();
+	const float GhostSplit = Reference ? Reference->GetSplitTime(Sector) : -1.0f;
+	if (GhostSplit >= 0.0f)
+	{
+		LastSectorDelta = SplitTime - GhostSplit;
+		LastSplitSector = Sector;
+		SplitSerial++;
+	}
+}
+
+void UWRGhostSubsystem::CompleteLap(const FWRKartLapTiming& Timing)
+{
+	// The lap closed at the interpolated line crossing, a little before this frame
+	LapTime = Timing.LastLapTime;
+	SamplePlayer();
+	RecordSectors(Timing.LastLapSectorTimes);
+
+	if (const AWRGhostKart* Reference = GetReferenceGhost())
+	{
+		LastLapDelta = LapTime - Reference->GetLapTime();
+		SplitSerial++;
+	}
+
+	const float BestLapTime = GetBestLapTime();
+	if (BestLapTime < 0.0f || LapTime < BestLapTime)
+	{
+		SavePersonalBest();
+	}
+
+	CurrentLap = PlayerKart->GetCurrentLap();
+	BeginLap(Timing.LapStartTime);
+}
+
+void UWRGhostSubsystem::SavePersonalBest()
+{
+	const FString Path = GetGhostPath(TrackId, EWRGhostType::PersonalBest);
+
+	// The current ghost has this file mapped, so release it before overwriting
+	AWRGhostKart* PersonalBest = FindGhost(EWRGhostType::PersonalBest);
+	if (PersonalBest)
+	{
+		PersonalBest->UnloadGhost();
+	}
+
+	if (!LapRecorder.GetData().SaveToFile(Path))
+	{
+		UE_LOG(LogWastelandRacers, Warning, TEXT("Could not save personal best ghost to %s"), *Path);
+	}
+	else
+	{
+		UE_LOG(LogWastelandRacers, Log, TEXT("New personal best on %s: %.3f s"), *TrackId.ToString(), LapTime);
+	}
+
+	if (PersonalBest)
+	{
+		PersonalBest->LoadGhost(Path, EWRGhostType::PersonalBest);
+	}
+	else
+	{
+		SpawnGhost(EWRGhostType::PersonalBest);
+	}
+}
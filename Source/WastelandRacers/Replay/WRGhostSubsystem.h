@@ -0,0 +1,98 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WastelandRacers/Replay/WRReplayData.h"
+#include "WastelandRacers/Replay/WRGhostKart.h"
+#include "WRGhostSubsystem.generated.h"
+
+// Time-trial ghosts. Records the player's current lap, keeps the fastest one as the
+// personal-best ghost for the track and reports lap and sector deltas against the
+// best available ghost (personal best, then friend, then developer). Lap and sector
+// boundaries are the race manager's checkpoint timings, so the grid run-up before the
+// kart first crosses the line is never recorded as a lap.
+UCLASS(Config = Game)
+class WASTELANDRACERS_API UWRGhostSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UWRGhostSubsystem* GetInstance(const UObject* WorldContext);
+
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	UFUNCTION(BlueprintCallable, Category = "Ghost")
+	void StartTimeTrial(class AWRRaceManager* InRaceManager, class AWRKart* InPlayerKart, FName InTrackId);
+
+	UFUNCTION(BlueprintCallable, Category = "Ghost")
+	void StopTimeTrial();
+
+	UFUNCTION(BlueprintPure, Category = "Ghost")
+	bool IsTimeTrialActive() const { return PlayerKart != nullptr; }
+
+	UFUNCTION(BlueprintPure, Category = "Ghost")
+	float GetBestLapTime() const;
+
+	UFUNCTION(BlueprintPure, Category = "Ghost")
+	float GetLastLapDelta() const { return LastLapDelta; }
+
+	UFUNCTION(BlueprintPure, Category = "Ghost")
+	float GetLastSectorDelta() const { return LastSectorDelta; }
+
+	UFUNCTION(BlueprintPure, Category = "Ghost")
+	int32 GetLastSplitSector() const { return LastSplitSector; }
+
+	// Incremented whenever a new split is available, so the HUD only updates on change
+	int32 GetSplitSerial() const { return SplitSerial; }
+
+	FString GetGhostPath(FName ForTrackId, EWRGhostType Type) const;
+
+protected:
+	UPROPERTY(Config)
+	TSoftClassPtr<AWRGhostKart> GhostClass;
+
+	UPROPERTY(Config)
+	float RecordSampleRate = 30.0f;
+
+private:
+	UPROPERTY()
+	class AWRRaceManager* RaceManager;
+
+	UPROPERTY()
+	class AWRKart* PlayerKart;
+
+	UPROPERTY()
+	TArray<AWRGhostKart*> Ghosts;
+
+	FName TrackId;
+	FWRReplayRecorder LapRecorder;
+	TArray<FWRReplayKartState> PlayerState;
+
+	// Race time the recorded lap started at, and time into it
+	float LapStartTime = 0.0f;
+	float LapTime = 0.0f;
+	float SampleAccumulator = 0.0f;
+	int32 CurrentLap = 0;
+
+	// Sectors of the lap already recorded, and the lap time the last of them closed at
+	int32 RecordedSectors = 0;
+	float SplitTime = 0.0f;
+
+	float LastLapDelta = 0.0f;
+	float LastSectorDelta = 0.0f;
+	int32 LastSplitSector = INDEX_NONE;
+	int32 SplitSerial = 0;
+
+	AWRGhostKart* SpawnGhost(EWRGhostType Type);
+	AWRGhostKart* FindGhost(EWRGhostType Type) const;
+	const AWRGhostKart* GetReferenceGhost() const;
+
+	void BeginLap(float InLapStartTime);
+	void SamplePlayer();
+	void RecordSectors(TArrayView<const float> SectorTimes);
+	void CompleteSector(int32 Sector);
+	void CompleteLap(const struct FWRKartLapTiming& Timing);
+	void SavePersonalBest();
+};
@@ -0,0 +1,58 @@
+#include "WRMappedReplay.h"
+#include "WastelandRacers/WastelandRacers.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+
+FWRMappedReplay::FWRMappedReplay() = default;
+
+FWRMappedReplay::~FWRMappedReplay()
+{
+	Close();
+}
+
+bool FWRMappedReplay::Open(const FString& Path)
+{
+	Close();
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	IPlatformFile::FOpenMappedResult MappedResult = PlatformFile.OpenMappedEx(*Path);
+	if (MappedResult.HasValue())
+	{
+		MappedFile = MappedResult.StealValue();
+		MappedRegion.Reset(MappedFile->MapRegion());
+	}
+
+	TArrayView<const uint8> Bytes;
+	if (MappedRegion)
+	{
+		Bytes = MakeArrayView(MappedRegion->GetMappedPtr(), (int32)MappedRegion->GetMappedSize());
+	}
+	else
+	{
+		MappedFile.Reset();
+		if (!FFileHelper::LoadFileToArray(FileData, *Path, FILEREAD_Silent))
+		{
+			return false;
+		}
+		Bytes = FileData;
+	}
+
+	if (!FWRReplayView::FromBytes(Bytes, View, &KartNames))
+	{
+		UE_LOG(LogWastelandRacers, Warning, TEXT("%s is not a valid replay file"), *Path);
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void FWRMappedReplay::Close()
+{
+	View = FWRReplayView();
+	KartNames.Reset();
+	MappedRegion.Reset();
+	MappedFile.Reset();
+	FileData.Empty();
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WastelandRacers/Replay/WRReplayData.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+// A saved replay opened in place. The file is memory-mapped so only the pages the decoder
+// touches are read; platforms without mapping fall back to loading the file.
+class WASTELANDRACERS_API FWRMappedReplay
+{
+public:
+	FWRMappedReplay();
+	~FWRMappedReplay();
+
+	FWRMappedReplay(const FWRMappedReplay&) = delete;
+	FWRMappedReplay& operator=(const FWRMappedReplay&) = delete;
+
+	bool Open(const FString& Path);
+	void Close();
+
+	bool IsOpen() const { return View.IsValid(); }
+	const FWRReplayView& GetView() const { return View; }
+	const TArray<FString>& GetKartNames() const { return KartNames; }
+
+private:
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	TArray<uint8> FileData;
+
+	FWRReplayView View;
+	TArray<FString> KartNames;
+};
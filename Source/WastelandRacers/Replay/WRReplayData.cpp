@@ -0,0 +1,562 @@
+#include "WRReplayData.h"
+#include "WastelandRacers/WastelandRacers.h"
+#include "Algo/UpperBound.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+
+namespace WRReplay
+{
+	static FWRReplayQuantizedKart Quantize(const FWRReplayKartState& State)
+	{
+		FWRReplayQuantizedKart Result;
+		Result.Position = FIntVector(
+			FMath::RoundToInt(State.Location.X / PositionPrecision),
+			FMath::RoundToInt(State.Location.Y / PositionPrecision),
+			FMath::RoundToInt(State.Location.Z / PositionPrecision));
+		Result.Pitch = FRotator::CompressAxisToShort(State.Rotation.Pitch);
+		Result.Yaw = FRotator::CompressAxisToShort(State.Rotation.Yaw);
+		Result.Roll = FRotator::CompressAxisToShort(State.Rotation.Roll);
+		Result.Throttle = (int8)FMath::RoundToInt(FMath::Clamp(State.Throttle, -1.0f, 1.0f) * 127.0f);
+		Result.Steering = (int8)FMath::RoundToInt(FMath::Clamp(State.Steering, -1.0f, 1.0f) * 127.0f);
+		Result.Flags = State.Flags;
+		return Result;
+	}
+
+	static FVector DequantizePosition(const FIntVector& Position)
+	{
+		return FVector(Position) * PositionPrecision;
+	}
+
+	static FRotator DequantizeRotation(const FWRReplayQuantizedKart& State)
+	{
+		return FRotator(
+			FRotator::DecompressAxisFromShort(State.Pitch),
+			FRotator::DecompressAxisFromShort(State.Yaw),
+			FRotator::DecompressAxisFromShort(State.Roll));
+	}
+
+	static void EncodeKeyKart(TArray<uint8>& Out, const FWRReplayQuantizedKart& State)
+	{
+		WriteVarInt(Out, State.Position.X);
+		WriteVarInt(Out, State.Position.Y);
+		WriteVarInt(Out, State.Position.Z);
+		WriteVarUInt(Out, State.Pitch);
+		WriteVarUInt(Out, State.Yaw);
+		WriteVarUInt(Out, State.Roll);
+		Out.Add((uint8)State.Throttle);
+		Out.Add((uint8)State.Steering);
+		Out.Add(State.Flags);
+	}
+
+	// Position is stored as the error against a constant-velocity prediction, which at
+	// racing speeds is usually a single byte per axis
+	static void EncodeDeltaKart(TArray<uint8>& Out, const FWRReplayQuantizedKart& State, const FWRReplayQuantizedKart& Last, const FIntVector& PredictorPosition)
+	{
+		const FIntVector Predicted = Last.Position * 2 - PredictorPosition;
+		WriteVarInt(Out, State.Position.X - Predicted.X);
+		WriteVarInt(Out, State.Position.Y - Predicted.Y);
+		WriteVarInt(Out, State.Position.Z - Predicted.Z);
+		WriteVarInt(Out, (int16)(State.Pitch - Last.Pitch));
+		WriteVarInt(Out, (int16)(State.Yaw - Last.Yaw));
+		WriteVarInt(Out, (int16)(State.Roll - Last.Roll));
+
+		const uint8 ChangedMask = (State.Throttle != Last.Throttle ? 1 : 0)
+			| (State.Steering != Last.Steering ? 2 : 0)
+			| (State.Flags != Last.Flags ? 4 : 0);
+		Out.Add(ChangedMask);
+		if (ChangedMask & 1)
+		{
+			Out.Add((uint8)State.Throttle);
+		}
+		if (ChangedMask & 2)
+		{
+			Out.Add((uint8)State.Steering);
+		}
+		if (ChangedMask & 4)
+		{
+			Out.Add(State.Flags);
+		}
+	}
+
+	static bool DecodeKart(bool bKeyframe, const uint8*& Cursor, const uint8* End, FWRReplayQuantizedKart& InOutState, FIntVector& InOutPredictor)
+	{
+		if (bKeyframe)
+		{
+			InOutState.Position.X = ReadVarInt(Cursor, End);
+			InOutState.Position.Y = ReadVarInt(Cursor, End);
+			InOutState.Position.Z = ReadVarInt(Cursor, End);
+			InOutState.Pitch = (uint16)ReadVarUInt(Cursor, End);
+			InOutState.Yaw = (uint16)ReadVarUInt(Cursor, End);
+			InOutState.Roll = (uint16)ReadVarUInt(Cursor, End);
+			if (Cursor + 3 > End)
+			{
+				return false;
+			}
+			InOutState.Throttle = (int8)*Cursor++;
+			InOutState.Steering = (int8)*Cursor++;
+			InOutState.Flags = *Cursor++;
+			InOutPredictor = InOutState.Position;
+			return true;
+		}
+
+		const FIntVector Last = InOutState.Position;
+		const FIntVector Predicted = Last * 2 - InOutPredictor;
+		const int32 DeltaX = ReadVarInt(Cursor, End);
+		const int32 DeltaY = ReadVarInt(Cursor, End);
+		const int32 DeltaZ = ReadVarInt(Cursor, End);
+		InOutState.Position = Predicted + FIntVector(DeltaX, DeltaY, DeltaZ);
+		InOutState.Pitch = (uint16)(InOutState.Pitch + ReadVarInt(Cursor, End));
+		InOutState.Yaw = (uint16)(InOutState.Yaw + ReadVarInt(Cursor, End));
+		InOutState.Roll = (uint16)(InOutState.Roll + ReadVarInt(Cursor, End));
+		InOutPredictor = Last;
+
+		if (Cursor >= End)
+		{
+			return false;
+		}
+		const uint8 ChangedMask = *Cursor++;
+		const int32 NumChanged = FMath::CountBits(ChangedMask & 7);
+		if (Cursor + NumChanged > End)
+		{
+			return false;
+		}
+		if (ChangedMask & 1)
+		{
+			InOutState.Throttle = (int8)*Cursor++;
+		}
+		if (ChangedMask & 2)
+		{
+			InOutState.Steering = (int8)*Cursor++;
+		}
+		if (ChangedMask & 4)
+		{
+			InOutState.Flags = *Cursor++;
+		}
+		return true;
+	}
+}
+
+bool FWRReplayView::FromBytes(TArrayView<const uint8> Bytes, FWRReplayView& OutView, TArray<FString>* OutKartNames)
+{
+	OutView = FWRReplayView();
+
+	if (Bytes.Num() < (int32)sizeof(FWRReplayFileHeader))
+	{
+		return false;
+	}
+
+	const uint8* Data = Bytes.GetData();
+	const FWRReplayFileHeader* Header = (const FWRReplayFileHeader*)Data;
+	if (Header->Magic != WRReplay::FileMagic || Header->Version != WRReplay::FileVersion
+		|| Header->NumKarts == 0 || Header->KeyframeInterval == 0 || Header->NumFrames > (uint32)MAX_int32)
+	{
+		return false;
+	}
+
+	const int64 NamesSize = (int64)Header->NumKarts * WRReplay::KartNameLength;
+	const int64 KeyframesSize = (int64)Header->NumKeyframes * sizeof(FWRReplayKeyframe);
+	const int64 EventsSize = (int64)Header->NumEvents * sizeof(FWRReplayEvent);
+	// Truncated or padded files both mean the counts in the header can't be trusted
+	if ((int64)sizeof(FWRReplayFileHeader) + NamesSize + KeyframesSize + EventsSize + Header->FrameDataSize != Bytes.Num())
+	{
+		return false;
+	}
+
+	// The recorder writes a keyframe every KeyframeInterval frames, starting with the first
+	if ((int64)Header->NumKeyframes != ((int64)Header->NumFrames + Header->KeyframeInterval - 1) / Header->KeyframeInterval)
+	{
+		return false;
+	}
+
+	int64 Offset = sizeof(FWRReplayFileHeader);
+	if (OutKartNames)
+	{
+		OutKartNames->Reset(Header->NumKarts);
+		for (uint32 i = 0; i < Header->NumKarts; i++)
+		{
+			const ANSICHAR* Name = (const ANSICHAR*)(Data + Offset + i * WRReplay::KartNameLength);
+			OutKartNames->Add(FString(FUTF8ToTCHAR(Name, FCStringAnsi::Strnlen(Name, WRReplay::KartNameLength))));
+		}
+	}
+	Offset += NamesSize;
+
+	OutView.NumKarts = Header->NumKarts;
+	OutView.NumFrames = Header->NumFrames;
+	OutView.KeyframeInterval = Header->KeyframeInterval;
+	OutView.SampleRate = Header->SampleRate;
+	OutView.Duration = Header->Duration;
+	OutView.Keyframes = MakeArrayView((const FWRReplayKeyframe*)(Data + Offset), Header->NumKeyframes);
+	Offset += KeyframesSize;
+	OutView.Events = MakeArrayView((const FWRReplayEvent*)(Data + Offset), Header->NumEvents);
+	Offset += EventsSize;
+	OutView.FrameData = MakeArrayView(Data + Offset, Header->FrameDataSize);
+
+	for (const FWRReplayKeyframe& Keyframe : OutView.Keyframes)
+	{
+		if (Keyframe.ByteOffset >= Header->FrameDataSize || Keyframe.FrameIndex < 0 || Keyframe.FrameIndex >= OutView.NumFrames)
+		{
+			OutView = FWRReplayView();
+			return false;
+		}
+	}
+	return true;
+}
+
+void FWRReplayData::Reset()
+{
+	KartNames.Reset();
+	NumFrames = 0;
+	Duration = 0.0f;
+	Keyframes.Reset();
+	Events.Reset();
+	FrameData.Reset();
+}
+
+FWRReplayView FWRReplayData::GetView() const
+{
+	FWRReplayView View;
+	View.NumKarts = KartNames.Num();
+	View.NumFrames = NumFrames;
+	View.KeyframeInterval = KeyframeInterval;
+	View.SampleRate = SampleRate;
+	View.Duration = Duration;
+	View.Keyframes = Keyframes;
+	View.Events = Events;
+	View.FrameData = FrameData;
+	return View;
+}
+
+int64 FWRReplayData::GetSerializedSize() const
+{
+	return sizeof(FWRReplayFileHeader)
+		+ (int64)KartNames.Num() * WRReplay::KartNameLength
+		+ Keyframes.Num() * sizeof(FWRReplayKeyframe)
+		+ Events.Num() * sizeof(FWRReplayEvent)
+		+ FrameData.Num();
+}
+
+bool FWRReplayData::SaveToFile(const FString& Path) const
+{
+	FWRReplayFileHeader Header;
+	Header.Magic = WRReplay::FileMagic;
+	Header.Version = WRReplay::FileVersion;
+	Header.NumKarts = KartNames.Num();
+	Header.NumFrames = NumFrames;
+	Header.NumKeyframes = Keyframes.Num();
+	Header.NumEvents = Events.Num();
+	Header.FrameDataSize = FrameData.Num();
+	Header.KeyframeInterval = KeyframeInterval;
+	Header.SampleRate = SampleRate;
+	Header.Duration = Duration;
+
+	TArray<uint8> Bytes;
+	Bytes.Reserve(GetSerializedSize());
+	Bytes.Append((const uint8*)&Header, sizeof(Header));
+
+	const int32 NamesOffset = Bytes.Num();
+	Bytes.AddZeroed(KartNames.Num() * WRReplay::KartNameLength);
+	for (int32 i = 0; i < KartNames.Num(); i++)
+	{
+		FTCHARToUTF8 Utf8Name(*KartNames[i]);
+		FMemory::Memcpy(&Bytes[NamesOffset + i * WRReplay::KartNameLength], Utf8Name.Get(), FMath::Min(Utf8Name.Length(), WRReplay::KartNameLength - 1));
+	}
+
+	Bytes.Append((const uint8*)Keyframes.GetData(), Keyframes.Num() * sizeof(FWRReplayKeyframe));
+	Bytes.Append((const uint8*)Events.GetData(), Events.Num() * sizeof(FWRReplayEvent));
+	Bytes.Append(FrameData);
+
+	return FFileHelper::SaveArrayToFile(Bytes, *Path);
+}
+
+bool FWRReplayData::LoadFromFile(const FString& Path)
+{
+	Reset();
+
+	TArray<uint8> Bytes;
+	FWRReplayView View;
+	if (!FFileHelper::LoadFileToArray(Bytes, *Path) || !FWRReplayView::FromBytes(Bytes, View, &KartNames))
+	{
+		UE_LOG(LogWastelandRacers, Warning, TEXT("Could not load replay %s"), *Path);
+		return false;
+	}
+
+	SampleRate = View.SampleRate;
+	KeyframeInterval = View.KeyframeInterval;
+	NumFrames = View.NumFrames;
+	Duration = View.Duration;
+	Keyframes.Append(View.Keyframes.GetData(), View.Keyframes.Num());
+	Events.Append(View.Events.GetData(), View.Events.Num());
+	FrameData.Append(View.FrameData.GetData(), View.FrameData.Num());
+	return true;
+}
+
+void FWRReplayRecorder::Begin(TArrayView<const FString> KartNames, float SampleRate, int32 KeyframeInterval)
+{
+	Data.Reset();
+	Data.KartNames.Append(KartNames.GetData(), KartNames.Num());
+	Data.SampleRate = SampleRate;
+	Data.KeyframeInterval = FMath::Max(1, KeyframeInterval);
+
+	// Enough for a typical 8-kart race without regrowing mid-race
+	Data.FrameData.Reserve(512 * 1024);
+	Data.Events.Reserve(1024);
+
+	LastStates.Reset();
+	LastStates.SetNum(KartNames.Num());
+	PredictorPositions.Reset();
+	PredictorPositions.SetNum(KartNames.Num());
+	LastTimeMs = 0;
+}
+
+void FWRReplayRecorder::AddFrame(float Time, TArrayView<const FWRReplayKartState> States)
+{
+	const bool bKeyframe = Data.NumFrames % Data.KeyframeInterval == 0;
+	const uint32 TimeMs = FMath::Max(LastTimeMs, (uint32)FMath::Max(0, FMath::RoundToInt(Time * 1000.0f)));
+
+	if (bKeyframe)
+	{
+		FWRReplayKeyframe& Keyframe = Data.Keyframes.AddDefaulted_GetRef();
+		Keyframe.Time = TimeMs / 1000.0f;
+		Keyframe.FrameIndex = Data.NumFrames;
+		Keyframe.ByteOffset = Data.FrameData.Num();
+		WRReplay::WriteVarUInt(Data.FrameData, TimeMs);
+	}
+	else
+	{
+		WRReplay::WriteVarUInt(Data.FrameData, TimeMs - LastTimeMs);
+	}
+
+	for (int32 k = 0; k < LastStates.Num(); k++)
+	{
+		const FWRReplayQuantizedKart State = WRReplay::Quantize(States.IsValidIndex(k) ? States[k] : FWRReplayKartState());
+		if (bKeyframe)
+		{
+			WRReplay::EncodeKeyKart(Data.FrameData, State);
+			PredictorPositions[k] = State.Position;
+		}
+		else
+		{
+			WRReplay::EncodeDeltaKart(Data.FrameData, State, LastStates[k], PredictorPositions[k]);
+			PredictorPositions[k] = LastStates[k].Position;
+		}
+		LastStates[k] = State;
+	}
+
+	LastTimeMs = TimeMs;
+	Data.NumFrames++;
+	Data.Duration = TimeMs / 1000.0f;
+}
+
+void FWRReplayRecorder::AddEvent(const FWRReplayEvent& Event)
+{
+	Data.Events.Add(Event);
+}
+
+void FWRReplayDecoder::Initialize(const FWRReplayView& InView)
+{
+	View = InView;
+	FrameA.SetNum(View.NumKarts);
+	FrameB.SetNum(View.NumKarts);
+	PredictorPositions.SetNum(View.NumKarts);
+	bHasFrame = false;
+	CurrentTime = 0.0f;
+}
+
+void FWRReplayDecoder::Reset()
+{
+	View = FWRReplayView();
+	FrameA.Reset();
+	FrameB.Reset();
+	PredictorPositions.Reset();
+	bHasFrame = false;
+}
+
+void FWRReplayDecoder::Seek(float Time)
+{
+	if (!View.IsValid())
+	{
+		return;
+	}
+
+	const int32 KeyIndex = FMath::Max(0, Algo::UpperBoundBy(View.Keyframes, Time, &FWRReplayKeyframe::Time) - 1);
+	const FWRReplayKeyframe& Keyframe = View.Keyframes[KeyIndex];
+	NextFrame = Keyframe.FrameIndex;
+	ReadOffset = Keyframe.ByteOffset;
+	DecodeNextFrame();
+
+	// Nothing earlier to blend from until the next frame is decoded
+	FMemory::Memcpy(FrameA.GetData(), FrameB.GetData(), FrameB.Num() * sizeof(FWRReplayQuantizedKart));
+	TimeA = TimeB;
+	bHasFrame = true;
+
+	AdvanceDecodedFrames(Time);
+}
+
+void FWRReplayDecoder::AdvanceTo(float Time)
+{
+	if (!View.IsValid())
+	{
+		return;
+	}
+
+	if (!bHasFrame || Time < TimeA)
+	{
+		Seek(Time);
+		return;
+	}
+
+	// Jumping past the next keyframe is cheaper through the index than decoding every frame in between
+	const int32 NextKeyIndex = FMath::DivideAndRoundUp(NextFrame, View.KeyframeInterval);
+	if (View.Keyframes.IsValidIndex(NextKeyIndex) && View.Keyframes[NextKeyIndex].Time <= Time)
+	{
+		Seek(Time);
+		return;
+	}
+
+	AdvanceDecodedFrames(Time);
+}
+
+void FWRReplayDecoder::AdvanceDecodedFrames(float Time)
+{
+	while (Time >= TimeB && DecodeNextFrame())
+	{
+	}
+
+	CurrentTime = Time;
+	Alpha = TimeB > TimeA ? FMath::Clamp((Time - TimeA) / (TimeB - TimeA), 0.0f, 1.0f) : 1.0f;
+}
+
+bool FWRReplayDecoder::DecodeNextFrame()
+{
+	if (NextFrame >= View.NumFrames)
+	{
+		return false;
+	}
+
+	const uint8* Start = View.FrameData.GetData();
+	const uint8* End = Start + View.FrameData.Num();
+	const uint8* Cursor = Start + ReadOffset;
+
+	const bool bKeyframe = NextFrame % View.KeyframeInterval == 0;
+	const uint32 TimeValue = WRReplay::ReadVarUInt(Cursor, End);
+
+	// The newest frame becomes the blend source and the base for the deltas
+	Swap(FrameA, FrameB);
+	TimeA = TimeB;
+	TimeMsB = bKeyframe ? TimeValue : TimeMsB + TimeValue;
+	TimeB = TimeMsB / 1000.0f;
+
+	for (int32 k = 0; k < View.NumKarts; k++)
+	{
+		FrameB[k] = FrameA[k];
+		if (!WRReplay::DecodeKart(bKeyframe, Cursor, End, FrameB[k], PredictorPositions[k]))
+		{
+			UE_LOG(LogWastelandRacers, Warning, TEXT("Replay frame %d is truncated"), NextFrame);
+			NextFrame = View.NumFrames;
+			return false;
+		}
+	}
+
+	ReadOffset = Cursor - Start;
+	NextFrame++;
+	return true;
+}
+
+void FWRReplayDecoder::GetKartState(int32 KartIndex, FWRReplayKartState& OutState) const
+{
+	if (!bHasFrame || !FrameA.IsValidIndex(KartIndex))
+	{
+		OutState = FWRReplayKartState();
+		return;
+	}
+
+	const FWRReplayQuantizedKart& A = FrameA[KartIndex];
+	const FWRReplayQuantizedKart& B = FrameB[KartIndex];
+
+	OutState.Location = FMath::Lerp(WRReplay::DequantizePosition(A.Position), WRReplay::DequantizePosition(B.Position), (double)Alpha);
+	OutState.Rotation = FQuat::Slerp(FQuat(WRReplay::DequantizeRotation(A)), FQuat(WRReplay::DequantizeRotation(B)), Alpha).Rotator();
+	OutState.Throttle = FMath::Lerp((float)A.Throttle, (float)B.Throttle, Alpha) / 127.0f;
+	OutState.Steering = FMath::Lerp((float)A.Steering, (float)B.Steering, Alpha) / 127.0f;
+	OutState.Flags = Alpha < 0.5f ? A.Flags : B.Flags;
+}
+
+#if !UE_BUILD_SHIPPING
+static FAutoConsoleCommand BenchReplayCommand(
+	TEXT("wr.Bench.Replay"),
+	TEXT("Records a synthetic 3-lap, 8-kart replay and reports its size, seek cost and reconstruction error"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		const int32 NumKarts = 8;
+		const float SampleRate = 30.0f;
+		const float TrackRadius = 20000.0f;
+		const float RaceSeconds = 180.0f;
+		const int32 NumFrames = FMath::CeilToInt(RaceSeconds * SampleRate);
+
+		TArray<FString> Names;
+		TArray<float> Speeds;
+		FRandomStream Random(42);
+		for (int32 k = 0; k < NumKarts; k++)
+		{
+			Names.Add(FString::Printf(TEXT("BenchKart_%d"), k));
+			Speeds.Add(Random.FRandRange(2100.0f, 2400.0f));
+		}
+
+		// Karts circling a 1.25 km lap with some weaving, roughly three laps in three minutes
+		TArray<FWRReplayKartState> Source;
+		Source.SetNum(NumFrames * NumKarts);
+		for (int32 Frame = 0; Frame < NumFrames; Frame++)
+		{
+			const float Time = Frame / SampleRate;
+			for (int32 k = 0; k < NumKarts; k++)
+			{
+				const float Angle = Speeds[k] * Time / TrackRadius;
+				const float Radius = TrackRadius + 300.0f * FMath::Sin(Time * 0.7f + k) + Random.FRandRange(-2.0f, 2.0f);
+
+				FWRReplayKartState& State = Source[Frame * NumKarts + k];
+				State.Location = FVector(Radius * FMath::Cos(Angle), Radius * FMath::Sin(Angle), 50.0f * FMath::Sin(Angle * 3.0f));
+				State.Rotation = FRotator(0.0f, FMath::RadiansToDegrees(Angle) + 90.0f, 0.0f);
+				State.Throttle = Random.FRandRange(0.7f, 1.0f);
+				State.Steering = FMath::Sin(Time * 0.7f + k) * 0.3f;
+			}
+		}
+
+		FWRReplayRecorder Recorder;
+		Recorder.Begin(Names, SampleRate, 60);
+		for (int32 Frame = 0; Frame < NumFrames; Frame++)
+		{
+			Recorder.AddFrame(Frame / SampleRate, MakeArrayView(&Source[Frame * NumKarts], NumKarts));
+		}
+
+		const FWRReplayData& Data = Recorder.GetData();
+		const int64 Size = Data.GetSerializedSize();
+
+		FWRReplayDecoder Decoder;
+		Decoder.Initialize(Data.GetView());
+
+		const int32 NumSeeks = 1000;
+		double MaxError = 0.0;
+		uint64 SeekCycles = 0;
+		for (int32 i = 0; i < NumSeeks; i++)
+		{
+			const int32 Frame = Random.RandRange(0, NumFrames - 1);
+			const uint64 Start = FPlatformTime::Cycles64();
+			Decoder.Seek(Frame / SampleRate);
+			SeekCycles += FPlatformTime::Cycles64() - Start;
+
+			for (int32 k = 0; k < NumKarts; k++)
+			{
+				FWRReplayKartState State;
+				Decoder.GetKartState(k, State);
+				MaxError = FMath::Max(MaxError, FVector::Dist(State.Location, Source[Frame * NumKarts + k].Location));
+			}
+		}
+
+		UE_LOG(LogWastelandRacers, Display, TEXT("Replay: %d frames, %d karts, %.1f KB (%.2f bytes per kart-frame), %s 1 MB budget"),
+			NumFrames, NumKarts, Size / 1024.0, (double)Data.FrameData.Num() / (NumFrames * NumKarts),
+			Size < 1024 * 1024 ? TEXT("within") : TEXT("OVER"));
+		UE_LOG(LogWastelandRacers, Display, TEXT("Replay: %.2f us per seek, max position error %.2f cm"),
+			FPlatformTime::ToMilliseconds64(SeekCycles) * 1000.0 / NumSeeks, MaxError);
+	}));
+#endif
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WastelandRacers/Replay/WRReplayTypes.h"
+
+// Non-owning view of replay data. Can point at an FWRReplayData or straight into a
+// serialized replay, e.g. a memory-mapped file.
+struct WASTELANDRACERS_API FWRReplayView
+{
+	int32 NumKarts = 0;
+	int32 NumFrames = 0;
+	int32 KeyframeInterval = 0;
+	float SampleRate = 0.0f;
+	float Duration = 0.0f;
+	TArrayView<const FWRReplayKeyframe> Keyframes;
+	TArrayView<const FWRReplayEvent> Events;
+	TArrayView<const uint8> FrameData;
+
+	bool IsValid() const { return NumKarts > 0 && KeyframeInterval > 0 && Keyframes.Num() > 0; }
+
+	static bool FromBytes(TArrayView<const uint8> Bytes, FWRReplayView& OutView, TArray<FString>* OutKartNames = nullptr);
+};
+
+// Recorded race. Frames are stored as a byte stream: every KeyframeInterval frames a full
+// snapshot, in between per-kart deltas against a constant-velocity prediction.
+class WASTELANDRACERS_API FWRReplayData
+{
+public:
+	TArray<FString> KartNames;
+	float SampleRate = 30.0f;
+	int32 KeyframeInterval = 60;
+	int32 NumFrames = 0;
+	float Duration = 0.0f;
+
+	TArray<FWRReplayKeyframe> Keyframes;
+	TArray<FWRReplayEvent> Events;
+	TArray<uint8> FrameData;
+
+	void Reset();
+	FWRReplayView GetView() const;
+	int64 GetSerializedSize() const;
+
+	bool SaveToFile(const FString& Path) const;
+	bool LoadFromFile(const FString& Path);
+};
+
+// Quantized kart state as stored in the frame stream
+struct FWRReplayQuantizedKart
+{
+	FIntVector Position = FIntVector::ZeroValue;
+	uint16 Pitch = 0;
+	uint16 Yaw = 0;
+	uint16 Roll = 0;
+	int8 Throttle = 0;
+	int8 Steering = 0;
+	uint8 Flags = 0;
+};
+
+// Appends frames and events to an FWRReplayData
+class WASTELANDRACERS_API FWRReplayRecorder
+{
+public:
+	void Begin(TArrayView<const FString> KartNames, float SampleRate, int32 KeyframeInterval);
+	void AddFrame(float Time, TArrayView<const FWRReplayKartState> States);
+	void AddEvent(const FWRReplayEvent& Event);
+
+	const FWRReplayData& GetData() const { return Data; }
+
+private:
+	FWRReplayData Data;
+	TArray<FWRReplayQuantizedKart> LastStates;
+	TArray<FIntVector> PredictorPositions;
+	uint32 LastTimeMs = 0;
+};
+
+// Reconstructs interpolated kart states from a replay view.
+// Seeking binary-searches the keyframe index and decodes at most KeyframeInterval frames;
+// advancing forward during playback only decodes the frames that were passed.
+class WASTELANDRACERS_API FWRReplayDecoder
+{
+public:
+	void Initialize(const FWRReplayView& InView);
+	void Reset();
+
+	void Seek(float Time);
+	void AdvanceTo(float Time);
+
+	bool IsValid() const { return View.IsValid(); }
+	float GetTime() const { return CurrentTime; }
+	const FWRReplayView& GetView() const { return View; }
+
+	// Interpolated state at the last Seek/AdvanceTo time
+	void GetKartState(int32 KartIndex, FWRReplayKartState& OutState) const;
+
+private:
+	FWRReplayView View;
+
+	int32 NextFrame = 0;
+	int32 ReadOffset = 0;
+	uint32 TimeMsB = 0;
+	float TimeA = 0.0f;
+	float TimeB = 0.0f;
+	float CurrentTime = 0.0f;
+	float Alpha = 0.0f;
+	bool bHasFrame = false;
+
+	// Decoded frames either side of CurrentTime
+	TArray<FWRReplayQuantizedKart> FrameA;
+	TArray<FWRReplayQuantizedKart> FrameB;
+	TArray<FIntVector> PredictorPositions;
+
+	bool DecodeNextFrame();
+	void AdvanceDecodedFrames(float Time);
+};
@@ -0,0 +1,308 @@
+#include "WRReplaySubsystem.h"
+#include "WastelandRacers/WastelandRacers.h"
+#include "WastelandRacers/Vehicles/WRKart.h"
+#include "WastelandRacers/Gameplay/WRRaceManager.h"
+#include "WastelandRacers/AI/WRAIDrivingSubsystem.h"
+#include "Algo/UpperBound.h"
+#include "ChaosVehicleMovementComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Controller.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarRecordReplay(
+	TEXT("wr.Replay.Record"),
+	1,
+	TEXT("1 = record a replay of every race."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarReplaySampleRate(
+	TEXT("wr.Replay.SampleRate"),
+	30.0f,
+	TEXT("Replay frames recorded per second. Playback interpolates between frames."),
+	ECVF_Default);
+
+UWRReplaySubsystem* UWRReplaySubsystem::GetInstance(const UObject* WorldContext)
+{
+	if (const UWorld* World = GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::ReturnNull))
+	{
+		return World->GetSubsystem<UWRReplaySubsystem>();
+	}
+	return nullptr;
+}
+
+void UWRReplaySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Pickups and hazards reach the replay through the race event queue
+	if (UWRRaceWorldSubsystem* RaceWorld = Collection.InitializeDependency<UWRRaceWorldSubsystem>())
+	{
+		RaceEventsHandle = RaceWorld->OnRaceEvents.AddUObject(this, &UWRReplaySubsystem::HandleRaceEvents);
+	}
+}
+
+void UWRReplaySubsystem::Deinitialize()
+{
+	StopPlayback();
+	bRecording = false;
+	Karts.Empty();
+
+	if (UWRRaceWorldSubsystem* RaceWorld = UWRRaceWorldSubsystem::GetInstance(this))
+	{
+		RaceWorld->OnRaceEvents.Remove(RaceEventsHandle);
+	}
+
+	Super::Deinitialize();
+}
+
+void UWRReplaySubsystem::Tick(float DeltaTime)
+{
+	if (bRecording)
+	{
+		RecordTime += DeltaTime;
+		SampleAccumulator += DeltaTime;
+		if (SampleAccumulator + KINDA_SMALL_NUMBER >= SampleInterval)
+		{
+			SampleAccumulator = FMath::Clamp(SampleAccumulator - SampleInterval, 0.0f, SampleInterval);
+			SampleKarts();
+		}
+	}
+	else if (bPlaying)
+	{
+		PlaybackTime = FMath::Clamp(PlaybackTime + DeltaTime * PlaybackRate, 0.0f, GetReplayDuration());
+		ApplyPlayback(true);
+	}
+}
+
+TStatId UWRReplaySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UWRReplaySubsystem, STATGROUP_Tickables);
+}
+
+void UWRReplaySubsystem::StartRecording(const TArray<AWRKart*>& InKarts)
+{
+	StopPlayback();
+
+	if (CVarRecordReplay.GetValueOnGameThread() == 0 || InKarts.Num() == 0)
+	{
+		return;
+	}
+
+	Karts = InKarts;
+
+	TArray<FString> KartNames;
+	for (const AWRKart* Kart : Karts)
+	{
+		KartNames.Add(Kart ? Kart->GetName() : TEXT("None"));
+	}
+
+	// A full snapshot every two seconds bounds the decode work of any seek
+	const float SampleRate = FMath::Max(1.0f, CVarReplaySampleRate.GetValueOnGameThread());
+	Recorder.Begin(KartNames, SampleRate, FMath::CeilToInt(SampleRate * 2.0f));
+
+	KartStates.SetNum(Karts.Num());
+	RecordTime = 0.0f;
+	SampleInterval = 1.0f / SampleRate;
+	SampleAccumulator = 0.0f;
+	bRecording = true;
+
+	SampleKarts();
+}
+
+void UWRReplaySubsystem::StopRecording()
+{
+	if (!bRecording)
+	{
+		return;
+	}
+
+	SampleKarts();
+	bRecording = false;
+
+	const FWRReplayData& Data = Recorder.GetData();
+	UE_LOG(LogWastelandRacers, Log, TEXT("Replay recorded: %d frames, %d events, %.1f KB"),
+		Data.NumFrames, Data.Events.Num(), Data.GetSerializedSize() / 1024.0);
+}
+
+void UWRReplaySubsystem::RecordEvent(EWRReplayEventType Type, const AActor* Instigator, int32 Payload, const FVector& Location)
+{
+	if (!bRecording)
+	{
+		return;
+	}
+
+	FWRReplayEvent Event;
+	Event.Time = RecordTime;
+	Event.Type = Type;
+	Event.KartIndex = (int16)Karts.IndexOfByPredicate([Instigator](const AWRKart* Kart) { return Kart && Kart == Instigator; });
+	Event.Payload = Payload;
+	Event.Location = FVector3f(Location);
+	Recorder.AddEvent(Event);
+}
+
+void UWRReplaySubsystem::HandleRaceEvents(TArrayView<const FWRRaceEvent> Events)
+{
+	if (!bRecording)
+	{
+		return;
+	}
+
+	for (const FWRRaceEvent& Event : Events)
+	{
+		switch (Event.Type)
+		{
+			case EWRRaceEventType::PowerUpCollected:
+				RecordEvent(EWRReplayEventType::PowerUpCollected, Event.Kart.Get(), Event.Payload, Event.Location);
+				break;
+
+			case EWRRaceEventType::HazardActivated:
+				RecordEvent(EWRReplayEventType::HazardActivated, nullptr, Event.Payload, Event.Location);
+				break;
+
+			default:
+				break;
+		}
+	}
+}
+
+bool UWRReplaySubsystem::StartPlayback()
+{
+	StopRecording();
+
+	if (Recorder.GetData().NumFrames == 0)
+	{
+		return false;
+	}
+
+	Decoder.Initialize(Recorder.GetData().GetView());
+	SetKartsSimulated(false);
+	SetRaceSystemsSuspended(true);
+	bPlaying = true;
+
+	SeekPlayback(0.0f);
+	return true;
+}
+
+void UWRReplaySubsystem::StopPlayback()
+{
+	if (!bPlaying)
+	{
+		return;
+	}
+
+	bPlaying = false;
+	Decoder.Reset();
+	SetKartsSimulated(true);
+	SetRaceSystemsSuspended(false);
+}
+
+void UWRReplaySubsystem::SeekPlayback(float Time)
+{
+	if (!bPlaying)
+	{
+		return;
+	}
+
+	PlaybackTime = FMath::Clamp(Time, 0.0f, GetReplayDuration());
+	Decoder.Seek(PlaybackTime);
+
+	// Events before the seek point are treated as already played
+	NextEventIndex = Algo::UpperBoundBy(Recorder.GetData().Events, PlaybackTime, &FWRReplayEvent::Time);
+	ApplyPlayback(false);
+}
+
+bool UWRReplaySubsystem::SaveReplay(const FString& Path) const
+{
+	return Recorder.GetData().NumFrames > 0 && Recorder.GetData().SaveToFile(Path);
+}
+
+void UWRReplaySubsystem::SampleKarts()
+{
+	for (int32 k = 0; k < Karts.Num(); k++)
+	{
+		const AWRKart* Kart = Karts[k];
+		FWRReplayKartState& State = KartStates[k];
+		if (!Kart)
+		{
+			continue;
+		}
+
+		State.Location = Kart->GetActorLocation();
+		State.Rotation = Kart->GetActorRotation();
+		State.Throttle = Kart->GetThrottleInput();
+		State.Steering = Kart->GetSteeringInput();
+		State.Flags = (Kart->IsBoosting() ? WRReplay::Flag_Boosting : 0)
+			| (Kart->IsDrifting() ? WRReplay::Flag_Drifting : 0);
+	}
+
+	Recorder.AddFrame(RecordTime, KartStates);
+}
+
+void UWRReplaySubsystem::ApplyPlayback(bool bFireEvents)
+{
+	Decoder.AdvanceTo(PlaybackTime);
+
+	FWRReplayKartState State;
+	for (int32 k = 0; k < Karts.Num(); k++)
+	{
+		if (AWRKart* Kart = Karts[k])
+		{
+			Decoder.GetKartState(k, State);
+			Kart->SetActorLocationAndRotation(State.Location, State.Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+		}
+	}
+
+	if (bFireEvents)
+	{
+		const TArray<FWRReplayEvent>& Events = Recorder.GetData().Events;
+		while (Events.IsValidIndex(NextEventIndex) && Events[NextEventIndex].Time <= PlaybackTime)
+		{
+			OnReplayEvent.Broadcast(Events[NextEventIndex++]);
+		}
+	}
+}
+
+void UWRReplaySubsystem::SetKartsSimulated(bool bSimulated)
+{
+	for (AWRKart* Kart : Karts)
+	{
+		if (!Kart)
+		{
+			continue;
+		}
+
+		Kart->SetActorTickEnabled(bSimulated);
+
+		if (UChaosVehicleMovementComponent* Movement = Kart->GetVehicleMovementComponent())
+		{
+			Movement->SetComponentTickEnabled(bSimulated);
+		}
+
+		if (USkeletalMeshComponent* Mesh = Kart->GetMesh())
+		{
+			Mesh->SetSimulatePhysics(bSimulated);
+		}
+
+		if (AController* Controller = Kart->GetController())
+		{
+			Controller->SetActorTickEnabled(bSimulated);
+		}
+	}
+}
+
+void UWRReplaySubsystem::SetRaceSystemsSuspended(bool bSuspended)
+{
+	// Otherwise AI inputs, rubber-band torque and the race step keep acting on the posed karts
+	if (UWRAIDrivingSubsystem* AIDriving = UWRAIDrivingSubsystem::GetInstance(this))
+	{
+		AIDriving->SetSuspended(bSuspended);
+	}
+
+	const UWRRaceWorldSubsystem* RaceWorld = UWRRaceWorldSubsystem::GetInstance(this);
+	if (AWRRaceManager* RaceManager = RaceWorld ? RaceWorld->GetRaceManager() : nullptr)
+	{
+		RaceManager->SetSuspended(bSuspended);
+	}
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WastelandRacers/Replay/WRReplayData.h"
+#include "WastelandRacers/Gameplay/WRRaceWorldSubsystem.h"
+#include "WRReplaySubsystem.generated.h"
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnReplayEvent, const FWRReplayEvent&);
+
+// Records the race karts and gameplay events, and plays them back in the same world.
+// During playback the karts are posed from the replay; Chaos physics, kart ticks, their
+// controllers, AI driving and the race manager's step are switched off until playback stops.
+UCLASS()
+class WASTELANDRACERS_API UWRReplaySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UWRReplaySubsystem* GetInstance(const UObject* WorldContext);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Recording
+	UFUNCTION(BlueprintCallable, Category = "Replay")
+	void StartRecording(const TArray<class AWRKart*>& InKarts);
+
+	UFUNCTION(BlueprintCallable, Category = "Replay")
+	void StopRecording();
+
+	UFUNCTION(BlueprintPure, Category = "Replay")
+	bool IsRecording() const { return bRecording; }
+
+	void RecordEvent(EWRReplayEventType Type, const AActor* Instigator, int32 Payload, const FVector& Location);
+
+	// Playback
+	UFUNCTION(BlueprintCallable, Category = "Replay")
+	bool StartPlayback();
+
+	UFUNCTION(BlueprintCallable, Category = "Replay")
+	void StopPlayback();
+
+	UFUNCTION(BlueprintCallable, Category = "Replay")
+	void SeekPlayback(float Time);
+
+	UFUNCTION(BlueprintCallable, Category = "Replay")
+	void SetPlaybackRate(float Rate) { PlaybackRate = Rate; }
+
+	UFUNCTION(BlueprintPure, Category = "Replay")
+	bool IsPlaying() const { return bPlaying; }
+
+	UFUNCTION(BlueprintPure, Category = "Replay")
+	float GetPlaybackTime() const { return PlaybackTime; }
+
+	UFUNCTION(BlueprintPure, Category = "Replay")
+	float GetReplayDuration() const { return Recorder.GetData().Duration; }
+
+	UFUNCTION(BlueprintCallable, Category = "Replay")
+	bool SaveReplay(const FString& Path) const;
+
+	const FWRReplayData& GetReplayData() const { return Recorder.GetData(); }
+
+	// Fired during playback as recorded events are reached, for effects and sounds
+	FOnReplayEvent OnReplayEvent;
+
+private:
+	UPROPERTY()
+	TArray<class AWRKart*> Karts;
+
+	FWRReplayRecorder Recorder;
+	FWRReplayDecoder Decoder;
+	TArray<FWRReplayKartState> KartStates;
+
+	bool bRecording = false;
+	bool bPlaying = false;
+	float RecordTime = 0.0f;
+	float SampleInterval = 0.0f;
+	float SampleAccumulator = 0.0f;
+	float PlaybackTime = 0.0f;
+	float PlaybackRate = 1.0f;
+	int32 NextEventIndex = 0;
+
+	FDelegateHandle RaceEventsHandle;
+
+	void SampleKarts();
+	void HandleRaceEvents(TArrayView<const FWRRaceEvent> Events);
+	void ApplyPlayback(bool bFireEvents);
+	void SetKartsSimulated(bool bSimulated);
+	void SetRaceSystemsSuspended(bool bSuspended);
+};
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+enum class EWRReplayEventType : uint8
+{
+	WeaponFired,
+	PowerUpCollected,
+	HazardActivated,
+	SectorCrossed
+};
+
+// Decoded state of one kart at one point in time
+struct FWRReplayKartState
+{
+	FVector Location = FVector::ZeroVector;
+	FRotator Rotation = FRotator::ZeroRotator;
+	float Throttle = 0.0f;
+	float Steering = 0.0f;
+	uint8 Flags = 0;
+};
+
+// Fixed-size layout so events can be read straight out of a saved replay
+struct FWRReplayEvent
+{
+	float Time = 0.0f;
+	EWRReplayEventType Type = EWRReplayEventType::WeaponFired;
+	uint8 Reserved = 0;
+
+	// Index into the replay's kart list, or INDEX_NONE for world events such as hazards
+	int16 KartIndex = INDEX_NONE;
+
+	// Weapon type, power-up type, hazard type or sector index depending on Type
+	int32 Payload = 0;
+	FVector3f Location = FVector3f::ZeroVector;
+};
+
+struct FWRReplayKeyframe
+{
+	float Time = 0.0f;
+	int32 FrameIndex = 0;
+	uint32 ByteOffset = 0;
+	uint32 Reserved = 0;
+};
+
+struct FWRReplayFileHeader
+{
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	uint32 NumKarts = 0;
+	uint32 NumFrames = 0;
+	uint32 NumKeyframes = 0;
+	uint32 NumEvents = 0;
+	uint32 FrameDataSize = 0;
+	uint32 KeyframeInterval = 0;
+	float SampleRate = 0.0f;
+	float Duration = 0.0f;
+	uint32 Reserved[2] = {};
+};
+
+static_assert(sizeof(FWRReplayEvent) == 24, "Replay event layout changed");
+static_assert(sizeof(FWRReplayKeyframe) == 16, "Replay keyframe layout changed");
+static_assert(sizeof(FWRReplayFileHeader) == 48, "Replay header layout changed");
+
+namespace WRReplay
+{
+	static constexpr uint32 FileMagic = 0x50525257;	// "WRRP"
+	static constexpr uint32 FileVersion = 1;
+	static constexpr int32 KartNameLength = 32;
+
+	// Positions are stored in whole centimetres
+	static constexpr float PositionPrecision = 1.0f;
+
+	enum EKartFlags : uint8
+	{
+		Flag_Boosting = 1 << 0,
+		Flag_Drifting = 1 << 1,
+	};
+
+	static_assert(PLATFORM_LITTLE_ENDIAN, "Replay files are written straight from memory and must be little-endian");
+
+	inline uint32 ZigZag(int32 Value)
+	{
+		return ((uint32)Value << 1) ^ (uint32)(Value >> 31);
+	}
+
+	inline int32 UnZigZag(uint32 Value)
+	{
+		return (int32)(Value >> 1) ^ -(int32)(Value & 1);
+	}
+
+	inline void WriteVarUInt(TArray<uint8>& Out, uint32 Value)
+	{
+		while (Value >= 0x80)
+		{
+			Out.Add((uint8)(Value | 0x80));
+			Value >>= 7;
+		}
+		Out.Add((uint8)Value);
+	}
+
+	inline void WriteVarInt(TArray<uint8>& Out, int32 Value)
+	{
+		WriteVarUInt(Out, ZigZag(Value));
+	}
+
+	inline uint32 ReadVarUInt(const uint8*& Cursor, const uint8* End)
+	{
+		uint32 Value = 0;
+		int32 Shift = 0;
+		while (Cursor < End && Shift < 35)
+		{
+			const uint8 Byte = *Cursor++;
+			Value |= (uint32)(Byte & 0x7F) << Shift;
+			if ((Byte & 0x80) == 0)
+			{
+				break;
+			}
+			Shift += 7;
+		}
+		return Value;
+	}
+
+	inline int32 ReadVarInt(const uint8*& Cursor, const uint8* End)
+	{
+		return UnZigZag(ReadVarUInt(Cursor, End));
+	}
+}
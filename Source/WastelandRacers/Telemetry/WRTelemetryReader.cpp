@@ -0,0 +1,181 @@
+#include "WRTelemetryReader.h"
+#include "WastelandRacers/WastelandRacers.h"
+#include "Algo/UpperBound.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+
+FWRTelemetryReader::FWRTelemetryReader() = default;
+
+FWRTelemetryReader::~FWRTelemetryReader()
+{
+	Close();
+}
+
+bool FWRTelemetryReader::Open(const FString& Path)
+{
+	Close();
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	IPlatformFile::FOpenMappedResult MappedResult = PlatformFile.OpenMappedEx(*Path);
+	if (MappedResult.HasValue())
+	{
+		MappedFile = MappedResult.StealValue();
+		MappedRegion.Reset(MappedFile->MapRegion());
+	}
+
+	if (MappedRegion)
+	{
+		Data = MappedRegion->GetMappedPtr();
+		DataSize = MappedRegion->GetMappedSize();
+	}
+	else
+	{
+		// Platforms without file mapping fall back to a single read
+		MappedFile.Reset();
+		if (!FFileHelper::LoadFileToArray(FileData, *Path))
+		{
+			UE_LOG(LogWastelandRacers, Warning, TEXT("Could not open telemetry file %s"), *Path);
+			return false;
+		}
+		Data = FileData.GetData();
+		DataSize = FileData.Num();
+	}
+
+	if (!ParseFile())
+	{
+		UE_LOG(LogWastelandRacers, Warning, TEXT("%s is not a valid telemetry file"), *Path);
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void FWRTelemetryReader::Close()
+{
+	MappedRegion.Reset();
+	MappedFile.Reset();
+	FileData.Empty();
+	Data = nullptr;
+	DataSize = 0;
+	NumKarts = 0;
+	NumFrames = 0;
+	SampleRate = 0.0f;
+	KartNames.Empty();
+	Chunks.Empty();
+}
+
+bool FWRTelemetryReader::ParseFile()
+{
+	if (DataSize < (int64)sizeof(FWRTelemetryFileHeader))
+	{
+		return false;
+	}
+
+	const FWRTelemetryFileHeader* Header = (const FWRTelemetryFileHeader*)Data;
+	if (Header->Magic != WRTelemetry::FileMagic || Header->Version != WRTelemetry::FileVersion || Header->NumKarts == 0)
+	{
+		return false;
+	}
+
+	NumKarts = Header->NumKarts;
+	SampleRate = Header->SampleRate;
+
+	int64 Offset = sizeof(FWRTelemetryFileHeader);
+	const int64 NamesSize = (int64)NumKarts * WRTelemetry::KartNameLength;
+	if (Offset + NamesSize > DataSize)
+	{
+		return false;
+	}
+
+	KartNames.Reserve(NumKarts);
+	for (int32 i = 0; i < NumKarts; i++)
+	{
+		const ANSICHAR* Name = (const ANSICHAR*)(Data + Offset + i * WRTelemetry::KartNameLength);
+		KartNames.Add(FString(FUTF8ToTCHAR(Name, FCStringAnsi::Strnlen(Name, WRTelemetry::KartNameLength))));
+	}
+	Offset += NamesSize;
+
+	while (Offset + (int64)sizeof(FWRTelemetryChunkHeader) <= DataSize)
+	{
+		const FWRTelemetryChunkHeader* ChunkHeader = (const FWRTelemetryChunkHeader*)(Data + Offset);
+		if (ChunkHeader->Magic != WRTelemetry::ChunkMagic || (int32)ChunkHeader->NumKarts != NumKarts)
+		{
+			break;
+		}
+
+		const int32 ChunkFrames = ChunkHeader->NumFrames;
+		const int64 ChunkSize = WRTelemetry::GetChunkDataSize(ChunkFrames, NumKarts);
+		Offset += sizeof(FWRTelemetryChunkHeader);
+		if (Offset + ChunkSize > DataSize)
+		{
+			// Recording was interrupted mid-write
+			break;
+		}
+
+		const int64 NumSamples = (int64)ChunkFrames * NumKarts;
+		const uint8* Cursor = Data + Offset;
+		auto Take = [&Cursor](int64 Bytes)
+		{
+			const uint8* Result = Cursor;
+			Cursor += Bytes;
+			return Result;
+		};
+
+		FWRTelemetryChunkView& Chunk = Chunks.AddDefaulted_GetRef();
+		Chunk.FirstFrame = NumFrames;
+		Chunk.NumFrames = ChunkFrames;
+		Chunk.Times = (const float*)Take(ChunkFrames * sizeof(float));
+		Chunk.Locations = (const FVector3f*)Take(NumSamples * sizeof(FVector3f));
+		Chunk.Velocities = (const FVector3f*)Take(NumSamples * sizeof(FVector3f));
+		Chunk.Throttles = (const float*)Take(NumSamples * sizeof(float));
+		Chunk.Steerings = (const float*)Take(NumSamples * sizeof(float));
+		Chunk.BoostEnergies = (const float*)Take(NumSamples * sizeof(float));
+		Chunk.Healths = (const float*)Take(NumSamples * sizeof(float));
+		Chunk.Progresses = (const float*)Take(NumSamples * sizeof(float));
+		Chunk.Laps = (const int32*)Take(NumSamples * sizeof(int32));
+
+		NumFrames += ChunkFrames;
+		Offset += ChunkSize;
+	}
+
+	return true;
+}
+
+const FWRTelemetryChunkView* FWRTelemetryReader::FindChunk(int32 Frame) const
+{
+	if (Frame < 0 || Frame >= NumFrames)
+	{
+		return nullptr;
+	}
+
+	const int32 Index = Algo::UpperBoundBy(Chunks, Frame, &FWRTelemetryChunkView::FirstFrame) - 1;
+	return Chunks.IsValidIndex(Index) ? &Chunks[Index] : nullptr;
+}
+
+float FWRTelemetryReader::GetFrameTime(int32 Frame) const
+{
+	const FWRTelemetryChunkView* Chunk = FindChunk(Frame);
+	return Chunk ? Chunk->Times[Frame - Chunk->FirstFrame] : 0.0f;
+}
+
+bool FWRTelemetryReader::GetSample(int32 Frame, int32 KartIndex, FWRTelemetrySample& OutSample) const
+{
+	const FWRTelemetryChunkView* Chunk = FindChunk(Frame);
+	if (!Chunk || KartIndex < 0 || KartIndex >= NumKarts)
+	{
+		return false;
+	}
+
+	const int64 Index = (int64)(Frame - Chunk->FirstFrame) * NumKarts + KartIndex;
+	OutSample.Location = Chunk->Locations[Index];
+	OutSample.Velocity = Chunk->Velocities[Index];
+	OutSample.Throttle = Chunk->Throttles[Index];
+	OutSample.Steering = Chunk->Steerings[Index];
+	OutSample.BoostEnergy = Chunk->BoostEnergies[Index];
+	OutSample.Health = Chunk->Healths[Index];
+	OutSample.Progress = Chunk->Progresses[Index];
+	OutSample.Lap = Chunk->Laps[Index];
+	return true;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WastelandRacers/Telemetry/WRTelemetryTypes.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+// Pointers into one chunk of a telemetry file, laid out as described in WRTelemetryTypes.h
+struct FWRTelemetryChunkView
+{
+	int32 FirstFrame = 0;
+	int32 NumFrames = 0;
+	const float* Times = nullptr;
+	const FVector3f* Locations = nullptr;
+	const FVector3f* Velocities = nullptr;
+	const float* Throttles = nullptr;
+	const float* Steerings = nullptr;
+	const float* BoostEnergies = nullptr;
+	const float* Healths = nullptr;
+	const float* Progresses = nullptr;
+	const int32* Laps = nullptr;
+};
+
+// Reads telemetry files written by FWRTelemetryRecorder. The file is memory-mapped where
+// the platform supports it and read in place; a truncated final chunk is ignored.
+class WASTELANDRACERS_API FWRTelemetryReader
+{
+public:
+	FWRTelemetryReader();
+	~FWRTelemetryReader();
+
+	bool Open(const FString& Path);
+	void Close();
+
+	bool IsOpen() const { return Data != nullptr; }
+	int32 GetNumKarts() const { return NumKarts; }
+	int32 GetNumFrames() const { return NumFrames; }
+	float GetSampleRate() const { return SampleRate; }
+	const FString& GetKartName(int32 KartIndex) const { return KartNames[KartIndex]; }
+
+	int32 GetNumChunks() const { return Chunks.Num(); }
+	const FWRTelemetryChunkView& GetChunk(int32 ChunkIndex) const { return Chunks[ChunkIndex]; }
+
+	float GetFrameTime(int32 Frame) const;
+	bool GetSample(int32 Frame, int32 KartIndex, FWRTelemetrySample& OutSample) const;
+
+private:
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	TArray<uint8> FileData;
+
+	const uint8* Data = nullptr;
+	int64 DataSize = 0;
+
+	int32 NumKarts = 0;
+	int32 NumFrames = 0;
+	float SampleRate = 0.0f;
+	TArray<FString> KartNames;
+	TArray<FWRTelemetryChunkView> Chunks;
+
+	bool ParseFile();
+	const FWRTelemetryChunkView* FindChunk(int32 Frame) const;
+};
@@ -0,0 +1,299 @@
+#include "WRTelemetryRecorder.h"
+#include "WRTelemetryReader.h"
+#include "WastelandRacers/WastelandRacers.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/Paths.h"
+
+FWRTelemetryRecorder::~FWRTelemetryRecorder()
+{
+	Stop();
+}
+
+bool FWRTelemetryRecorder::Start(const FString& Path, TArrayView<const FString> KartNames, float InSampleRate, int32 InChunkFrames)
+{
+	Stop();
+
+	if (KartNames.Num() == 0)
+	{
+		return false;
+	}
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(Path));
+	FileHandle.Reset(PlatformFile.OpenWrite(*Path));
+	if (!FileHandle)
+	{
+		UE_LOG(LogWastelandRacers, Warning, TEXT("Could not open telemetry file %s"), *Path);
+		return false;
+	}
+
+	FilePath = Path;
+	NumKarts = KartNames.Num();
+	ChunkFrames = FMath::Max(1, InChunkFrames);
+	SampleInterval = InSampleRate > 0.0f ? 1.0f / InSampleRate : 0.0f;
+	SampleAccumulator = SampleInterval;
+	WriteFrame = 0;
+	NumRecordedFrames = 0;
+	bWriteFailed = false;
+
+	// All ring memory is allocated here; recording never allocates
+	const int32 RingFrames = ChunkFrames * 2;
+	const int32 RingSamples = RingFrames * NumKarts;
+	Times.SetNumUninitialized(RingFrames);
+	Locations.SetNumUninitialized(RingSamples);
+	Velocities.SetNumUninitialized(RingSamples);
+	Throttles.SetNumUninitialized(RingSamples);
+	Steerings.SetNumUninitialized(RingSamples);
+	BoostEnergies.SetNumUninitialized(RingSamples);
+	Healths.SetNumUninitialized(RingSamples);
+	Progresses.SetNumUninitialized(RingSamples);
+	Laps.SetNumUninitialized(RingSamples);
+
+	FWRTelemetryFileHeader Header;
+	Header.NumKarts = NumKarts;
+	Header.ChunkFrames = ChunkFrames;
+	Header.SampleRate = InSampleRate;
+
+	TArray<ANSICHAR> Names;
+	Names.SetNumZeroed(NumKarts * WRTelemetry::KartNameLength);
+	for (int32 i = 0; i < NumKarts; i++)
+	{
+		FTCHARToUTF8 Utf8Name(*KartNames[i]);
+		FMemory::Memcpy(&Names[i * WRTelemetry::KartNameLength], Utf8Name.Get(), FMath::Min(Utf8Name.Length(), WRTelemetry::KartNameLength - 1));
+	}
+
+	if (!FileHandle->Write((const uint8*)&Header, sizeof(Header)) || !FileHandle->Write((const uint8*)Names.GetData(), Names.Num()))
+	{
+		UE_LOG(LogWastelandRacers, Warning, TEXT("Could not write telemetry header to %s"), *Path);
+		FileHandle.Reset();
+		return false;
+	}
+
+	UE_LOG(LogWastelandRacers, Log, TEXT("Recording telemetry for %d karts at %.0f Hz to %s"), NumKarts, InSampleRate, *Path);
+	return true;
+}
+
+void FWRTelemetryRecorder::Stop()
+{
+	if (!IsRecording())
+	{
+		return;
+	}
+
+	if (FlushTask.IsValid())
+	{
+		FlushTask.Wait();
+	}
+
+	const int32 PendingFrames = WriteFrame % ChunkFrames;
+	if (PendingFrames > 0)
+	{
+		WriteChunk(WriteFrame / ChunkFrames, PendingFrames);
+	}
+
+	FileHandle->Flush();
+	FileHandle.Reset();
+
+	if (bWriteFailed)
+	{
+		UE_LOG(LogWastelandRacers, Warning, TEXT("Telemetry file %s is incomplete - a chunk failed to write"), *FilePath);
+	}
+	else
+	{
+		UE_LOG(LogWastelandRacers, Log, TEXT("Telemetry written: %d frames to %s"), NumRecordedFrames, *FilePath);
+	}
+
+	Times.Empty();
+	Locations.Empty();
+	Velocities.Empty();
+	Throttles.Empty();
+	Steerings.Empty();
+	BoostEnergies.Empty();
+	Healths.Empty();
+	Progresses.Empty();
+	Laps.Empty();
+}
+
+bool FWRTelemetryRecorder::ShouldSample(float DeltaTime)
+{
+	if (SampleInterval <= 0.0f)
+	{
+		return true;
+	}
+
+	SampleAccumulator += DeltaTime;
+	if (SampleAccumulator + KINDA_SMALL_NUMBER < SampleInterval)
+	{
+		return false;
+	}
+
+	// Drop the backlog after a hitch instead of recording a burst of identical frames
+	SampleAccumulator = FMath::Clamp(SampleAccumulator - SampleInterval, 0.0f, SampleInterval);
+	return true;
+}
+
+void FWRTelemetryRecorder::RecordFrame(float Time, TArrayView<const FWRTelemetrySample> Samples)
+{
+	if (!IsRecording())
+	{
+		return;
+	}
+
+	Times[WriteFrame] = Time;
+
+	const int32 NumSamples = FMath::Min(Samples.Num(), NumKarts);
+	const int32 Base = WriteFrame * NumKarts;
+	for (int32 k = 0; k < NumKarts; k++)
+	{
+		const FWRTelemetrySample& Sample = k < NumSamples ? Samples[k] : FWRTelemetrySample();
+		Locations[Base + k] = Sample.Location;
+		Velocities[Base + k] = Sample.Velocity;
+		Throttles[Base + k] = Sample.Throttle;
+		Steerings[Base + k] = Sample.Steering;
+		BoostEnergies[Base + k] = Sample.BoostEnergy;
+		Healths[Base + k] = Sample.Health;
+		Progresses[Base + k] = Sample.Progress;
+		Laps[Base + k] = Sample.Lap;
+	}
+
+	WriteFrame++;
+	NumRecordedFrames++;
+
+	if (WriteFrame % ChunkFrames == 0)
+	{
+		FlushChunk(WriteFrame / ChunkFrames - 1, ChunkFrames);
+		if (WriteFrame == ChunkFrames * 2)
+		{
+			WriteFrame = 0;
+		}
+	}
+}
+
+void FWRTelemetryRecorder::FlushChunk(int32 ChunkIndex, int32 NumFrames)
+{
+	// The previous flush read the chunk we are about to refill, so it has to be finished first.
+	// At 256 frames per chunk it has had several seconds, so this never blocks in practice.
+	if (FlushTask.IsValid())
+	{
+		FlushTask.Wait();
+	}
+
+	FlushTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [this, ChunkIndex, NumFrames]()
+	{
+		WriteChunk(ChunkIndex, NumFrames);
+	});
+}
+
+void FWRTelemetryRecorder::WriteChunk(int32 ChunkIndex, int32 NumFrames)
+{
+	const int32 FirstFrame = ChunkIndex * ChunkFrames;
+	const int64 FirstSample = (int64)FirstFrame * NumKarts;
+	const int64 NumSamples = (int64)NumFrames * NumKarts;
+
+	FWRTelemetryChunkHeader Header;
+	Header.NumFrames = NumFrames;
+	Header.NumKarts = NumKarts;
+
+	bool bSuccess = FileHandle->Write((const uint8*)&Header, sizeof(Header));
+	bSuccess = bSuccess && FileHandle->Write((const uint8*)(Times.GetData() + FirstFrame), NumFrames * sizeof(float));
+
+	auto WriteSamples = [&](const auto& Array)
+	{
+		bSuccess = bSuccess && FileHandle->Write((const uint8*)(Array.GetData() + FirstSample), NumSamples * Array.GetTypeSize());
+	};
+
+	// Order must match WRTelemetryTypes.h
+	WriteSamples(Locations);
+	WriteSamples(Velocities);
+	WriteSamples(Throttles);
+	WriteSamples(Steerings);
+	WriteSamples(BoostEnergies);
+	WriteSamples(Healths);
+	WriteSamples(Progresses);
+	WriteSamples(Laps);
+
+	if (!bSuccess)
+	{
+		bWriteFailed = true;
+	}
+}
+
+#if !UE_BUILD_SHIPPING
+static FAutoConsoleCommand BenchTelemetryCommand(
+	TEXT("wr.Bench.Telemetry"),
+	TEXT("Records a synthetic 8-kart, 60 Hz race for one minute, reports per-frame recording cost and verifies the file"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		const int32 NumKarts = 8;
+		const float SampleRate = 60.0f;
+		const int32 NumFrames = 3600;
+		// Game-thread recording cost allowed per frame
+		const double BudgetMs = 0.05;
+		const FString Path = FPaths::ProjectSavedDir() / TEXT("Telemetry/Bench.wrtl");
+
+		TArray<FString> Names;
+		for (int32 k = 0; k < NumKarts; k++)
+		{
+			Names.Add(FString::Printf(TEXT("BenchKart_%d"), k));
+		}
+
+		FRandomStream Random(42);
+		TArray<FWRTelemetrySample> Samples;
+		Samples.SetNum(NumKarts);
+
+		FWRTelemetryRecorder Recorder;
+		if (!Recorder.Start(Path, Names, SampleRate))
+		{
+			return;
+		}
+
+		uint64 TotalCycles = 0;
+		uint64 MaxCycles = 0;
+		for (int32 Frame = 0; Frame < NumFrames; Frame++)
+		{
+			for (int32 k = 0; k < NumKarts; k++)
+			{
+				FWRTelemetrySample& Sample = Samples[k];
+				Sample.Location += FVector3f(Random.FRandRange(10.0f, 30.0f), Random.FRandRange(-5.0f, 5.0f), 0.0f);
+				Sample.Velocity = FVector3f(Random.FRandRange(1000.0f, 2000.0f), 0.0f, 0.0f);
+				Sample.Throttle = Random.FRand();
+				Sample.Progress = (float)Frame / (float)NumFrames * 3.0f;
+				Sample.Lap = (int32)Sample.Progress;
+			}
+
+			const uint64 Start = FPlatformTime::Cycles64();
+			Recorder.RecordFrame(Frame / SampleRate, Samples);
+			const uint64 Cycles = FPlatformTime::Cycles64() - Start;
+			TotalCycles += Cycles;
+			MaxCycles = FMath::Max(MaxCycles, Cycles);
+		}
+
+		Recorder.Stop();
+
+		const double MeanMs = FPlatformTime::ToMilliseconds64(TotalCycles) / NumFrames;
+		UE_LOG(LogWastelandRacers, Display, TEXT("Telemetry: %d karts, mean %.3f us, max %.3f us per recorded frame"),
+			NumKarts,
+			MeanMs * 1000.0,
+			FPlatformTime::ToMilliseconds64(MaxCycles) * 1000.0);
+		if (MeanMs > BudgetMs)
+		{
+			UE_LOG(LogWastelandRacers, Warning, TEXT("Telemetry: mean %.3f us per frame is over the %.3f us budget"), MeanMs * 1000.0, BudgetMs * 1000.0);
+		}
+
+		FWRTelemetryReader Reader;
+		FWRTelemetrySample LastSample;
+		const bool bValid = Reader.Open(Path)
+			&& Reader.GetNumFrames() == NumFrames
+			&& Reader.GetNumKarts() == NumKarts
+			&& Reader.GetSample(NumFrames - 1, NumKarts - 1, LastSample)
+			&& LastSample.Location == Samples.Last().Location;
+		Reader.Close();
+
+		UE_LOG(LogWastelandRacers, Display, TEXT("Telemetry: read back %s"), bValid ? TEXT("OK") : TEXT("FAILED"));
+		IFileManager::Get().Delete(*Path);
+	}));
+#endif
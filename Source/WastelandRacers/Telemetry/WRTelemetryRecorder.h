@@ -0,0 +1,65 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tasks/Task.h"
+#include "WastelandRacers/Telemetry/WRTelemetryTypes.h"
+
+class IFileHandle;
+
+// Records per-kart state into preallocated structure-of-arrays ring buffers.
+// The ring holds two chunks; when one fills it is written to disk by a background
+// task straight from the ring memory while the game thread fills the other.
+class WASTELANDRACERS_API FWRTelemetryRecorder
+{
+public:
+	FWRTelemetryRecorder() = default;
+	~FWRTelemetryRecorder();
+
+	FWRTelemetryRecorder(const FWRTelemetryRecorder&) = delete;
+	FWRTelemetryRecorder& operator=(const FWRTelemetryRecorder&) = delete;
+
+	bool Start(const FString& Path, TArrayView<const FString> KartNames, float InSampleRate, int32 InChunkFrames = 256);
+
+	// Writes any partial chunk and blocks until the file is closed
+	void Stop();
+
+	bool IsRecording() const { return FileHandle.IsValid(); }
+	int32 GetNumKarts() const { return NumKarts; }
+	int32 GetNumRecordedFrames() const { return NumRecordedFrames; }
+	const FString& GetPath() const { return FilePath; }
+
+	// Advances the sample clock; returns true when a frame should be recorded this tick
+	bool ShouldSample(float DeltaTime);
+
+	// Samples must hold one entry per kart, in the order the names were given to Start
+	void RecordFrame(float Time, TArrayView<const FWRTelemetrySample> Samples);
+
+private:
+	TUniquePtr<IFileHandle> FileHandle;
+	FString FilePath;
+	UE::Tasks::FTask FlushTask;
+	std::atomic<bool> bWriteFailed = false;
+
+	int32 NumKarts = 0;
+	int32 ChunkFrames = 0;
+	float SampleInterval = 0.0f;
+	float SampleAccumulator = 0.0f;
+
+	// Frame being written within the ring (two chunks long) and total frames recorded
+	int32 WriteFrame = 0;
+	int32 NumRecordedFrames = 0;
+
+	// Ring storage, frame-major within each array
+	TArray<float> Times;
+	TArray<FVector3f> Locations;
+	TArray<FVector3f> Velocities;
+	TArray<float> Throttles;
+	TArray<float> Steerings;
+	TArray<float> BoostEnergies;
+	TArray<float> Healths;
+	TArray<float> Progresses;
+	TArray<int32> Laps;
+
+	void FlushChunk(int32 ChunkIndex, int32 NumFrames);
+	void WriteChunk(int32 ChunkIndex, int32 NumFrames);
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// On-disk telemetry layout. Everything is little-endian and 4-byte aligned so the
+// file can be memory-mapped and read in place.
+//
+//   FWRTelemetryFileHeader
+//   char KartNames[NumKarts][KartNameLength]            UTF-8, NUL padded
+//   repeated until end of file:
+//     FWRTelemetryChunkHeader
+//     float     Time[NumFrames]
+//     FVector3f Location[NumFrames * NumKarts]          frame-major
+//     FVector3f Velocity[NumFrames * NumKarts]
+//     float     Throttle[NumFrames * NumKarts]
+//     float     Steering[NumFrames * NumKarts]
+//     float     BoostEnergy[NumFrames * NumKarts]
+//     float     Health[NumFrames * NumKarts]
+//     float     Progress[NumFrames * NumKarts]
+//     int32     Lap[NumFrames * NumKarts]
+namespace WRTelemetry
+{
+	static constexpr uint32 FileMagic = 0x4C545257;		// "WRTL"
+	static constexpr uint32 ChunkMagic = 0x43545257;	// "WRTC"
+	static constexpr uint32 FileVersion = 1;
+	static constexpr int32 KartNameLength = 32;
+
+	static_assert(PLATFORM_LITTLE_ENDIAN, "Telemetry files are written straight from memory and must be little-endian");
+
+	inline int64 GetChunkDataSize(int32 NumFrames, int32 NumKarts)
+	{
+		const int64 Samples = (int64)NumFrames * NumKarts;
+		return (int64)NumFrames * sizeof(float)
+			+ Samples * (2 * sizeof(FVector3f) + 5 * sizeof(float) + sizeof(int32));
+	}
+}
+
+struct FWRTelemetryFileHeader
+{
+	uint32 Magic = WRTelemetry::FileMagic;
+	uint32 Version = WRTelemetry::FileVersion;
+	uint32 NumKarts = 0;
+	uint32 ChunkFrames = 0;
+	float SampleRate = 0.0f;
+	uint32 Reserved[3] = {};
+};
+
+struct FWRTelemetryChunkHeader
+{
+	uint32 Magic = WRTelemetry::ChunkMagic;
+	uint32 NumFrames = 0;
+	uint32 NumKarts = 0;
+	uint32 Reserved = 0;
+};
+
+static_assert(sizeof(FWRTelemetryFileHeader) == 32, "Telemetry file header layout changed");
+static_assert(sizeof(FWRTelemetryChunkHeader) == 16, "Telemetry chunk header layout changed");
+static_assert(sizeof(FVector3f) == 12, "Telemetry expects packed float vectors");
+
+// One kart at one sample time
+struct FWRTelemetrySample
+{
+	FVector3f Location = FVector3f::ZeroVector;
+	FVector3f Velocity = FVector3f::ZeroVector;
+	float Throttle = 0.0f;
+	float Steering = 0.0f;
+	float BoostEnergy = 0.0f;
+	float Health = 0.0f;
+	float Progress = 0.0f;
+	int32 Lap = 0;
+};
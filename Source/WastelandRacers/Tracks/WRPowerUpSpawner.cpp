@@ -2,6 +2,8 @@
 #include "WastelandRacers.h"
 #include "WastelandRacers/Vehicles/WRKart.h"
 #include "WastelandRacers/Gameplay/WRPowerUpComponent.h"
+#include "WastelandRacers/Core/WRGameplayProfiler.h"
+#include "WastelandRacers/Gameplay/WRRaceWorldSubsystem.h"
 #include "Components/SphereComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "NiagaraComponent.h"
@@ -76,6 +78,7 @@ AWRPowerUpSpawner::AWRPowerUpSpawner()
 void AWRPowerUpSpawner::BeginPlay()
 {
 	Super::BeginPlay();
+	RandomStream = FWRGameplayRandom::MakeStream(this);
 	
 	if (bHasPowerUp)
 	{
@@ -86,6 +89,7 @@ void AWRPowerUpSpawner::BeginPlay()
 void AWRPowerUpSpawner::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
+	WR_PROFILE_SCOPE(Spawners);
 
 	// Rotate power-up for visual appeal
 	if (bHasPowerUp && PowerUpMesh)
@@ -147,6 +151,12 @@ void AWRPowerUpSpawner::CollectPowerUp(AWRKart* Kart)
 	// Else proceed to give power-up and record lap.
 	LastLapCollected.Add(Kart, KartLap);
 
+	// Re-roll against the kart's cached race position so trailing karts get catch-up items
+	if (bRandomizePowerUp && Kart->GetPosition() > 0)
+	{
+		CurrentPowerUp = SelectPowerUpForPosition(Kart->GetPosition());
+	}
+
 	// Give power-up to kart
 	UWRPowerUpComponent* PowerUpComponent = Kart->FindComponentByClass<UWRPowerUpComponent>();
 	if (PowerUpComponent)
@@ -154,6 +164,11 @@ void AWRPowerUpSpawner::CollectPowerUp(AWRKart* Kart)
 		PowerUpComponent->CollectPowerUp(CurrentPowerUp);
 	}
 
+	if (UWRRaceWorldSubsystem* RaceWorld = UWRRaceWorldSubsystem::GetInstance(this))
+	{
+		RaceWorld->PostEvent(EWRRaceEventType::PowerUpCollected, Kart, this, (int32)CurrentPowerUp.PowerUpType, GetActorLocation());
+	}
+
 	// Hide power-up
 	bHasPowerUp = false;
 
@@ -239,10 +254,54 @@ FPowerUpData AWRPowerUpSpawner::SelectRandomPowerUp() const
 		return FPowerUpData();
 	}
 
-	int32 RandomIndex = FMath::RandRange(0, AvailablePowerUps.Num() - 1);
+	int32 RandomIndex = RandomStream.RandRange(0, AvailablePowerUps.Num() - 1);
 	return AvailablePowerUps[RandomIndex];
 }
 
+FPowerUpData AWRPowerUpSpawner::SelectPowerUpForPosition(int32 Position) const
+{
+	if (AvailablePowerUps.Num() == 0)
+	{
+		return FPowerUpData();
+	}
+
+	// Offensive and speed items gain weight the further back the kart is, defensive items favour the leaders
+	float TotalWeight = 0.0f;
+	float Weights[16];
+	const int32 NumCandidates = FMath::Min(AvailablePowerUps.Num(), (int32)UE_ARRAY_COUNT(Weights));
+	for (int32 i = 0; i < NumCandidates; i++)
+	{
+		const FPowerUpData& PowerUp = AvailablePowerUps[i];
+		const bool bCatchUp = PowerUp.PowerUpType == EPowerUpType::SpeedBoost || PowerUp.WeaponType == EWeaponType::HomingRocket;
+		const bool bDefensive = PowerUp.PowerUpType == EPowerUpType::Shield || PowerUp.WeaponType == EWeaponType::OilSlick;
+
+		float Weight = 1.0f;
+		if (bCatchUp)
+		{
+			Weight += (Position - 1) * 0.5f;
+		}
+		else if (bDefensive)
+		{
+			Weight += FMath::Max(0, 4 - Position) * 0.5f;
+		}
+
+		Weights[i] = Weight;
+		TotalWeight += Weight;
+	}
+
+	float Roll = RandomStream.FRandRange(0.0f, TotalWeight);
+	for (int32 i = 0; i < NumCandidates; i++)
+	{
+		Roll -= Weights[i];
+		if (Roll <= 0.0f)
+		{
+			return AvailablePowerUps[i];
+		}
+	}
+
+	return AvailablePowerUps[NumCandidates - 1];
+}
+
 void AWRPowerUpSpawner::PlayCollectionEffects()
 {
 	// Play collection effect
@@ -65,11 +65,15 @@ private:
 	FPowerUpData CurrentPowerUp;
 	FTimerHandle RespawnTimer;
 
+	// Seeded from wr.RandomSeed so benchmark runs are reproducible
+	FRandomStream RandomStream;
+
 	UFUNCTION()
 	void OnTriggerBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, 
 		UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
 
 	void SetupPowerUpAppearance();
 	FPowerUpData SelectRandomPowerUp() const;
+	FPowerUpData SelectPowerUpForPosition(int32 Position) const;
 	void PlayCollectionEffects();
 };
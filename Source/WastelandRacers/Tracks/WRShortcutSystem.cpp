@@ -1,6 +1,7 @@
 #include "WRShortcutSystem.h"
 #include "WastelandRacers/Vehicles/WRKart.h"
 #include "WastelandRacers/Tracks/WRTrackManager.h"
+#include "WastelandRacers/Gameplay/WRRaceWorldSubsystem.h"
 #include "Components/BoxComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "Components/SplineComponent.h"
@@ -35,6 +36,14 @@ void AWRShortcutSystem::RegisterShortcut(const FShortcutData& ShortcutData)
 	UE_LOG(LogTemp, Warning, TEXT("Registered shortcut: %s"), *ShortcutData.ShortcutName);
 }
 
+void AWRShortcutSystem::SetBypassedCheckpoints(int32 ShortcutIndex, TArray<int32>&& Checkpoints)
+{
+	if (Shortcuts.IsValidIndex(ShortcutIndex))
+	{
+		Shortcuts[ShortcutIndex].BypassedCheckpoints = MoveTemp(Checkpoints);
+	}
+}
+
 void AWRShortcutSystem::DiscoverShortcut(int32 ShortcutIndex, AWRKart* DiscoveringKart)
 {
 	if (ShortcutIndex >= 0 && ShortcutIndex < Shortcuts.Num())
@@ -60,9 +69,22 @@ void AWRShortcutSystem::DiscoverShortcut(int32 ShortcutIndex, AWRKart* Discoveri
 			UE_LOG(LogTemp, Warning, TEXT("Shortcut discovered: %s by %s"), 
 				*Shortcut.ShortcutName, *DiscoveringKart->GetName());
 		}
+	}
+}
+
+void AWRShortcutSystem::CompleteShortcut(int32 ShortcutIndex, AWRKart* Kart)
+{
+	if (!Kart || !Shortcuts.IsValidIndex(ShortcutIndex))
+		return;
 
-		Shortcut.UsageCount++;
-		OnShortcutUsed.Broadcast(DiscoveringKart, Shortcut);
+	FShortcutData& Shortcut = Shortcuts[ShortcutIndex];
+	Shortcut.UsageCount++;
+	OnShortcutUsed.Broadcast(Kart, Shortcut);
+
+	// The race manager credits the shortcut's bypassed checkpoints for this lap
+	if (UWRRaceWorldSubsystem* RaceWorld = UWRRaceWorldSubsystem::GetInstance(this))
+	{
+		RaceWorld->PostEvent(EWRRaceEventType::ShortcutUsed, Kart, this, ShortcutIndex, Shortcut.ExitPoint);
 	}
 }
 
@@ -372,6 +394,14 @@ AWRShortcutTrigger::AWRShortcutTrigger()
 	TriggerBox->SetCollisionResponseToChannel(ECollisionChannel::ECC_Vehicle, ECollisionResponse::ECR_Overlap);
 	RootComponent = TriggerBox;
 
+	ExitBox = CreateDefaultSubobject<UBoxComponent>(TEXT("ExitBox"));
+	ExitBox->SetupAttachment(RootComponent);
+	ExitBox->SetBoxExtent(FVector(100.0f, 100.0f, 50.0f));
+	ExitBox->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	ExitBox->SetCollisionObjectType(ECollisionChannel::ECC_WorldStatic);
+	ExitBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
+	ExitBox->SetCollisionResponseToChannel(ECollisionChannel::ECC_Vehicle, ECollisionResponse::ECR_Overlap);
+
 	VisualMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("VisualMesh"));
 	VisualMesh->SetupAttachment(RootComponent);
 	VisualMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
@@ -385,6 +415,7 @@ AWRShortcutTrigger::AWRShortcutTrigger()
 
 	TriggerBox->OnComponentBeginOverlap.AddDynamic(this, &AWRShortcutTrigger::OnTriggerBeginOverlap);
 	TriggerBox->OnComponentEndOverlap.AddDynamic(this, &AWRShortcutTrigger::OnTriggerEndOverlap);
+	ExitBox->OnComponentBeginOverlap.AddDynamic(this, &AWRShortcutTrigger::OnExitBeginOverlap);
 }
 
 void AWRShortcutTrigger::BeginPlay()
@@ -409,6 +440,8 @@ void AWRShortcutTrigger::SetShortcutData(const FShortcutData& Data, int32 Index)
 	
 	ShortcutPath->AddSplinePoint(Data.ExitPoint, ESplineCoordinateSpace::World);
 	ShortcutPath->UpdateSpline();
+	ExitBox->SetWorldLocation(Data.ExitPoint);
+	EnteredOnLap.Reset();
 
 	UpdateVisualState();
 }
@@ -429,12 +462,31 @@ void AWRShortcutTrigger::OnTriggerBeginOverlap(UPrimitiveComponent* OverlappedCo
 			if (ShortcutSystem->IsShortcutAccessible(ShortcutIndex, Kart))
 			{
 				ShortcutSystem->DiscoverShortcut(ShortcutIndex, Kart);
+				EnteredOnLap.Add(Kart, Kart->GetCurrentLap());
 				PlayDiscoveryEffects();
 			}
 		}
 	}
 }
 
+void AWRShortcutTrigger::OnExitBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, 
+	UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+{
+	AWRKart* Kart = Cast<AWRKart>(OtherActor);
+	if (!Kart)
+		return;
+
+	// Clipping the entrance and driving back to the road earns nothing
+	int32 EnteredLap;
+	if (!EnteredOnLap.RemoveAndCopyValue(Kart, EnteredLap) || EnteredLap != Kart->GetCurrentLap())
+		return;
+
+	if (AWRShortcutSystem* ShortcutSystem = Cast<AWRShortcutSystem>(GetOwner()))
+	{
+		ShortcutSystem->CompleteShortcut(ShortcutIndex, Kart);
+	}
+}
+
 void AWRShortcutTrigger::OnTriggerEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, 
 	UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
 {
@@ -63,6 +63,10 @@ struct FShortcutData
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	FVector ExitPoint;
 
+	// Checkpoint indices a kart taking this shortcut may legally skip
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TArray<int32> BypassedCheckpoints;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	bool bIsDiscovered = false;
 
@@ -90,6 +94,10 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Shortcuts")
 	void DiscoverShortcut(int32 ShortcutIndex, class AWRKart* DiscoveringKart);
 
+	// A kart that entered the shortcut reached its exit; only then are its checkpoints credited
+	UFUNCTION(BlueprintCallable, Category = "Shortcuts")
+	void CompleteShortcut(int32 ShortcutIndex, class AWRKart* Kart);
+
 	UFUNCTION(BlueprintCallable, Category = "Shortcuts")
 	TArray<FShortcutData> GetAvailableShortcuts(FVector KartLocation, float SearchRadius = 500.0f);
 
@@ -102,6 +110,18 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Shortcuts")
 	int32 GetTotalShortcuts() const { return Shortcuts.Num(); }
 
+	const FShortcutData* GetShortcut(int32 ShortcutIndex) const { return Shortcuts.IsValidIndex(ShortcutIndex) ? &Shortcuts[ShortcutIndex] : nullptr; }
+	TArrayView<const FShortcutData> GetShortcuts() const { return Shortcuts; }
+
+	// Filled in by the race manager from the level's checkpoints when the shortcut has none authored
+	void SetBypassedCheckpoints(int32 ShortcutIndex, TArray<int32>&& Checkpoints);
+
+	// Hidden shortcuts stay closed to AI until someone has found them
+	bool IsShortcutKnown(int32 ShortcutIndex) const
+	{
+		return Shortcuts.IsValidIndex(ShortcutIndex) && (Shortcuts[ShortcutIndex].bIsDiscovered || Shortcuts[ShortcutIndex].ShortcutType != EShortcutType::Hidden);
+	}
+
 	UFUNCTION(BlueprintPure, Category = "Shortcuts")
 	int32 GetDiscoveredShortcuts() const;
 
@@ -167,6 +187,10 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
 	class UBoxComponent* TriggerBox;
 
+	// At the shortcut's exit point
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+	class UBoxComponent* ExitBox;
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
 	class UStaticMeshComponent* VisualMesh;
 
@@ -197,6 +221,13 @@ private:
 	void OnTriggerEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, 
 		UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
 
+	UFUNCTION()
+	void OnExitBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, 
+		UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+
+	// Lap each kart was on when it entered, so an exit only counts for a kart that came in this lap
+	TMap<TWeakObjectPtr<class AWRKart>, int32> EnteredOnLap;
+
 	void UpdateVisualState();
 	void PlayDiscoveryEffects();
 };
@@ -1,16 +1,13 @@
 #include "WRTrackCheckpoint.h"
 #include "WastelandRacers.h"
 #include "WastelandRacers/Vehicles/WRKart.h"
-#include "WastelandRacers/Gameplay/WRRaceManager.h"
+#include "WastelandRacers/Gameplay/WRRaceWorldSubsystem.h"
 #include "Components/BoxComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "NiagaraComponent.h"
 #include "NiagaraFunctionLibrary.h"
 #include "Kismet/GameplayStatics.h"
 #include "Engine/Engine.h"
-#include "EngineUtils.h"
-#include "EngineUtils.h"
-#include "EngineUtils.h"
 
 AWRTrackCheckpoint::AWRTrackCheckpoint()
 {
@@ -19,10 +16,8 @@ AWRTrackCheckpoint::AWRTrackCheckpoint()
 	// Create trigger box
 	TriggerBox = CreateDefaultSubobject<UBoxComponent>(TEXT("TriggerBox"));
 	TriggerBox->SetBoxExtent(FVector(100.0f, 500.0f, 200.0f));
-	TriggerBox->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
-	TriggerBox->SetCollisionObjectType(ECollisionChannel::ECC_WorldStatic);
-	TriggerBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-	TriggerBox->SetCollisionResponseToChannel(ECollisionChannel::ECC_Vehicle, ECollisionResponse::ECR_Overlap);
+	TriggerBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	TriggerBox->SetGenerateOverlapEvents(false);
 	RootComponent = TriggerBox;
 
 	// Create checkpoint mesh
@@ -33,15 +28,17 @@ AWRTrackCheckpoint::AWRTrackCheckpoint()
 	// Create checkpoint effect
 	CheckpointEffect = CreateDefaultSubobject<UNiagaraComponent>(TEXT("CheckpointEffect"));
 	CheckpointEffect->SetupAttachment(RootComponent);
-
-	// Bind overlap event
-	TriggerBox->OnComponentBeginOverlap.AddDynamic(this, &AWRTrackCheckpoint::OnTriggerBeginOverlap);
 }
 
 void AWRTrackCheckpoint::BeginPlay()
 {
 	Super::BeginPlay();
 
+	if (UWRRaceWorldSubsystem* RaceWorld = UWRRaceWorldSubsystem::GetInstance(this))
+	{
+		RaceWorld->RegisterCheckpoint(this);
+	}
+
 	// Setup visual appearance based on checkpoint type
 	if (bIsFinishLine)
 	{
@@ -61,49 +58,34 @@ void AWRTrackCheckpoint::BeginPlay()
 	}
 }
 
-void AWRTrackCheckpoint::OnTriggerBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, 
-	UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+void AWRTrackCheckpoint::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	AWRKart* Kart = Cast<AWRKart>(OtherActor);
-	if (!Kart)
-		return;
+	if (UWRRaceWorldSubsystem* RaceWorld = UWRRaceWorldSubsystem::GetInstance(this))
+	{
+		RaceWorld->UnregisterCheckpoint(this);
+	}
 
-	// Check if this kart has already passed this checkpoint this lap
-	if (KartsPassedThisLap.Contains(Kart))
-		return;
+	Super::EndPlay(EndPlayReason);
+}
+
+void AWRTrackCheckpoint::GetGate(FVector& OutOrigin, FVector& OutNormal, FVector& OutUp, FVector2f& OutHalfExtents) const
+{
+	const FVector Extent = TriggerBox->GetScaledBoxExtent();
+	OutOrigin = TriggerBox->GetComponentLocation();
+	OutNormal = TriggerBox->GetForwardVector();
+	OutUp = TriggerBox->GetUpVector();
+	OutHalfExtents = FVector2f((float)Extent.Y, (float)Extent.Z);
+}
 
-	// Add kart to passed list
-	KartsPassedThisLap.Add(Kart);
+void AWRTrackCheckpoint::NotifyKartPassed(AWRKart* Kart)
+{
+	if (!IsValid(Kart))
+		return;
 
-	// Play checkpoint effects
 	PlayCheckpointEffects(Kart);
-
-	// Broadcast checkpoint passed event
 	OnCheckpointPassed.Broadcast(Kart, CheckpointIndex);
 
-	// Notify race manager
-	if (UWorld* World = GetWorld())
-	{
-		for (TActorIterator<AWRRaceManager> ActorItr(World); ActorItr; ++ActorItr)
-		{
-			AWRRaceManager* RaceManager = *ActorItr;
-			if (RaceManager)
-			{
-				RaceManager->OnKartPassedCheckpoint(Kart, CheckpointIndex);
-				
-				// If this is the finish line, check for lap completion
-				if (bIsFinishLine)
-				{
-					RaceManager->OnKartCompletedLap(Kart);
-					// Clear the passed karts for next lap
-					KartsPassedThisLap.Remove(Kart);
-				}
-				break;
-			}
-		}
-	}
-
-	UE_LOG(LogTemp, Warning, TEXT("Kart %s passed checkpoint %d"), *Kart->GetName(), CheckpointIndex);
+	UE_LOG(LogWastelandRacers, Verbose, TEXT("Kart %s passed checkpoint %d"), *Kart->GetName(), CheckpointIndex);
 }
 
 void AWRTrackCheckpoint::PlayCheckpointEffects(AWRKart* Kart)
@@ -126,6 +108,6 @@ void AWRTrackCheckpoint::PlayCheckpointEffects(AWRKart* Kart)
 	if (bIsFinishLine)
 	{
 		// Play special finish line effects
-		UE_LOG(LogTemp, Warning, TEXT("Kart %s crossed finish line!"), *Kart->GetName());
+		UE_LOG(LogWastelandRacers, Verbose, TEXT("Kart %s crossed finish line"), *Kart->GetName());
 	}
 }
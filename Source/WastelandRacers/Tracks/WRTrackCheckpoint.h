@@ -16,6 +16,13 @@ public:
 	AWRTrackCheckpoint();
 
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// Effects and OnCheckpointPassed, run when UWRRaceWorldSubsystem dispatches the crossing
+	void NotifyKartPassed(class AWRKart* Kart);
+
+	// Gate rectangle swept by the race manager: the box's YZ face through the actor origin
+	void GetGate(FVector& OutOrigin, FVector& OutNormal, FVector& OutUp, FVector2f& OutHalfExtents) const;
 
 	UFUNCTION(BlueprintCallable, Category = "Checkpoint")
 	void SetCheckpointIndex(int32 Index) { CheckpointIndex = Index; }
@@ -33,6 +40,7 @@ public:
 	FOnCheckpointPassed OnCheckpointPassed;
 
 protected:
+	// Only sizes the gate; crossings are detected by FWRCheckpointGates, not by overlaps
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
 	class UBoxComponent* TriggerBox;
 
@@ -58,11 +66,6 @@ protected:
 	class USoundBase* FinishLineSound;
 
 private:
-	TSet<class AWRKart*> KartsPassedThisLap;
-
-	UFUNCTION()
-	void OnTriggerBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, 
-		UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
 
 	void PlayCheckpointEffects(class AWRKart* Kart);
 };
@@ -1,6 +1,10 @@
 #include "WRTrackHazard.h"
 #include "WastelandRacers.h"
 #include "WastelandRacers/Vehicles/WRKart.h"
+#include "WastelandRacers/Core/WRGameplayProfiler.h"
+#include "WastelandRacers/Core/WRGameplayClock.h"
+#include "WastelandRacers/Gameplay/WRRaceWorldSubsystem.h"
+#include "WastelandRacers/Weapons/WRExplosionSubsystem.h"
 #include "Components/SphereComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "Components/AudioComponent.h"
@@ -48,12 +52,43 @@ void AWRTrackHazard::BeginPlay()
 {
 	Super::BeginPlay();
 	SetupHazardAppearance();
+	UpdateExplosiveRegistration();
+
+	if (UWRGameplayClock* Clock = UWRGameplayClock::GetInstance(this))
+	{
+		FixedStepHandle = Clock->Register(EWRFixedStepPhase::Hazards, FWROnFixedStep::FDelegate::CreateUObject(this, &AWRTrackHazard::FixedStep));
+		SetActorTickEnabled(false);
+	}
+}
+
+void AWRTrackHazard::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UWRGameplayClock* Clock = UWRGameplayClock::GetInstance(this))
+	{
+		Clock->Unregister(EWRFixedStepPhase::Hazards, FixedStepHandle);
+	}
+	if (UWRExplosionSubsystem* Explosions = UWRExplosionSubsystem::GetInstance(this))
+	{
+		Explosions->UnregisterExplosive(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AWRTrackHazard::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+	if (!FixedStepHandle.IsValid())
+	{
+		FixedStep(DeltaTime);
+	}
+}
+
+void AWRTrackHazard::FixedStep(float FixedDeltaTime)
+{
+	WR_PROFILE_SCOPE(Hazards);
+
 	// Handle continuous damage for affected karts
 	if (bIsContinuous && bIsActive)
 	{
@@ -71,6 +106,26 @@ void AWRTrackHazard::SetHazardType(EHazardType Type)
 {
 	HazardType = Type;
 	SetupHazardAppearance();
+	if (HasActorBegunPlay())
+	{
+		UpdateExplosiveRegistration();
+	}
+}
+
+void AWRTrackHazard::UpdateExplosiveRegistration()
+{
+	UWRExplosionSubsystem* Explosions = UWRExplosionSubsystem::GetInstance(this);
+	if (!Explosions)
+		return;
+
+	if (HazardType == EHazardType::ExplosiveBarrel)
+	{
+		Explosions->RegisterExplosive(this);
+	}
+	else
+	{
+		Explosions->UnregisterExplosive(this);
+	}
 }
 
 void AWRTrackHazard::ActivateHazard()
@@ -82,6 +137,11 @@ void AWRTrackHazard::ActivateHazard()
 	bIsActive = true;
 	LastActivationTime = CurrentTime;
 
+	if (UWRRaceWorldSubsystem* RaceWorld = UWRRaceWorldSubsystem::GetInstance(this))
+	{
+		RaceWorld->PostEvent(EWRRaceEventType::HazardActivated, nullptr, this, (int32)HazardType, GetActorLocation());
+	}
+
 	// Play activation effects
 	if (ActivationEffect)
 	{
@@ -134,6 +194,30 @@ void AWRTrackHazard::DeactivateHazard()
 	AffectedKarts.Empty();
 }
 
+void AWRTrackHazard::Detonate()
+{
+	if (!bIsActive || HazardType != EHazardType::ExplosiveBarrel)
+		return;
+
+	DeactivateHazard();
+
+	// Resolved with the frame's other explosions, which is also how nearby barrels get set off
+	if (UWRExplosionSubsystem* Explosions = UWRExplosionSubsystem::GetInstance(this))
+	{
+		Explosions->QueueExplosion(GetActorLocation(), ExplosionRadius, Damage * 2.0f, ExplosionImpulse);
+	}
+
+	if (ActivationEffect)
+	{
+		UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), ActivationEffect, GetActorLocation(), GetActorRotation());
+	}
+
+	if (ActivationSound)
+	{
+		UGameplayStatics::PlaySoundAtLocation(GetWorld(), ActivationSound, GetActorLocation());
+	}
+}
+
 void AWRTrackHazard::OnHazardBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, 
 	UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
@@ -147,7 +231,10 @@ void AWRTrackHazard::OnHazardBeginOverlap(UPrimitiveComponent* OverlappedCompone
 	AffectedKarts.Add(Kart);
 	ApplyHazardEffect(Kart);
 
-	UE_LOG(LogTemp, Warning, TEXT("Kart %s entered hazard: %d"), *Kart->GetName(), (int32)HazardType);
+	if (UWRRaceWorldSubsystem* RaceWorld = UWRRaceWorldSubsystem::GetInstance(this))
+	{
+		RaceWorld->PostEvent(EWRRaceEventType::HazardEntered, Kart, this, (int32)HazardType, Kart->GetActorLocation());
+	}
 }
 
 void AWRTrackHazard::OnHazardEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, 
@@ -177,10 +264,8 @@ void AWRTrackHazard::ApplyHazardEffect(AWRKart* Kart)
 			break;
 
 		case EHazardType::ExplosiveBarrel:
-			// Explosive barrels cause instant damage and knockback
-			// Kart->TakeDamage(Damage * 2.0f);
-			// Kart->ApplyKnockback(GetActorLocation(), 2000.0f);
-			DeactivateHazard(); // One-time use
+			// Explosive barrels cause instant damage and knockback, once
+			Detonate();
 			break;
 
 		case EHazardType::ElectricFence:
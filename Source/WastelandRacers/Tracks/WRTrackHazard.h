@@ -27,8 +27,12 @@ public:
 	AWRTrackHazard();
 
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void Tick(float DeltaTime) override;
 
+	// Continuous hazard effects, run by UWRGameplayClock in the Hazards phase
+	void FixedStep(float FixedDeltaTime);
+
 	UFUNCTION(BlueprintCallable, Category = "Hazard")
 	void SetHazardType(EHazardType Type);
 
@@ -41,6 +45,10 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Hazard")
 	void DeactivateHazard();
 
+	// Explosive barrels: blows up through UWRExplosionSubsystem and deactivates. Nothing while inactive.
+	UFUNCTION(BlueprintCallable, Category = "Hazard")
+	void Detonate();
+
 protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
 	class USphereComponent* HazardTrigger;
@@ -75,6 +83,13 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Hazard")
 	float ActivationCooldown = 5.0f;
 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Hazard")
+	float ExplosionRadius = 500.0f;
+
+	// Knockback velocity at the centre of the explosion
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Hazard")
+	float ExplosionImpulse = 2000.0f;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Effects")
 	class UNiagaraSystem* ActivationEffect;
 
@@ -87,6 +102,7 @@ protected:
 private:
 	float LastActivationTime = 0.0f;
 	TSet<class AWRKart*> AffectedKarts;
+	FDelegateHandle FixedStepHandle;
 
 	UFUNCTION()
 	void OnHazardBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, 
@@ -99,4 +115,5 @@ private:
 	void ApplyHazardEffect(class AWRKart* Kart);
 	void RemoveHazardEffect(class AWRKart* Kart);
 	void SetupHazardAppearance();
+	void UpdateExplosiveRegistration();
 };
@@ -23,11 +23,19 @@ AWRTrackVariations::AWRTrackVariations()
 	InitializeEridiumVariations();
 	InitializeWildlifeVariations();
 	InitializeHyperionVariations();
+}
+
+void AWRTrackVariations::BeginPlay()
+{
+	Super::BeginPlay();
 
-	// Create shortcut system
-	FActorSpawnParameters SpawnParams;
-	SpawnParams.Owner = this;
-	ShortcutSystem = GetWorld()->SpawnActor<AWRShortcutSystem>(AWRShortcutSystem::StaticClass(), SpawnParams);
+	// Actors cannot be spawned from the constructor, which also runs for the class default object
+	if (!ShortcutSystem)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.Owner = this;
+		ShortcutSystem = GetWorld()->SpawnActor<AWRShortcutSystem>(AWRShortcutSystem::StaticClass(), SpawnParams);
+	}
 }
 
 void AWRTrackVariations::GenerateTrackVariation(ETrackType BaseTrack, ETrackShape Shape)
@@ -96,6 +96,8 @@ class WASTELANDRACERS_API AWRTrackVariations : public AActor
 public:
 	AWRTrackVariations();
 
+	virtual void BeginPlay() override;
+
 	UFUNCTION(BlueprintCallable, Category = "Track Generation")
 	void GenerateTrackVariation(ETrackType BaseTrack, ETrackShape Shape);
 
@@ -111,6 +113,9 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Track Generation")
 	void SetupShortcutsForVariation(const FTrackVariation& Variation);
 
+	UFUNCTION(BlueprintPure, Category = "Track Generation")
+	class USplineComponent* GetTrackSpline() const { return TrackSpline; }
+
 protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Track Variations")
 	TMap<ETrackType, FTrackVariationList> TrackVariations;
@@ -1,6 +1,8 @@
 #include "WRHUDWidget.h"
 #include "WastelandRacers/Player/WRPlayerController.h"
 #include "WastelandRacers/Vehicles/WRKart.h"
+#include "WastelandRacers/Gameplay/WRRaceManager.h"
+#include "WastelandRacers/Replay/WRGhostSubsystem.h"
 #include "Components/Button.h"
 #include "Components/Widget.h"
 
@@ -32,6 +34,12 @@ void UWRHUDWidget::NativeConstruct()
 		DriftButton->OnReleased.AddDynamic(this, &UWRHUDWidget::OnDriftReleased);
 	}
 
+	if (UWRRaceWorldSubsystem* RaceWorld = UWRRaceWorldSubsystem::GetInstance(this))
+	{
+		RaceManager = RaceWorld->GetRaceManager();
+		RaceEventsHandle = RaceWorld->OnRaceEvents.AddUObject(this, &UWRHUDWidget::HandleRaceEvents);
+	}
+
 #if PLATFORM_ANDROID || PLATFORM_IOS
 	// Show mobile controls
 	if (AccelerateButton) AccelerateButton->SetVisibility(ESlateVisibility::Visible);
@@ -49,6 +57,16 @@ void UWRHUDWidget::NativeConstruct()
 #endif
 }
 
+void UWRHUDWidget::NativeDestruct()
+{
+	if (UWRRaceWorldSubsystem* RaceWorld = UWRRaceWorldSubsystem::GetInstance(this))
+	{
+		RaceWorld->OnRaceEvents.Remove(RaceEventsHandle);
+	}
+
+	Super::NativeDestruct();
+}
+
 void UWRHUDWidget::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
 {
 	Super::NativeTick(MyGeometry, InDeltaTime);
@@ -122,18 +140,74 @@ void UWRHUDWidget::UpdateHUDElements()
 	if (!PlayerKart)
 		return;
 
+	// The HUD can be built before the race manager has begun play
+	if (!RaceManager)
+	{
+		if (UWRRaceWorldSubsystem* RaceWorld = UWRRaceWorldSubsystem::GetInstance(this))
+		{
+			RaceManager = RaceWorld->GetRaceManager();
+		}
+	}
+
 	// Update speedometer
 	float CurrentSpeed = PlayerKart->GetCurrentSpeed();
 	UpdateSpeedometer(CurrentSpeed);
 
-	// Update position
+	// Update position from the race manager's cached standings
 	int32 Position = PlayerKart->GetPosition();
-	UpdatePosition(Position, 8); // Assuming max 8 players
+	int32 TotalPlayers = RaceManager ? RaceManager->GetNumRacers() : 8;
+	UpdatePosition(Position, TotalPlayers);
 
 	// Update lap counter
 	int32 CurrentLap = PlayerKart->GetCurrentLap();
-	UpdateLapCounter(CurrentLap, 3); // Assuming 3 laps
+	UpdateLapCounter(CurrentLap, RaceManager ? RaceManager->GetTotalLaps() : 3);
+
+	// Lap and sector times, with splits pushed only when a sector closes
+	if (const FWRKartLapTiming* Timing = RaceManager ? RaceManager->FindKartLapTiming(PlayerKart) : nullptr)
+	{
+		UpdateLapTimes(RaceManager->GetKartCurrentLapTime(PlayerKart), Timing->LastLapTime, Timing->BestLapTime);
+
+		if (Timing->SplitSerial != LastSplitSerial)
+		{
+			LastSplitSerial = Timing->SplitSerial;
+
+			// The split that just closed is either on the current lap or the last sector of the previous one
+			const TArray<float>& Splits = Timing->CurrentSectorTimes.Num() > 0 ? Timing->CurrentSectorTimes : Timing->LastLapSectorTimes;
+			if (Splits.Num() > 0)
+			{
+				const int32 Sector = Splits.Num() - 1;
+				const float BestSector = Timing->BestSectorTimes.IsValidIndex(Sector) ? Timing->BestSectorTimes[Sector] : -1.0f;
+				ShowSectorSplit(Sector, Splits[Sector], BestSector);
+			}
+		}
+	}
+
+	const bool bWrongWay = RaceManager && RaceManager->IsKartWrongWay(PlayerKart);
+	if (bWrongWay != bShowingWrongWay)
+	{
+		bShowingWrongWay = bWrongWay;
+		ShowWrongWay(bWrongWay);
+	}
+
+	// Ghost deltas only change at sector boundaries
+	UWRGhostSubsystem* Ghosts = UWRGhostSubsystem::GetInstance(this);
+	if (Ghosts && Ghosts->IsTimeTrialActive() && Ghosts->GetSplitSerial() != LastGhostSplitSerial)
+	{
+		LastGhostSplitSerial = Ghosts->GetSplitSerial();
+		UpdateGhostDelta(Ghosts->GetLastLapDelta(), Ghosts->GetLastSectorDelta(), Ghosts->GetLastSplitSector());
+	}
 
 	// Update weapon display
 	// This would need weapon component integration
 }
+
+void UWRHUDWidget::HandleRaceEvents(TArrayView<const FWRRaceEvent> Events)
+{
+	for (const FWRRaceEvent& Event : Events)
+	{
+		if (!Event.Kart.IsValid() || Event.Kart.Get() == PlayerKart)
+		{
+			OnRaceEvent(Event);
+		}
+	}
+}
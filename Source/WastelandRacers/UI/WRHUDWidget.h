@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "Blueprint/UserWidget.h"
+#include "WastelandRacers/Gameplay/WRRaceWorldSubsystem.h"
 #include "WRHUDWidget.generated.h"
 
 UCLASS()
@@ -11,6 +12,7 @@ class WASTELANDRACERS_API UWRHUDWidget : public UUserWidget
 
 public:
 	virtual void NativeConstruct() override;
+	virtual void NativeDestruct() override;
 	virtual void NativeTick(const FGeometry& MyGeometry, float InDeltaTime) override;
 
 	void SetOwningPlayer(class AWRPlayerController* PlayerController);
@@ -27,6 +29,13 @@ public:
 	UFUNCTION(BlueprintImplementableEvent, Category = "HUD")
 	void UpdateRaceTime(float RaceTime);
 
+	// Lap times are -1 until the first lap is complete
+	UFUNCTION(BlueprintImplementableEvent, Category = "HUD")
+	void UpdateLapTimes(float CurrentLapTime, float LastLapTime, float BestLapTime);
+
+	UFUNCTION(BlueprintImplementableEvent, Category = "HUD")
+	void ShowSectorSplit(int32 Sector, float SectorTime, float BestSectorTime);
+
 	UFUNCTION(BlueprintImplementableEvent, Category = "HUD")
 	void UpdateWeaponDisplay(class UTexture2D* WeaponIcon);
 
@@ -39,6 +48,17 @@ public:
 	UFUNCTION(BlueprintImplementableEvent, Category = "HUD")
 	void ShowRaceFinished(int32 FinalPosition);
 
+	// Race events involving the player's kart, or no kart at all, delivered once per tick
+	UFUNCTION(BlueprintImplementableEvent, Category = "HUD")
+	void OnRaceEvent(const FWRRaceEvent& Event);
+
+	UFUNCTION(BlueprintImplementableEvent, Category = "HUD")
+	void ShowWrongWay(bool bWrongWay);
+
+	// Time-trial split against the reference ghost; negative deltas are ahead of it
+	UFUNCTION(BlueprintImplementableEvent, Category = "HUD")
+	void UpdateGhostDelta(float LapDelta, float SectorDelta, int32 Sector);
+
 protected:
 	UPROPERTY(BlueprintReadOnly, Category = "HUD")
 	class AWRPlayerController* OwningPlayerController;
@@ -46,6 +66,9 @@ protected:
 	UPROPERTY(BlueprintReadOnly, Category = "HUD")
 	class AWRKart* PlayerKart;
 
+	UPROPERTY(BlueprintReadOnly, Category = "HUD")
+	class AWRRaceManager* RaceManager;
+
 	// Mobile touch controls
 	UPROPERTY(meta = (BindWidget))
 	class UButton* AccelerateButton;
@@ -85,4 +108,11 @@ private:
 	void OnDriftReleased();
 
 	void UpdateHUDElements();
+	void HandleRaceEvents(TArrayView<const FWRRaceEvent> Events);
+
+	FDelegateHandle RaceEventsHandle;
+
+	int32 LastGhostSplitSerial = 0;
+	int32 LastSplitSerial = 0;
+	bool bShowingWrongWay = false;
 };
@@ -2,6 +2,8 @@
 #include "Components/StaticMeshComponent.h"
 #include "Components/AudioComponent.h"
 #include "WastelandRacers/Weapons/WRWeaponComponent.h"
+#include "WastelandRacers/Gameplay/WRKartSpatialHash.h"
+#include "ChaosWheeledVehicleMovementComponent.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "Camera/CameraComponent.h"
 #include "Components/InputComponent.h"
@@ -30,22 +32,52 @@ AWRKart::AWRKart()
 void AWRKart::BeginPlay()
 {
 	Super::BeginPlay();
+
+	BoostEnergyStep.Reset(CurrentBoostEnergy);
+
+	if (const UChaosWheeledVehicleMovementComponent* Movement = Cast<UChaosWheeledVehicleMovementComponent>(GetVehicleMovementComponent()))
+	{
+		BaseMaxEngineTorque = Movement->EngineSetup.MaxTorque;
+	}
+
+	GameplayClock = UWRGameplayClock::GetInstance(this);
+	if (GameplayClock)
+	{
+		FixedStepHandle = GameplayClock->Register(EWRFixedStepPhase::Vehicles, FWROnFixedStep::FDelegate::CreateUObject(this, &AWRKart::FixedStep));
+	}
+
+	if (UWRKartSpatialSubsystem* Spatial = UWRKartSpatialSubsystem::GetInstance(this))
+	{
+		Spatial->RegisterKart(this);
+	}
 	
 	UE_LOG(LogWastelandRacers, Log, TEXT("WRKart BeginPlay - Health: %.1f, Boost: %.1f"), CurrentHealth, CurrentBoostEnergy);
 }
 
-void AWRKart::Tick(float DeltaTime)
+void AWRKart::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	Super::Tick(DeltaTime);
+	if (GameplayClock)
+	{
+		GameplayClock->Unregister(EWRFixedStepPhase::Vehicles, FixedStepHandle);
+		GameplayClock = nullptr;
+	}
 
-	// Handle boost
-	if (bIsBoosting && CurrentBoostEnergy > 0.0f)
+	if (UWRKartSpatialSubsystem* Spatial = UWRKartSpatialSubsystem::GetInstance(this))
 	{
-		UseBoost(DeltaTime);
+		Spatial->UnregisterKart(this);
 	}
-	else
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AWRKart::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Without a gameplay clock (e.g. editor preview worlds) integrate on the frame
+	if (!FixedStepHandle.IsValid())
 	{
-		RechargeBoost(DeltaTime);
+		FixedStep(DeltaTime);
 	}
 
 	// Update engine audio based on throttle
@@ -116,6 +148,16 @@ void AWRKart::OnHandbrakeReleased()
 	GetVehicleMovementComponent()->SetHandbrakeInput(false);
 }
 
+void AWRKart::SetBrakeInput(float Value)
+{
+	if (IsDestroyed())
+	{
+		return;
+	}
+
+	GetVehicleMovementComponent()->SetBrakeInput(Value);
+}
+
 void AWRKart::OnBoostPressed()
 {
 	if (CurrentBoostEnergy > 0.0f && !IsDestroyed())
@@ -125,6 +167,16 @@ void AWRKart::OnBoostPressed()
 	}
 }
 
+void AWRKart::SetBoosting(bool bBoosting)
+{
+	if (bBoosting && (CurrentBoostEnergy <= 0.0f || IsDestroyed()))
+	{
+		return;
+	}
+
+	bIsBoosting = bBoosting;
+}
+
 void AWRKart::OnFireWeapon()
 {
 	if (WeaponComponent && !IsDestroyed())
@@ -133,6 +185,26 @@ void AWRKart::OnFireWeapon()
 	}
 }
 
+void AWRKart::FixedStep(float FixedDeltaTime)
+{
+	if (bIsBoosting && CurrentBoostEnergy > 0.0f)
+	{
+		UseBoost(FixedDeltaTime);
+	}
+	else
+	{
+		RechargeBoost(FixedDeltaTime);
+	}
+
+	BoostEnergyStep.Push(CurrentBoostEnergy);
+}
+
+float AWRKart::GetBoostPercentage() const
+{
+	const float Alpha = FixedStepHandle.IsValid() ? GameplayClock->GetInterpolationAlpha() : 1.0f;
+	return BoostEnergyStep.Get(Alpha) / MaxBoostEnergy;
+}
+
 void AWRKart::UseBoost(float DeltaTime)
 {
 	if (CurrentBoostEnergy > 0.0f)
@@ -170,6 +242,48 @@ void AWRKart::TakeDamage(float DamageAmount)
 	}
 }
 
+void AWRKart::ApplyKnockback(const FVector& VelocityChange)
+{
+	if (KartMesh->IsSimulatingPhysics())
+	{
+		KartMesh->AddImpulse(VelocityChange, NAME_None, true);
+	}
+}
+
+void AWRKart::SetEngineTorqueScale(float Scale)
+{
+	// Rubber-banding eases the scale in, so skip the engine update for changes too small to matter
+	if (FMath::IsNearlyEqual(Scale, EngineTorqueScale, 0.001f))
+	{
+		return;
+	}
+
+	EngineTorqueScale = Scale;
+	if (UChaosWheeledVehicleMovementComponent* Movement = Cast<UChaosWheeledVehicleMovementComponent>(GetVehicleMovementComponent()))
+	{
+		Movement->SetMaxEngineTorque(BaseMaxEngineTorque * Scale);
+	}
+}
+
+void AWRKart::Respawn(const FVector& Location, const FRotator& Rotation)
+{
+	SetActorLocationAndRotation(Location, Rotation, false, nullptr, ETeleportType::ResetPhysics);
+	KartMesh->SetPhysicsLinearVelocity(FVector::ZeroVector);
+	KartMesh->SetPhysicsAngularVelocityInDegrees(FVector::ZeroVector);
+
+	bIsBoosting = false;
+	GetVehicleMovementComponent()->StopMovementImmediately();
+	GetVehicleMovementComponent()->SetThrottleInput(0.0f);
+	GetVehicleMovementComponent()->SetSteeringInput(0.0f);
+
+	if (IsDestroyed())
+	{
+		CurrentHealth = MaxHealth;
+	}
+
+	UE_LOG(LogWastelandRacers, Log, TEXT("Kart %s respawned at %s"), *GetName(), *Location.ToString());
+}
+
 void AWRKart::RepairKart(float RepairAmount)
 {
 	CurrentHealth = FMath::Min(MaxHealth, CurrentHealth + RepairAmount);
@@ -7,6 +7,7 @@
 #include "Components/AudioComponent.h"
 #include "Engine/Engine.h"
 #include "WastelandRacers/WastelandRacers.h"
+#include "WastelandRacers/Core/WRGameplayClock.h"
 #include "WRKart.generated.h"
 
 UCLASS()
@@ -19,11 +20,15 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
 	virtual void Tick(float DeltaTime) override;
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 
+	// Boost integration, run by UWRGameplayClock in the Vehicles phase
+	void FixedStep(float FixedDeltaTime);
+
 	// Input functions
 	void MoveForward(float Value);
 	void MoveRight(float Value);
@@ -32,6 +37,26 @@ public:
 	void OnBoostPressed();
 	void OnFireWeapon();
 
+	// AI input, mirrors the player bindings above
+	UFUNCTION(BlueprintCallable, Category = "Input")
+	void SetThrottleInput(float Value) { MoveForward(Value); }
+
+	UFUNCTION(BlueprintCallable, Category = "Input")
+	void SetSteeringInput(float Value) { MoveRight(Value); }
+
+	UFUNCTION(BlueprintCallable, Category = "Input")
+	void SetBrakeInput(float Value);
+
+	// Explicit on/off, unlike the toggling OnBoostPressed
+	UFUNCTION(BlueprintCallable, Category = "Input")
+	void SetBoosting(bool bBoosting);
+
+	UFUNCTION(BlueprintCallable, Category = "Input")
+	void StartDrift() { OnHandbrakePressed(); }
+
+	UFUNCTION(BlueprintCallable, Category = "Input")
+	void StopDrift() { OnHandbrakeReleased(); }
+
 	// Kart properties
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
 	class UStaticMeshComponent* KartMesh;
@@ -75,9 +100,17 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Health")
 	void TakeDamage(float DamageAmount);
 
+	// Instant velocity change, for explosions
+	UFUNCTION(BlueprintCallable, Category = "Health")
+	void ApplyKnockback(const FVector& VelocityChange);
+
 	UFUNCTION(BlueprintCallable, Category = "Health")
 	void RepairKart(float RepairAmount);
 
+	// Teleports the kart at rest, repairing it if destroyed
+	UFUNCTION(BlueprintCallable, Category = "Health")
+	void Respawn(const FVector& Location, const FRotator& Rotation);
+
 	UFUNCTION(BlueprintPure, Category = "Status")
 	bool IsDestroyed() const { return CurrentHealth <= 0.0f; }
 
@@ -85,11 +118,56 @@ public:
 	float GetHealthPercentage() const { return CurrentHealth / MaxHealth; }
 
 	UFUNCTION(BlueprintPure, Category = "Status")
-	float GetBoostPercentage() const { return CurrentBoostEnergy / MaxBoostEnergy; }
+	float GetBoostPercentage() const;
+
+	UFUNCTION(BlueprintPure, Category = "Status")
+	bool IsBoosting() const { return bIsBoosting; }
+
+	UFUNCTION(BlueprintPure, Category = "Status")
+	bool IsDrifting() const { return bIsHandbrakePressed; }
+
+	UFUNCTION(BlueprintPure, Category = "Status")
+	float GetCurrentSpeed() const { return GetVelocity().Size(); }
+
+	UFUNCTION(BlueprintPure, Category = "Input")
+	float GetThrottleInput() const { return ThrottleInput; }
+
+	UFUNCTION(BlueprintPure, Category = "Input")
+	float GetSteeringInput() const { return SteeringInput; }
+
+	// Race state, written by AWRRaceManager
+	UFUNCTION(BlueprintPure, Category = "Race")
+	int32 GetCurrentLap() const { return CurrentLap; }
+
+	UFUNCTION(BlueprintCallable, Category = "Race")
+	void SetCurrentLap(int32 Lap) { CurrentLap = Lap; }
+
+	UFUNCTION(BlueprintPure, Category = "Race")
+	int32 GetPosition() const { return RacePosition; }
+
+	UFUNCTION(BlueprintCallable, Category = "Race")
+	void SetRacePosition(int32 Position) { RacePosition = Position; }
+
+	// Multiplies the engine's max torque; written each race step by AWRRaceManager's rubber-banding
+	UFUNCTION(BlueprintCallable, Category = "Race")
+	void SetEngineTorqueScale(float Scale);
+
+	UFUNCTION(BlueprintPure, Category = "Race")
+	float GetEngineTorqueScale() const { return EngineTorqueScale; }
 
 private:
 	bool bIsBoosting = false;
 	bool bIsHandbrakePressed = false;
 	float ThrottleInput = 0.0f;
 	float SteeringInput = 0.0f;
+	int32 CurrentLap = 0;
+	int32 RacePosition = 0;
+	float EngineTorqueScale = 1.0f;
+	float BaseMaxEngineTorque = 0.0f;
+
+	UPROPERTY()
+	UWRGameplayClock* GameplayClock = nullptr;
+
+	FDelegateHandle FixedStepHandle;
+	TWRFixedStepValue<float> BoostEnergyStep;
 };
@@ -1,5 +1,5 @@
 #include "WRGrenade.h"
-#include "WastelandRacers/Vehicles/WRKart.h"
+#include "WastelandRacers/Weapons/WRExplosionSubsystem.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "NiagaraFunctionLibrary.h"
 #include "Engine/Engine.h"
@@ -32,6 +32,14 @@ void AWRGrenade::BeginPlay()
 	GetWorldTimerManager().SetTimer(FuseTimer, this, &AWRGrenade::OnFuseExpired, FuseTime, false);
 }
 
+void AWRGrenade::ResetForReuse()
+{
+	Super::ResetForReuse();
+
+	// The pool cleared the old fuse on release
+	GetWorldTimerManager().SetTimer(FuseTimer, this, &AWRGrenade::OnFuseExpired, FuseTime, false);
+}
+
 void AWRGrenade::OnImpact(const FHitResult& HitResult)
 {
 	// Grenades don't explode on first impact, they bounce
@@ -56,8 +64,11 @@ void AWRGrenade::Explode()
 
 	bHasExploded = true;
 
-	// Apply explosion damage
-	ApplyExplosionDamage();
+	// Damage and knockback land with the frame's other explosions
+	if (UWRExplosionSubsystem* Explosions = UWRExplosionSubsystem::GetInstance(this))
+	{
+		Explosions->QueueExplosion(GetActorLocation(), ExplosionRadius, ExplosionDamage, ExplosionImpulse);
+	}
 
 	// Spawn explosion effect
 	if (ExplosionEffect)
@@ -72,27 +83,5 @@ void AWRGrenade::Explode()
 		UGameplayStatics::PlaySoundAtLocation(GetWorld(), ImpactSound, GetActorLocation());
 	}
 
-	Destroy();
-}
-
-void AWRGrenade::ApplyExplosionDamage()
-{
-	TArray<FOverlapResult> OverlapResults;
-	for (const FOverlapResult& Result : OverlapResults)
-	{
-		if (AWRKart* HitKart = Cast<AWRKart>(Result.GetActor()))
-		{
-			// Calculate damage based on distance
-			float Distance = FVector::Dist(GetActorLocation(), HitKart->GetActorLocation());
-			float DamageMultiplier = 1.0f - (Distance / ExplosionRadius);
-			float FinalDamage = ExplosionDamage * DamageMultiplier;
-
-			// Apply knockback force
-			FVector KnockbackDirection = (HitKart->GetActorLocation() - GetActorLocation()).GetSafeNormal();
-			FVector KnockbackForce = KnockbackDirection * 2000.0f * DamageMultiplier;
-
-			// Apply force to kart (implementation depends on physics setup)
-			UE_LOG(LogTemp, Warning, TEXT("Grenade explosion hit %s for %f damage"), *HitKart->GetName(), FinalDamage);
-		}
-	}
+	UWRActorPoolSubsystem::ReleaseOrDestroy(this);
 }
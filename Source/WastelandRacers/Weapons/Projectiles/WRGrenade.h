@@ -13,6 +13,7 @@ public:
 	AWRGrenade();
 
 	virtual void BeginPlay() override;
+	virtual void ResetForReuse() override;
 
 protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Explosion")
@@ -21,6 +22,10 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Explosion")
 	float ExplosionDamage = 75.0f;
 
+	// Knockback velocity at the centre of the explosion
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Explosion")
+	float ExplosionImpulse = 2000.0f;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Explosion")
 	float FuseTime = 3.0f;
 
@@ -36,5 +41,4 @@ private:
 	UFUNCTION()
 	void OnFuseExpired();
 
-	void ApplyExplosionDamage();
 };
@@ -1,5 +1,8 @@
 #include "WRHomingRocket.h"
 #include "WastelandRacers/Vehicles/WRKart.h"
+#include "WastelandRacers/Gameplay/WRRaceManager.h"
+#include "WastelandRacers/Weapons/WRRocketGuidanceSubsystem.h"
+#include "WastelandRacers/Gameplay/WRKartSpatialHash.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "Engine/Engine.h"
 
@@ -9,73 +12,137 @@ AWRHomingRocket::AWRHomingRocket()
 	Speed = 800.0f;
 	Damage = 50.0f;
 	LifeTime = 8.0f;
+
+	// Guided in one pass with every other rocket
+	PrimaryActorTick.bCanEverTick = false;
 }
 
 void AWRHomingRocket::BeginPlay()
 {
 	Super::BeginPlay();
-	HomingTimer = 0.0f;
+	StartGuidance();
+}
+
+void AWRHomingRocket::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	StopGuidance();
+	Super::EndPlay(EndPlayReason);
+}
+
+void AWRHomingRocket::ResetForReuse()
+{
+	Super::ResetForReuse();
+	TargetKart = nullptr;
+	TargetOutOfRangeTime = -1.0f;
+	StartGuidance();
 }
 
-void AWRHomingRocket::Tick(float DeltaTime)
+void AWRHomingRocket::Explode()
 {
-	Super::Tick(DeltaTime);
+	StopGuidance();
+	Super::Explode();
+}
+
+void AWRHomingRocket::LifeSpanExpired()
+{
+	StopGuidance();
+	Super::LifeSpanExpired();
+}
 
-	HomingTimer += DeltaTime;
-	if (HomingTimer >= HomingDelay)
+void AWRHomingRocket::StartGuidance()
+{
+	HomingStartTime = GetWorld()->GetTimeSeconds() + HomingDelay;
+	if (UWRRocketGuidanceSubsystem* Guidance = UWRRocketGuidanceSubsystem::GetInstance(this))
 	{
-		bCanHome = true;
+		Guidance->RegisterRocket(this);
 	}
+}
 
-	if (bCanHome && TargetKart)
+void AWRHomingRocket::StopGuidance()
+{
+	if (UWRRocketGuidanceSubsystem* Guidance = UWRRocketGuidanceSubsystem::GetInstance(this))
 	{
-		UpdateHoming(DeltaTime);
+		Guidance->UnregisterRocket(this);
 	}
 }
 
 void AWRHomingRocket::SetTarget(AWRKart* NewTarget)
 {
 	TargetKart = NewTarget;
+	TargetOutOfRangeTime = -1.0f;
 }
 
-void AWRHomingRocket::UpdateHoming(float DeltaTime)
+bool AWRHomingRocket::KeepTarget(float WorldTime)
 {
-	if (!TargetKart || !IsValid(TargetKart))
+	if (!GetTarget())
 	{
-		TargetKart = nullptr;
-		return;
+		return false;
 	}
 
-	float DistanceToTarget = FVector::Dist(GetActorLocation(), TargetKart->GetActorLocation());
-	if (DistanceToTarget > MaxHomingDistance)
+	if (FVector::DistSquared(TargetKart->GetActorLocation(), GetActorLocation()) <= FMath::Square(MaxHomingDistance))
 	{
-		return;
+		TargetOutOfRangeTime = -1.0f;
+		return true;
 	}
 
-	FVector HomingDirection = CalculateHomingDirection();
-	if (!HomingDirection.IsZero())
+	if (TargetOutOfRangeTime < 0.0f)
 	{
-		FVector CurrentVelocity = ProjectileMovement->Velocity;
-		FVector NewVelocity = FMath::VInterpTo(CurrentVelocity, HomingDirection * Speed, DeltaTime, HomingStrength);
-		ProjectileMovement->Velocity = NewVelocity;
+		TargetOutOfRangeTime = WorldTime;
+	}
+	if (WorldTime - TargetOutOfRangeTime < TargetLostTime)
+	{
+		return true;
+	}
+
+	SetTarget(nullptr);
+	return false;
+}
+
+AWRKart* AWRHomingRocket::AcquireTarget(const AWRRaceManager* RaceManager)
+{
+	// Never lock onto the kart that fired it
+	AWRKart* Shooter = Cast<AWRKart>(GetInstigator());
 
-		// Update rotation to match velocity
-		SetActorRotation(NewVelocity.Rotation());
+	TargetOutOfRangeTime = -1.0f;
+	if (RaceManager && Shooter)
+	{
+		const int32 Position = RaceManager->GetKartPosition(Shooter);
+		if (Position > 1)
+		{
+			// A kart ahead on the lap but out of reach would leave the rocket flying straight
+			TargetKart = RaceManager->GetKartAtPosition(Position - 1);
+			if (TargetKart && TargetKart != Shooter
+				&& FVector::DistSquared(TargetKart->GetActorLocation(), GetActorLocation()) <= FMath::Square(MaxHomingDistance))
+			{
+				return TargetKart;
+			}
+		}
+	}
+
+	TargetKart = nullptr;
+	if (const UWRKartSpatialSubsystem* Spatial = UWRKartSpatialSubsystem::GetInstance(this))
+	{
+		AWRKart* Candidates[1];
+		if (Spatial->QueryCone(GetActorLocation(), GetActorForwardVector(), MaxHomingDistance, AcquireHalfAngle, Candidates, Shooter) > 0)
+		{
+			TargetKart = Candidates[0];
+		}
 	}
+	return TargetKart;
+}
+
+void AWRHomingRocket::GatherGuidanceState(FWRRocketGuidanceBatch& Batch, int32 Index, int32 TargetIndex) const
+{
+	Batch.Locations[Index] = GetActorLocation();
+	Batch.Velocities[Index] = ProjectileMovement->Velocity;
+	Batch.Targets[Index] = TargetIndex;
+	Batch.Speeds[Index] = Speed;
+	Batch.MaxTurnRates[Index] = FMath::DegreesToRadians(MaxTurnRate);
+	Batch.MaxDistancesSq[Index] = FMath::Square(MaxHomingDistance);
 }
 
-FVector AWRHomingRocket::CalculateHomingDirection() const
+void AWRHomingRocket::ApplyGuidanceOutputs(const FWRRocketGuidanceBatch& Batch, int32 Index)
 {
-	if (!TargetKart)
-		return FVector::ZeroVector;
-
-	FVector TargetLocation = TargetKart->GetActorLocation();
-	FVector CurrentLocation = GetActorLocation();
-	
-	// Predict target position based on target velocity
-	FVector TargetVelocity = TargetKart->GetVelocity();
-	float TimeToTarget = FVector::Dist(CurrentLocation, TargetLocation) / Speed;
-	FVector PredictedLocation = TargetLocation + (TargetVelocity * TimeToTarget);
-
-	return (PredictedLocation - CurrentLocation).GetSafeNormal();
+	// Rotation follows velocity through the movement component
+	ProjectileMovement->Velocity = Batch.NewVelocities[Index];
 }
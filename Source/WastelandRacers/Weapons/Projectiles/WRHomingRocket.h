@@ -13,14 +13,30 @@ public:
 	AWRHomingRocket();
 
 	virtual void BeginPlay() override;
-	virtual void Tick(float DeltaTime) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void ResetForReuse() override;
 
 	UFUNCTION(BlueprintCallable, Category = "Homing")
 	void SetTarget(class AWRKart* NewTarget);
 
+	class AWRKart* GetTarget() const { return IsValid(TargetKart) ? TargetKart : nullptr; }
+	bool CanHome(float WorldTime) const { return WorldTime >= HomingStartTime; }
+
+	// The kart directly ahead of the one that fired it in the race when within MaxHomingDistance, else
+	// the nearest kart in front of the nose. Sets and returns the target, or null when there is none.
+	class AWRKart* AcquireTarget(const class AWRRaceManager* RaceManager);
+
+	// False, and the target cleared, once it has been out of MaxHomingDistance for TargetLostTime
+	bool KeepTarget(float WorldTime);
+
+	// Steered by UWRRocketGuidanceSubsystem rather than ticking
+	void GatherGuidanceState(struct FWRRocketGuidanceBatch& Batch, int32 Index, int32 TargetIndex) const;
+	void ApplyGuidanceOutputs(const struct FWRRocketGuidanceBatch& Batch, int32 Index);
+
 protected:
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Homing")
-	float HomingStrength = 2.0f;
+	// Most the rocket can turn, in degrees per second
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Homing", meta = (ClampMin = "0.0"))
+	float MaxTurnRate = 120.0f;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Homing")
 	float MaxHomingDistance = 2000.0f;
@@ -28,13 +44,26 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Homing")
 	float HomingDelay = 0.5f;
 
+	// Leading with no target, the nearest kart within MaxHomingDistance and this angle of the nose is picked
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Homing", meta = (ClampMin = "0.0", ClampMax = "180.0"))
+	float AcquireHalfAngle = 30.0f;
+
+	// Seconds a target may stay out of MaxHomingDistance before the rocket gives up on it and picks another
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Homing", meta = (ClampMin = "0.0"))
+	float TargetLostTime = 1.0f;
+
 private:
 	UPROPERTY()
 	class AWRKart* TargetKart;
 
-	float HomingTimer = 0.0f;
-	bool bCanHome = false;
+	float HomingStartTime = 0.0f;
+
+	// When the target last went out of range, or negative while it is in range
+	float TargetOutOfRangeTime = -1.0f;
+
+	virtual void Explode() override;
+	virtual void LifeSpanExpired() override;
 
-	void UpdateHoming(float DeltaTime);
-	FVector CalculateHomingDirection() const;
+	void StartGuidance();
+	void StopGuidance();
 };
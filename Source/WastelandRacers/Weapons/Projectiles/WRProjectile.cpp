@@ -1,5 +1,6 @@
 #include "WRProjectile.h"
 #include "WastelandRacers/Vehicles/WRKart.h"
+#include "WastelandRacers/Core/WRGameplayProfiler.h"
 #include "Components/SphereComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "GameFramework/ProjectileMovementComponent.h"
@@ -56,8 +57,29 @@ void AWRProjectile::BeginPlay()
 	}
 }
 
+void AWRProjectile::ResetForReuse()
+{
+	bHasExploded = false;
+	CollisionComponent->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+	if (TrailEffect)
+	{
+		TrailEffect->Activate(true);
+	}
+
+	// A blocking hit stops the movement simulating and detaches it from the root
+	ProjectileMovement->SetUpdatedComponent(CollisionComponent);
+	ProjectileMovement->Velocity = GetActorForwardVector() * ProjectileMovement->InitialSpeed;
+	SetLifeSpan(InitialLifeSpan);
+}
+
+void AWRProjectile::LifeSpanExpired()
+{
+	UWRActorPoolSubsystem::ReleaseOrDestroy(this);
+}
+
 void AWRProjectile::Tick(float DeltaTime)
 {
+	WR_PROFILE_SCOPE(Projectiles);
 	Super::Tick(DeltaTime);
 }
 
@@ -105,6 +127,5 @@ void AWRProjectile::Explode()
 		UGameplayStatics::PlaySoundAtLocation(GetWorld(), ImpactSound, GetActorLocation());
 	}
 
-	// Destroy projectile
-	Destroy();
+	UWRActorPoolSubsystem::ReleaseOrDestroy(this);
 }
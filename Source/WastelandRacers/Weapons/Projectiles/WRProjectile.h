@@ -4,10 +4,11 @@
 #include "GameFramework/Actor.h"
 #include "Components/SphereComponent.h"
 #include "GameFramework/ProjectileMovementComponent.h"
+#include "WastelandRacers/Core/WRActorPool.h"
 #include "WRProjectile.generated.h"
 
 UCLASS()
-class WASTELANDRACERS_API AWRProjectile : public AActor
+class WASTELANDRACERS_API AWRProjectile : public AActor, public IWRPooledActor
 {
 	GENERATED_BODY()
 
@@ -16,6 +17,7 @@ public:
 
 	virtual void BeginPlay() override;
 	virtual void Tick(float DeltaTime) override;
+	virtual void ResetForReuse() override;
 
 	UFUNCTION(BlueprintCallable, Category = "Projectile")
 	void SetDamage(float NewDamage) { Damage = NewDamage; }
@@ -57,6 +59,9 @@ protected:
 	virtual void OnImpact(const FHitResult& HitResult);
 	virtual void Explode();
 
+	// Back to the pool rather than destroyed
+	virtual void LifeSpanExpired() override;
+
 protected:
 	bool bHasExploded = false;
 public:
@@ -0,0 +1,552 @@
+#include "WRBulletSubsystem.h"
+#include "WastelandRacers/WastelandRacers.h"
+#include "WastelandRacers/Vehicles/WRKart.h"
+#include "WastelandRacers/Gameplay/WRKartSpatialHash.h"
+#include "WastelandRacers/Weapons/WRWeaponComponent.h"
+#include "WastelandRacers/Core/WRGameplayProfiler.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Kismet/GameplayStatics.h"
+#include "Math/RandomStream.h"
+#include "NiagaraComponent.h"
+#include "NiagaraDataInterfaceArrayFunctionLibrary.h"
+#include "NiagaraFunctionLibrary.h"
+#include "NiagaraSystem.h"
+
+static TAutoConsoleVariable<int32> CVarBulletsEnable(
+	TEXT("wr.Bullets.Enable"),
+	1,
+	TEXT("1 = machine gun, shotgun and flamethrower rounds are simulated by the bullet subsystem. 0 = one projectile actor per round."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarBulletsMax(
+	TEXT("wr.Bullets.Max"),
+	2048,
+	TEXT("Most bullets in flight at once; rounds fired beyond this are dropped."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarBulletsAsyncTraces(
+	TEXT("wr.Bullets.AsyncTraces"),
+	1,
+	TEXT("1 = bullet and hitscan world traces are submitted async in one batch per frame and resolved the next frame. 0 = traced on the game thread as they are fired."),
+	ECVF_Default);
+
+// Karts are hit when a bullet's path passes within this many cm of their origin
+static const float BulletKartRadius = 150.0f;
+
+// World geometry only; karts are found through the spatial hash
+static FCollisionObjectQueryParams GetBulletObjectQuery()
+{
+	FCollisionObjectQueryParams ObjectQuery;
+	ObjectQuery.AddObjectTypesToQuery(ECC_WorldStatic);
+	ObjectQuery.AddObjectTypesToQuery(ECC_WorldDynamic);
+	return ObjectQuery;
+}
+
+// User array parameters on the shared trail system
+static const FName TrailPositionsName(TEXT("BulletPositions"));
+static const FName TrailVelocitiesName(TEXT("BulletVelocities"));
+
+void FWRBulletBatch::Reserve(int32 MaxBullets)
+{
+	for (TArray<float>* Array : { &PositionX, &PositionY, &PositionZ, &PreviousX, &PreviousY, &PreviousZ, &VelocityX, &VelocityY, &VelocityZ,
+		&GravityScale, &Damage, &LifeRemaining })
+	{
+		Array->Reserve(MaxBullets);
+	}
+	Owners.Reserve(MaxBullets);
+}
+
+void FWRBulletBatch::Add(const FVector& Position, const FVector& Velocity, float InGravityScale, float InDamage, float LifeSpan, AActor* Owner)
+{
+	PositionX.Add(Position.X);
+	PositionY.Add(Position.Y);
+	PositionZ.Add(Position.Z);
+	PreviousX.Add(Position.X);
+	PreviousY.Add(Position.Y);
+	PreviousZ.Add(Position.Z);
+	VelocityX.Add(Velocity.X);
+	VelocityY.Add(Velocity.Y);
+	VelocityZ.Add(Velocity.Z);
+	GravityScale.Add(InGravityScale);
+	Damage.Add(InDamage);
+	LifeRemaining.Add(LifeSpan);
+	Owners.Add(Owner);
+}
+
+void FWRBulletBatch::RemoveAtSwap(int32 Index)
+{
+	for (TArray<float>* Array : { &PositionX, &PositionY, &PositionZ, &PreviousX, &PreviousY, &PreviousZ, &VelocityX, &VelocityY, &VelocityZ,
+		&GravityScale, &Damage, &LifeRemaining })
+	{
+		Array->RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	}
+	Owners.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+}
+
+void FWRBulletBatch::Empty()
+{
+	for (TArray<float>* Array : { &PositionX, &PositionY, &PositionZ, &PreviousX, &PreviousY, &PreviousZ, &VelocityX, &VelocityY, &VelocityZ,
+		&GravityScale, &Damage, &LifeRemaining })
+	{
+		Array->Empty();
+	}
+	Owners.Empty();
+}
+
+void FWRBulletBatch::Integrate(float DeltaTime, float GravityZ)
+{
+	// Straight-line arithmetic only, so the loop vectorises
+	const int32 NumBullets = Num();
+	for (int32 i = 0; i < NumBullets; i++)
+	{
+		PreviousX[i] = PositionX[i];
+		PreviousY[i] = PositionY[i];
+		PreviousZ[i] = PositionZ[i];
+		VelocityZ[i] += GravityZ * GravityScale[i] * DeltaTime;
+		PositionX[i] += VelocityX[i] * DeltaTime;
+		PositionY[i] += VelocityY[i] * DeltaTime;
+		PositionZ[i] += VelocityZ[i] * DeltaTime;
+		LifeRemaining[i] -= DeltaTime;
+	}
+}
+
+UWRBulletSubsystem* UWRBulletSubsystem::GetInstance(const UObject* WorldContext)
+{
+	if (const UWorld* World = GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::ReturnNull))
+	{
+		return World->GetSubsystem<UWRBulletSubsystem>();
+	}
+	return nullptr;
+}
+
+bool UWRBulletSubsystem::IsEnabled()
+{
+	return CVarBulletsEnable.GetValueOnGameThread() != 0;
+}
+
+bool UWRBulletSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UWRBulletSubsystem::Deinitialize()
+{
+	Bullets.Empty();
+	QueuedHitscans.Empty();
+	PendingShots.Empty();
+	if (TrailComponent)
+	{
+		TrailComponent->DestroyComponent();
+		TrailComponent = nullptr;
+	}
+	Super::Deinitialize();
+}
+
+TStatId UWRBulletSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UWRBulletSubsystem, STATGROUP_Tickables);
+}
+
+bool UWRBulletSubsystem::FireBullet(const FVector& Origin, const FVector& Velocity, float GravityScale, float Damage, float LifeSpan, AActor* Owner)
+{
+	const int32 MaxBullets = CVarBulletsMax.GetValueOnGameThread();
+	if (Bullets.Num() >= MaxBullets)
+	{
+		return false;
+	}
+
+	if (Bullets.Num() == 0)
+	{
+		Bullets.Reserve(FMath::Min(MaxBullets, 256));
+	}
+	Bullets.Add(Origin, Velocity, GravityScale, Damage, LifeSpan, Owner);
+	return true;
+}
+
+void UWRBulletSubsystem::SetEffects(UNiagaraSystem* InTrailSystem, UNiagaraSystem* InImpactEffect)
+{
+	if (!TrailSystem)
+	{
+		TrailSystem = InTrailSystem;
+	}
+	if (!ImpactEffect)
+	{
+		ImpactEffect = InImpactEffect;
+	}
+}
+
+void UWRBulletSubsystem::FireHitscan(const FVector& Start, const FVector& End, float Damage, AActor* Owner)
+{
+	FWRPendingShot& Shot = QueuedHitscans.AddDefaulted_GetRef();
+	Shot.Start = Start;
+	Shot.End = End;
+	Shot.Owner = Owner;
+	Shot.Damage = Damage;
+}
+
+#if !UE_BUILD_SHIPPING
+// wr.Bench.BulletTraces: 8 karts firing 5-pellet shotgun blasts 10 times a second each, first with
+// synchronous traces and then async, timing the game-thread side of tracing and resolving
+static const int32 BenchKarts = 8;
+static const int32 BenchPellets = 5;
+static const int32 BenchFireFrames = 6;
+static const int32 BenchPhaseFrames = 300;
+
+struct FWRBulletTraceBenchmark
+{
+	TWeakObjectPtr<UWRBulletSubsystem> Subsystem;
+
+	// Owns every synthetic pellet, so their hits can be told apart from gameplay shots
+	TWeakObjectPtr<AActor> Owner;
+
+	// INDEX_NONE when no benchmark is running
+	int32 Frame = INDEX_NONE;
+	double Seconds[2] = {};
+	int32 Shots[2] = {};
+};
+
+static FWRBulletTraceBenchmark TraceBenchmark;
+
+static bool IsTraceBenchmarkShot(const AActor* Owner)
+{
+	return Owner && Owner == TraceBenchmark.Owner.Get();
+}
+
+static void StartTraceBenchmark(UWRBulletSubsystem* Subsystem)
+{
+	FActorSpawnParameters Params;
+	Params.ObjectFlags |= RF_Transient;
+
+	TraceBenchmark = FWRBulletTraceBenchmark();
+	TraceBenchmark.Subsystem = Subsystem;
+	TraceBenchmark.Owner = Subsystem->GetWorld()->SpawnActor<AActor>(Params);
+	TraceBenchmark.Frame = 0;
+	UE_LOG(LogWastelandRacers, Display, TEXT("BulletTraces: running for %d frames"), BenchPhaseFrames * 2);
+}
+
+// Fires this frame's benchmark pellets and returns the phase, or INDEX_NONE when not running
+static int32 StepTraceBenchmark(UWRBulletSubsystem* Subsystem, bool& bInOutAsync)
+{
+	if (TraceBenchmark.Frame == INDEX_NONE || TraceBenchmark.Subsystem.Get() != Subsystem)
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 Phase = TraceBenchmark.Frame / BenchPhaseFrames;
+	if (Phase >= 2)
+	{
+		for (int32 i = 0; i < 2; i++)
+		{
+			UE_LOG(LogWastelandRacers, Display, TEXT("BulletTraces %s: %.3f ms game thread per frame, %.1f traces per frame"),
+				i == 0 ? TEXT("sync ") : TEXT("async"), TraceBenchmark.Seconds[i] * 1000.0 / BenchPhaseFrames, (double)TraceBenchmark.Shots[i] / BenchPhaseFrames);
+		}
+		if (AActor* Owner = TraceBenchmark.Owner.Get())
+		{
+			Owner->Destroy();
+		}
+		TraceBenchmark = FWRBulletTraceBenchmark();
+		return INDEX_NONE;
+	}
+	bInOutAsync = Phase == 1;
+
+	// Short-lived pellets, so the count in flight settles well within each phase
+	const FWRBallistics Ballistics = FWRBallistics::Get(EWeaponType::Shotgun);
+	for (int32 Kart = 0; Kart < BenchKarts; Kart++)
+	{
+		if ((TraceBenchmark.Frame + Kart) % BenchFireFrames != 0)
+		{
+			continue;
+		}
+
+		const FVector Origin(Kart * 1000.0f, 0.0f, 200.0f);
+		for (int32 Pellet = 0; Pellet < BenchPellets; Pellet++)
+		{
+			const float Yaw = FMath::DegreesToRadians((Pellet - BenchPellets / 2) * 3.0f);
+			const FVector Direction(FMath::Cos(Yaw), FMath::Sin(Yaw), 0.0f);
+			Subsystem->FireBullet(Origin, Direction * Ballistics.Speed, Ballistics.GravityScale, 0.0f, 0.5f, TraceBenchmark.Owner.Get());
+		}
+	}
+
+	TraceBenchmark.Frame++;
+	return Phase;
+}
+#endif
+
+void UWRBulletSubsystem::Tick(float DeltaTime)
+{
+	WR_PROFILE_SCOPE(Projectiles);
+
+	bool bAsync = CVarBulletsAsyncTraces.GetValueOnGameThread() != 0;
+#if !UE_BUILD_SHIPPING
+	const int32 BenchPhase = StepTraceBenchmark(this, bAsync);
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+#endif
+
+	// Last tick's traces land before anything moves or is removed, so their bullet slots still match
+	ResolveShots();
+	RemoveDeadBullets();
+
+	if (Bullets.Num() > 0)
+	{
+		Bullets.Integrate(DeltaTime, GetWorld()->GetGravityZ());
+	}
+	SubmitShots(bAsync);
+#if !UE_BUILD_SHIPPING
+	const int32 NumShots = PendingShots.Num();
+#endif
+
+	if (!bAsync)
+	{
+		ResolveShots();
+		RemoveDeadBullets();
+	}
+
+#if !UE_BUILD_SHIPPING
+	if (BenchPhase != INDEX_NONE)
+	{
+		TraceBenchmark.Seconds[BenchPhase] += FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles);
+		TraceBenchmark.Shots[BenchPhase] += NumShots;
+	}
+#endif
+
+	UpdateTrails();
+}
+
+void UWRBulletSubsystem::SubmitShots(bool bAsync)
+{
+	const UWRKartSpatialSubsystem* Spatial = UWRKartSpatialSubsystem::GetInstance(this);
+
+	// Every shot of the frame, whichever kart fired it, goes out in this one pass
+	PendingShots.Reserve(Bullets.Num() + QueuedHitscans.Num());
+	for (int32 i = 0; i < Bullets.Num(); i++)
+	{
+		FWRPendingShot Shot;
+		Shot.Start = Bullets.GetPrevious(i);
+		Shot.End = Bullets.GetPosition(i);
+		Shot.Owner = Bullets.Owners[i];
+		Shot.Damage = Bullets.Damage[i];
+		Shot.BulletIndex = i;
+		AddShot(MoveTemp(Shot), bAsync, Spatial);
+	}
+
+	for (FWRPendingShot& Hitscan : QueuedHitscans)
+	{
+		AddShot(MoveTemp(Hitscan), bAsync, Spatial);
+	}
+	QueuedHitscans.Reset();
+}
+
+void UWRBulletSubsystem::AddShot(FWRPendingShot&& Shot, bool bAsync, const UWRKartSpatialSubsystem* Spatial)
+{
+	const FVector Segment = Shot.End - Shot.Start;
+	const float SegmentLengthSq = Segment.SizeSquared();
+	AActor* Owner = Shot.Owner.Get();
+
+	// Karts first: the earliest whose sphere the segment passes through
+	if (Spatial)
+	{
+		AWRKart* Candidates[8];
+		const int32 NumCandidates = Spatial->QueryRadius(Shot.Start + Segment * 0.5f, FMath::Sqrt(SegmentLengthSq) * 0.5f + BulletKartRadius, Candidates,
+			Cast<AWRKart>(Owner));
+
+		AWRKart* HitKart = nullptr;
+		float HitTime = 1.0f;
+		for (int32 c = 0; c < NumCandidates; c++)
+		{
+			const FVector KartLocation = Candidates[c]->GetActorLocation();
+			const float Time = SegmentLengthSq > KINDA_SMALL_NUMBER
+				? FMath::Clamp(FVector::DotProduct(KartLocation - Shot.Start, Segment) / SegmentLengthSq, 0.0f, 1.0f) : 0.0f;
+			if ((!HitKart || Time < HitTime) && FVector::DistSquared(Shot.Start + Segment * Time, KartLocation) <= FMath::Square(BulletKartRadius))
+			{
+				HitKart = Candidates[c];
+				HitTime = Time;
+			}
+		}
+
+		// The world trace then only runs up to the kart, so walls shield karts behind them
+		Shot.Kart = HitKart;
+		Shot.End = Shot.Start + Segment * HitTime;
+	}
+
+	if (bAsync)
+	{
+		const FCollisionQueryParams Params(SCENE_QUERY_STAT(WRBulletTrace), false, Owner);
+		Shot.Trace = GetWorld()->AsyncLineTraceByObjectType(EAsyncTraceType::Single, Shot.Start, Shot.End, GetBulletObjectQuery(), Params);
+	}
+	PendingShots.Add(MoveTemp(Shot));
+}
+
+void UWRBulletSubsystem::ResolveShots()
+{
+	if (PendingShots.Num() == 0)
+	{
+		return;
+	}
+
+	UWorld* World = GetWorld();
+	DeadBullets.Reset();
+	DeadBullets.AddZeroed(Bullets.Num());
+
+	for (const FWRPendingShot& Shot : PendingShots)
+	{
+		AActor* Owner = Shot.Owner.Get();
+
+		FHitResult WorldHit;
+		bool bHitWorld = false;
+		FTraceDatum Datum;
+		if (Shot.Trace.IsValid() && World->QueryTraceData(Shot.Trace, Datum))
+		{
+			if (const FHitResult* Hit = FHitResult::GetFirstBlockingHit(Datum.OutHits))
+			{
+				WorldHit = *Hit;
+				bHitWorld = true;
+			}
+		}
+		else
+		{
+			// Synchronous traces, or an async result that is no longer available
+			const FCollisionQueryParams Params(SCENE_QUERY_STAT(WRBulletTrace), false, Owner);
+			bHitWorld = World->LineTraceSingleByObjectType(WorldHit, Shot.Start, Shot.End, GetBulletObjectQuery(), Params);
+		}
+
+#if !UE_BUILD_SHIPPING
+		// Benchmark pellets pay for their traces and die on impact but never damage or spawn effects
+		if (IsTraceBenchmarkShot(Owner))
+		{
+			if ((bHitWorld || Shot.Kart.IsValid()) && DeadBullets.IsValidIndex(Shot.BulletIndex))
+			{
+				DeadBullets[Shot.BulletIndex] = 1;
+			}
+			continue;
+		}
+#endif
+
+		const FVector Direction = (Shot.End - Shot.Start).GetSafeNormal();
+		FVector ImpactPoint;
+		if (bHitWorld)
+		{
+			ImpactPoint = WorldHit.ImpactPoint;
+			if (AWRKart* Kart = Cast<AWRKart>(WorldHit.GetActor()))
+			{
+				Kart->TakeDamage(Shot.Damage);
+			}
+			else if (AActor* HitActor = WorldHit.GetActor())
+			{
+				UGameplayStatics::ApplyPointDamage(HitActor, Shot.Damage, Direction, WorldHit, nullptr, Owner, UDamageType::StaticClass());
+			}
+		}
+		else if (AWRKart* Kart = Shot.Kart.Get())
+		{
+			ImpactPoint = Shot.End;
+			Kart->TakeDamage(Shot.Damage);
+		}
+		else
+		{
+			continue;
+		}
+
+		if (ImpactEffect)
+		{
+			UNiagaraFunctionLibrary::SpawnSystemAtLocation(World, ImpactEffect, ImpactPoint, Direction.Rotation());
+		}
+		if (DeadBullets.IsValidIndex(Shot.BulletIndex))
+		{
+			DeadBullets[Shot.BulletIndex] = 1;
+		}
+	}
+	PendingShots.Reset();
+}
+
+void UWRBulletSubsystem::RemoveDeadBullets()
+{
+	// Back to front, so the bullet swapped into a removed slot has already been checked
+	for (int32 i = Bullets.Num() - 1; i >= 0; i--)
+	{
+		if ((DeadBullets.IsValidIndex(i) && DeadBullets[i]) || Bullets.LifeRemaining[i] <= 0.0f)
+		{
+			Bullets.RemoveAtSwap(i);
+		}
+	}
+	DeadBullets.Reset();
+}
+
+void UWRBulletSubsystem::UpdateTrails()
+{
+	if (!TrailComponent && TrailSystem)
+	{
+		TrailComponent = UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), TrailSystem, FVector::ZeroVector, FRotator::ZeroRotator,
+			FVector::OneVector, false);
+	}
+	if (!TrailComponent)
+	{
+		return;
+	}
+
+	// Nothing to send while no bullet is or was just in flight
+	if (Bullets.Num() == 0 && TrailPositions.Num() == 0)
+	{
+		return;
+	}
+
+	TrailPositions.SetNumUninitialized(Bullets.Num(), EAllowShrinking::No);
+	TrailVelocities.SetNumUninitialized(Bullets.Num(), EAllowShrinking::No);
+	for (int32 i = 0; i < Bullets.Num(); i++)
+	{
+		TrailPositions[i] = Bullets.GetPosition(i);
+		TrailVelocities[i] = Bullets.GetVelocity(i);
+	}
+	UNiagaraDataInterfaceArrayFunctionLibrary::SetNiagaraArrayPosition(TrailComponent, TrailPositionsName, TrailPositions);
+	UNiagaraDataInterfaceArrayFunctionLibrary::SetNiagaraArrayVector(TrailComponent, TrailVelocitiesName, TrailVelocities);
+}
+
+#if !UE_BUILD_SHIPPING
+static FAutoConsoleCommand BenchBulletTracesCommand(
+	TEXT("wr.Bench.BulletTraces"),
+	TEXT("Benchmarks game-thread bullet trace cost for 8 karts x 5 pellets x 10 shots/s, synchronous against async"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (UWRBulletSubsystem* Subsystem = UWRBulletSubsystem::GetInstance(World))
+		{
+			StartTraceBenchmark(Subsystem);
+		}
+		else
+		{
+			UE_LOG(LogWastelandRacers, Display, TEXT("BulletTraces: skipped, needs a game world"));
+		}
+	}));
+
+// The integration loop alone, at counts from a busy race to far beyond it
+static FAutoConsoleCommand BenchBulletsCommand(
+	TEXT("wr.Bench.Bullets"),
+	TEXT("Benchmarks bullet integration for 256 to 16384 bullets"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		const int32 NumTicks = 1000;
+
+		for (int32 NumBullets : { 256, 1024, 4096, 16384 })
+		{
+			FRandomStream Random(1234);
+			FWRBulletBatch Batch;
+			Batch.Reserve(NumBullets);
+			for (int32 i = 0; i < NumBullets; i++)
+			{
+				Batch.Add(FVector(Random.FRandRange(-20000.0f, 20000.0f), Random.FRandRange(-20000.0f, 20000.0f), 100.0f),
+					Random.GetUnitVector() * 2500.0f, 0.1f, 25.0f, 5.0f, nullptr);
+			}
+
+			const uint64 Start = FPlatformTime::Cycles64();
+			for (int32 Tick = 0; Tick < NumTicks; Tick++)
+			{
+				Batch.Integrate(1.0f / 60.0f, -980.0f);
+			}
+			const uint64 Cycles = FPlatformTime::Cycles64() - Start;
+
+			const double Ns = FPlatformTime::ToMilliseconds64(Cycles) * 1.0e6 / (double)(NumTicks * NumBullets);
+			UE_LOG(LogWastelandRacers, Display, TEXT("Bullets: %5d bullets, %.2f ns/bullet, %.4f ms per tick (checksum %.0f)"),
+				NumBullets, Ns, Ns * NumBullets * 1.0e-6, Batch.PositionZ[0]);
+		}
+	}));
+#endif
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "WRBulletSubsystem.generated.h"
+
+// Light rounds as flat arrays. Integrate advances every bullet in one straight loop and keeps the
+// previous positions, so hits can be resolved afterwards as swept segments.
+struct WASTELANDRACERS_API FWRBulletBatch
+{
+	TArray<float> PositionX, PositionY, PositionZ;
+	TArray<float> PreviousX, PreviousY, PreviousZ;
+	TArray<float> VelocityX, VelocityY, VelocityZ;
+	TArray<float> GravityScale;
+	TArray<float> Damage;
+	TArray<float> LifeRemaining;
+	TArray<TWeakObjectPtr<AActor>> Owners;
+
+	int32 Num() const { return LifeRemaining.Num(); }
+	void Reserve(int32 MaxBullets);
+	void Add(const FVector& Position, const FVector& Velocity, float InGravityScale, float InDamage, float LifeSpan, AActor* Owner);
+	void RemoveAtSwap(int32 Index);
+	void Empty();
+
+	FVector GetPosition(int32 Index) const { return FVector(PositionX[Index], PositionY[Index], PositionZ[Index]); }
+	FVector GetPrevious(int32 Index) const { return FVector(PreviousX[Index], PreviousY[Index], PreviousZ[Index]); }
+	FVector GetVelocity(int32 Index) const { return FVector(VelocityX[Index], VelocityY[Index], VelocityZ[Index]); }
+
+	void Integrate(float DeltaTime, float GravityZ);
+};
+
+// One bullet segment or hitscan shot waiting on its world trace. The kart it passes through, if any,
+// is already known; the trace only runs up to it, so a world hit means a wall was in the way.
+struct FWRPendingShot
+{
+	FTraceHandle Trace;
+	FVector Start = FVector::ZeroVector;
+	FVector End = FVector::ZeroVector;
+	TWeakObjectPtr<class AWRKart> Kart;
+	TWeakObjectPtr<AActor> Owner;
+	float Damage = 0.0f;
+
+	// Slot in the bullet batch, or INDEX_NONE for hitscan
+	int32 BulletIndex = INDEX_NONE;
+};
+
+// Machine gun, shotgun and flamethrower rounds without an actor each. Every tick the bullets are
+// integrated together, swept against karts through the kart spatial hash, and every world trace
+// for the frame, from every kart, is submitted in one async batch and resolved the next tick.
+// They are drawn by a single shared Niagara system fed from arrays. Rockets and grenades stay
+// AWRProjectile actors.
+UCLASS()
+class WASTELANDRACERS_API UWRBulletSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UWRBulletSubsystem* GetInstance(const UObject* WorldContext);
+
+	// Whether weapons should fire light rounds through this subsystem (wr.Bullets.Enable)
+	static bool IsEnabled();
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// False when wr.Bullets.Max rounds are already in flight
+	bool FireBullet(const FVector& Origin, const FVector& Velocity, float GravityScale, float Damage, float LifeSpan, AActor* Owner);
+
+	// Instant shot resolved with the next batch of bullet traces, for hitscan weapons
+	void FireHitscan(const FVector& Start, const FVector& End, float Damage, AActor* Owner);
+
+	// The first systems set are shared by every bullet; later calls are ignored
+	void SetEffects(class UNiagaraSystem* InTrailSystem, class UNiagaraSystem* InImpactEffect);
+
+	int32 GetNumBullets() const { return Bullets.Num(); }
+
+private:
+	FWRBulletBatch Bullets;
+
+	UPROPERTY()
+	class UNiagaraSystem* TrailSystem = nullptr;
+
+	UPROPERTY()
+	class UNiagaraSystem* ImpactEffect = nullptr;
+
+	UPROPERTY()
+	class UNiagaraComponent* TrailComponent = nullptr;
+
+	// Hitscan shots fired since the last submission
+	TArray<FWRPendingShot> QueuedHitscans;
+
+	// Traces submitted last tick; bullet slots stay put until these are resolved, as firing only appends
+	TArray<FWRPendingShot> PendingShots;
+
+	// Scratch reused every tick
+	TArray<uint8> DeadBullets;
+	TArray<FVector> TrailPositions;
+	TArray<FVector> TrailVelocities;
+
+	void SubmitShots(bool bAsync);
+	void AddShot(FWRPendingShot&& Shot, bool bAsync, const class UWRKartSpatialSubsystem* Spatial);
+	void ResolveShots();
+	void RemoveDeadBullets();
+	void UpdateTrails();
+};
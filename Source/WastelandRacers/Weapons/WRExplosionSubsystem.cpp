@@ -0,0 +1,178 @@
+#include "WRExplosionSubsystem.h"
+#include "WastelandRacers/WastelandRacers.h"
+#include "WastelandRacers/Vehicles/WRKart.h"
+#include "WastelandRacers/Tracks/WRTrackHazard.h"
+#include "WastelandRacers/Core/WRGameplayProfiler.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarExplosionsMaxPerFrame(
+	TEXT("wr.Explosions.MaxPerFrame"),
+	16,
+	TEXT("Most queued explosions resolved in one frame; the rest, and any they set off, wait for the next."),
+	ECVF_Default);
+
+// Barrels are sparse along the track, so cells can be large
+static const float ExplosiveCellSize = 1000.0f;
+
+UWRExplosionSubsystem* UWRExplosionSubsystem::GetInstance(const UObject* WorldContext)
+{
+	if (const UWorld* World = GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::ReturnNull))
+	{
+		return World->GetSubsystem<UWRExplosionSubsystem>();
+	}
+	return nullptr;
+}
+
+bool UWRExplosionSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UWRExplosionSubsystem::Deinitialize()
+{
+	Queue.Empty();
+	Resolving.Empty();
+	Explosives.Empty();
+	ExplosiveLocations.Empty();
+	HitKarts.Empty();
+	Super::Deinitialize();
+}
+
+TStatId UWRExplosionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UWRExplosionSubsystem, STATGROUP_Tickables);
+}
+
+void UWRExplosionSubsystem::QueueExplosion(const FVector& Location, float Radius, float Damage, float Impulse)
+{
+	if (Radius <= 0.0f)
+	{
+		return;
+	}
+
+	FWRExplosion& Explosion = Queue.AddDefaulted_GetRef();
+	Explosion.Location = Location;
+	Explosion.Radius = Radius;
+	Explosion.Damage = Damage;
+	Explosion.Impulse = Impulse;
+}
+
+void UWRExplosionSubsystem::RegisterExplosive(AWRTrackHazard* Explosive)
+{
+	if (Explosive && !Explosives.Contains(Explosive))
+	{
+		Explosives.Add(Explosive);
+		bExplosivesDirty = true;
+	}
+}
+
+void UWRExplosionSubsystem::UnregisterExplosive(AWRTrackHazard* Explosive)
+{
+	if (Explosives.RemoveSingleSwap(Explosive, EAllowShrinking::No) > 0)
+	{
+		bExplosivesDirty = true;
+	}
+}
+
+void UWRExplosionSubsystem::Tick(float DeltaTime)
+{
+	WR_PROFILE_SCOPE(Projectiles);
+
+	if (Queue.Num() == 0)
+	{
+		return;
+	}
+
+	// Taken off the queue first, so barrels set off below queue behind everything already waiting
+	const int32 NumToResolve = FMath::Min(Queue.Num(), FMath::Max(1, CVarExplosionsMaxPerFrame.GetValueOnGameThread()));
+	Resolving.Reset();
+	Resolving.Append(Queue.GetData(), NumToResolve);
+	Queue.RemoveAt(0, NumToResolve, EAllowShrinking::No);
+
+	HitKarts.Reset();
+	HitDamage.Reset();
+	HitImpulses.Reset();
+
+	const UWRKartSpatialSubsystem* Spatial = UWRKartSpatialSubsystem::GetInstance(this);
+	for (const FWRExplosion& Explosion : Resolving)
+	{
+		if (Spatial)
+		{
+			AWRKart* Candidates[16];
+			const int32 NumCandidates = Spatial->QueryRadius(Explosion.Location, Explosion.Radius, Candidates);
+			for (int32 c = 0; c < NumCandidates; c++)
+			{
+				AWRKart* Kart = Candidates[c];
+				const FVector Offset = Kart->GetActorLocation() - Explosion.Location;
+				const float Falloff = 1.0f - FMath::Min(Offset.Size() / Explosion.Radius, 1.0f);
+
+				int32 HitIndex = HitKarts.Find(Kart);
+				if (HitIndex == INDEX_NONE)
+				{
+					HitIndex = HitKarts.Add(Kart);
+					HitDamage.Add(0.0f);
+					HitImpulses.Add(FVector::ZeroVector);
+				}
+				HitDamage[HitIndex] += Explosion.Damage * Falloff;
+				HitImpulses[HitIndex] += Offset.GetSafeNormal() * Explosion.Impulse * Falloff;
+			}
+		}
+
+		DetonateExplosives(Explosion);
+	}
+
+	for (int32 i = 0; i < HitKarts.Num(); i++)
+	{
+		if (!IsValid(HitKarts[i]))
+		{
+			continue;
+		}
+
+		if (HitDamage[i] > 0.0f)
+		{
+			HitKarts[i]->TakeDamage(HitDamage[i]);
+		}
+		if (!HitImpulses[i].IsNearlyZero())
+		{
+			HitKarts[i]->ApplyKnockback(HitImpulses[i]);
+		}
+	}
+
+	if (Queue.Num() > 0)
+	{
+		UE_LOG(LogWastelandRacers, Verbose, TEXT("Explosions: %d resolved, %d carried to the next frame"), NumToResolve, Queue.Num());
+	}
+}
+
+void UWRExplosionSubsystem::DetonateExplosives(const FWRExplosion& Explosion)
+{
+	if (Explosives.Num() == 0)
+	{
+		return;
+	}
+
+	if (bExplosivesDirty)
+	{
+		ExplosiveLocations.SetNumUninitialized(Explosives.Num(), EAllowShrinking::No);
+		for (int32 i = 0; i < Explosives.Num(); i++)
+		{
+			ExplosiveLocations[i] = IsValid(Explosives[i]) ? Explosives[i]->GetActorLocation() : FVector::ZeroVector;
+		}
+		ExplosiveHash.Build(ExplosiveLocations, ExplosiveCellSize);
+		bExplosivesDirty = false;
+	}
+
+	// A barrel only goes off once per activation, so chains end when every barrel in reach has blown
+	int32 Indices[16];
+	const int32 NumFound = ExplosiveHash.QueryRadius(Explosion.Location, Explosion.Radius, Indices);
+	for (int32 i = 0; i < NumFound; i++)
+	{
+		AWRTrackHazard* Explosive = Explosives[Indices[i]];
+		if (IsValid(Explosive))
+		{
+			Explosive->Detonate();
+		}
+	}
+}
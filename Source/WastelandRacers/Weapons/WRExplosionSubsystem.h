@@ -0,0 +1,62 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WastelandRacers/Gameplay/WRKartSpatialHash.h"
+#include "WRExplosionSubsystem.generated.h"
+
+struct FWRExplosion
+{
+	FVector Location = FVector::ZeroVector;
+	float Radius = 0.0f;
+
+	// At the centre, falling off linearly to nothing at Radius
+	float Damage = 0.0f;
+	float Impulse = 0.0f;
+};
+
+// Area damage for grenades, rockets and explosive barrels. Explosions are queued as they happen and
+// resolved together once the frame's actors have ticked: karts in range come from the kart spatial
+// hash, and each kart takes the sum of its damage and knockback once. Explosive barrels in range
+// detonate in turn, but their explosions wait for a later pass, and each pass resolves at most
+// wr.Explosions.MaxPerFrame, so a chain ripples over several frames instead of landing in one.
+UCLASS()
+class WASTELANDRACERS_API UWRExplosionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UWRExplosionSubsystem* GetInstance(const UObject* WorldContext);
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void QueueExplosion(const FVector& Location, float Radius, float Damage, float Impulse);
+
+	// Explosive barrels, set off by any explosion that reaches them
+	void RegisterExplosive(class AWRTrackHazard* Explosive);
+	void UnregisterExplosive(class AWRTrackHazard* Explosive);
+
+	int32 GetNumQueued() const { return Queue.Num(); }
+
+private:
+	TArray<FWRExplosion> Queue;
+
+	UPROPERTY()
+	TArray<class AWRTrackHazard*> Explosives;
+
+	// Barrels do not move, so the hash is only rebuilt when one is added or removed
+	FWRKartSpatialHash ExplosiveHash;
+	TArray<FVector> ExplosiveLocations;
+	bool bExplosivesDirty = false;
+
+	// Scratch reused every tick: this pass's explosions, and every kart they hit with its totals
+	TArray<FWRExplosion> Resolving;
+	TArray<class AWRKart*> HitKarts;
+	TArray<float> HitDamage;
+	TArray<FVector> HitImpulses;
+
+	void DetonateExplosives(const FWRExplosion& Explosion);
+};
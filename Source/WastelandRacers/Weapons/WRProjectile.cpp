@@ -1,6 +1,8 @@
 #include "WRProjectile.h"
 #include "WastelandRacers/WastelandRacers.h"
 #include "WastelandRacers/Vehicles/WRKart.h"
+#include "WastelandRacers/Weapons/WRExplosionSubsystem.h"
+#include "WastelandRacers/Core/WRGameplayProfiler.h"
 #include "Components/SphereComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "GameFramework/ProjectileMovementComponent.h"
@@ -51,37 +53,54 @@ void AWRProjectile::BeginPlay()
 {
 	Super::BeginPlay();
 	
-	// Adjust projectile properties based on weapon type
-	switch (WeaponType)
+	ApplyWeaponType();
+
+	UE_LOG(LogWastelandRacers, Log, TEXT("Projectile spawned with weapon type: %d"), (int32)WeaponType);
+}
+
+void AWRProjectile::LifeSpanExpired()
+{
+	UWRActorPoolSubsystem::ReleaseOrDestroy(this);
+}
+
+void AWRProjectile::ResetForReuse()
+{
+	bHasExploded = false;
+	CollisionComponent->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+	ProjectileMesh->SetVisibility(true);
+	if (TrailEffect)
 	{
-		case EWeaponType::MachineGun:
-			ProjectileMovement->InitialSpeed = 2500.0f;
-			ProjectileMovement->MaxSpeed = 2500.0f;
-			ProjectileMovement->ProjectileGravityScale = 0.1f;
-			break;
-		case EWeaponType::RocketLauncher:
-			ProjectileMovement->InitialSpeed = 1500.0f;
-			ProjectileMovement->MaxSpeed = 1500.0f;
-			ProjectileMovement->ProjectileGravityScale = 0.3f;
-			break;
-		case EWeaponType::Shotgun:
-			ProjectileMovement->InitialSpeed = 1800.0f;
-			ProjectileMovement->MaxSpeed = 1800.0f;
-			ProjectileMovement->ProjectileGravityScale = 0.5f;
-			break;
-		case EWeaponType::Flamethrower:
-			ProjectileMovement->InitialSpeed = 800.0f;
-			ProjectileMovement->MaxSpeed = 800.0f;
-			ProjectileMovement->ProjectileGravityScale = 1.0f;
-			InitialLifeSpan = 1.0f; // Short range
-			break;
+		TrailEffect->Activate(true);
 	}
 
-	UE_LOG(LogWastelandRacers, Log, TEXT("Projectile spawned with weapon type: %d"), (int32)WeaponType);
+	// A blocking hit stops the movement simulating and detaches it from the root
+	ProjectileMovement->SetUpdatedComponent(CollisionComponent);
+	ProjectileMovement->Velocity = GetActorForwardVector();
+	ApplyWeaponType();
+}
+
+void AWRProjectile::SetWeaponType(EWeaponType NewWeaponType)
+{
+	WeaponType = NewWeaponType;
+	ApplyWeaponType();
+}
+
+void AWRProjectile::ApplyWeaponType()
+{
+	// Adjust projectile properties based on weapon type
+	const FWRBallistics Ballistics = FWRBallistics::Get(WeaponType);
+	ProjectileMovement->InitialSpeed = Ballistics.Speed;
+	ProjectileMovement->MaxSpeed = Ballistics.Speed;
+	ProjectileMovement->ProjectileGravityScale = Ballistics.GravityScale;
+
+	// Set after spawn or reuse, so keep the heading and change only the speed
+	ProjectileMovement->Velocity = ProjectileMovement->Velocity.GetSafeNormal() * ProjectileMovement->InitialSpeed;
+	SetLifeSpan(FMath::Min(LifeSpan, Ballistics.LifeSpan));
 }
 
 void AWRProjectile::Tick(float DeltaTime)
 {
+	WR_PROFILE_SCOPE(Projectiles);
 	Super::Tick(DeltaTime);
 }
 
@@ -205,21 +224,12 @@ void AWRProjectile::CreateExplosion()
 		}
 	}
 
-	// Apply area damage for rocket explosions
+	// Apply area damage for rocket explosions, resolved with the frame's other explosions
 	if (WeaponType == EWeaponType::RocketLauncher)
 	{
-		UGameplayStatics::ApplyRadialDamage(
-			GetWorld(),
-			Damage * 0.7f, // Reduced damage for area effect
-			GetActorLocation(),
-			300.0f, // Explosion radius
-			UDamageType::StaticClass(),
-			TArray<AActor*>(), // Ignore list
-			this,
-			nullptr,
-			true // Full damage at center
-		);
-		
-		UE_LOG(LogWastelandRacers, Log, TEXT("Created explosion at location: %s with radius damage"), *GetActorLocation().ToString());
+		if (UWRExplosionSubsystem* Explosions = UWRExplosionSubsystem::GetInstance(this))
+		{
+			Explosions->QueueExplosion(GetActorLocation(), ExplosionRadius, Damage * ExplosionDamageScale, ExplosionImpulse);
+		}
 	}
 }
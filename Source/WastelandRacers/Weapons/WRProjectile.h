@@ -6,10 +6,11 @@
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "Components/SphereComponent.h"
 #include "WastelandRacers/Weapons/WRWeaponComponent.h"
+#include "WastelandRacers/Core/WRActorPool.h"
 #include "WRProjectile.generated.h"
 
 UCLASS()
-class WASTELANDRACERS_API AWRProjectile : public AActor
+class WASTELANDRACERS_API AWRProjectile : public AActor, public IWRPooledActor
 {
 	GENERATED_BODY()
 
@@ -19,8 +20,12 @@ public:
 protected:
 	virtual void BeginPlay() override;
 
+	// Back to the pool rather than destroyed
+	virtual void LifeSpanExpired() override;
+
 public:
 	virtual void Tick(float DeltaTime) override;
+	virtual void ResetForReuse() override;
 
 	UFUNCTION()
 	void OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
@@ -29,7 +34,7 @@ public:
 	void SetDamage(float NewDamage) { Damage = NewDamage; }
 
 	UFUNCTION(BlueprintCallable, Category = "Projectile")
-	void SetWeaponType(EWeaponType NewWeaponType) { WeaponType = NewWeaponType; }
+	void SetWeaponType(EWeaponType NewWeaponType);
 
 	UFUNCTION(BlueprintPure, Category = "Projectile")
 	float GetDamage() const { return Damage; }
@@ -62,6 +67,18 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile")
 	EWeaponType WeaponType = EWeaponType::MachineGun;
 
+	// Rocket launcher rounds only; damage and knockback fall off linearly to nothing at the radius
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Explosion")
+	float ExplosionRadius = 300.0f;
+
+	// Fraction of Damage dealt at the centre of the explosion
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Explosion", meta = (ClampMin = "0.0"))
+	float ExplosionDamageScale = 0.7f;
+
+	// Knockback velocity at the centre of the explosion
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Explosion")
+	float ExplosionImpulse = 1500.0f;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Effects")
 	TSubclassOf<class AActor> ExplosionEffect;
 
@@ -74,6 +91,7 @@ protected:
 private:
 	bool bHasExploded = false;
 	
+	void ApplyWeaponType();
 	void ApplyDamageToTarget(AActor* Target);
 	void CreateExplosion();
 	virtual void OnImpact(const FHitResult& HitResult);
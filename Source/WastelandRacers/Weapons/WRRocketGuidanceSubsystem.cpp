@@ -0,0 +1,251 @@
+#include "WRRocketGuidanceSubsystem.h"
+#include "WastelandRacers/WastelandRacers.h"
+#include "WastelandRacers/Weapons/Projectiles/WRHomingRocket.h"
+#include "WastelandRacers/Vehicles/WRKart.h"
+#include "WastelandRacers/Gameplay/WRRaceManager.h"
+#include "WastelandRacers/Gameplay/WRRaceWorldSubsystem.h"
+#include "WastelandRacers/Core/WRGameplayProfiler.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+void FWRRocketGuidanceBatch::SetNum(int32 NumRockets)
+{
+	for (TArray<FVector>* Array : { &Locations, &Velocities, &NewVelocities })
+	{
+		Array->SetNumUninitialized(NumRockets, EAllowShrinking::No);
+	}
+	for (TArray<float>* Array : { &Speeds, &MaxTurnRates, &MaxDistancesSq })
+	{
+		Array->SetNumUninitialized(NumRockets, EAllowShrinking::No);
+	}
+	Targets.SetNumUninitialized(NumRockets, EAllowShrinking::No);
+}
+
+bool FWRRocketGuidanceBatch::SolveIntercept(const FVector& RelativeLocation, const FVector& TargetVelocity, float Speed, float& OutTime)
+{
+	// |P + V t| = S t, as A t^2 + B t + C = 0
+	const float A = TargetVelocity.SizeSquared() - FMath::Square(Speed);
+	const float B = 2.0f * FVector::DotProduct(RelativeLocation, TargetVelocity);
+	const float C = RelativeLocation.SizeSquared();
+
+	// Target exactly as fast as the rocket: one root, there only when it is closing
+	if (FMath::Abs(A) < KINDA_SMALL_NUMBER)
+	{
+		if (B >= 0.0f)
+		{
+			return false;
+		}
+		OutTime = -C / B;
+		return true;
+	}
+
+	const float Discriminant = B * B - 4.0f * A * C;
+	if (Discriminant < 0.0f)
+	{
+		return false;
+	}
+
+	const float Root = FMath::Sqrt(Discriminant);
+	const float InvTwoA = 0.5f / A;
+	const float Time0 = (-B - Root) * InvTwoA;
+	const float Time1 = (-B + Root) * InvTwoA;
+	const float Earliest = FMath::Min(Time0, Time1);
+	OutTime = Earliest >= 0.0f ? Earliest : FMath::Max(Time0, Time1);
+	return OutTime >= 0.0f;
+}
+
+FVector FWRRocketGuidanceBatch::TurnTowards(const FVector& Current, const FVector& Desired, float MaxAngle)
+{
+	float SinMax, CosMax;
+	FMath::SinCos(&SinMax, &CosMax, MaxAngle);
+
+	const float CosAngle = FVector::DotProduct(Current, Desired);
+	if (CosAngle >= CosMax)
+	{
+		return Desired;
+	}
+
+	// Rotate in the plane of the two; straight behind has no plane, so turn about the vertical
+	FVector Perpendicular = (Desired - Current * CosAngle).GetSafeNormal();
+	if (Perpendicular.IsZero())
+	{
+		Perpendicular = FVector::CrossProduct(FVector::UpVector, Current).GetSafeNormal();
+	}
+	return Current * CosMax + Perpendicular * SinMax;
+}
+
+void FWRRocketGuidanceBatch::Guide(float DeltaTime)
+{
+	const int32 NumRockets = Num();
+	for (int32 i = 0; i < NumRockets; i++)
+	{
+		NewVelocities[i] = Velocities[i];
+
+		const int32 Target = Targets[i];
+		const FVector ToTarget = KartLocations[Target] - Locations[i];
+		if (ToTarget.SizeSquared() > MaxDistancesSq[i])
+		{
+			continue;
+		}
+
+		// Fly straight at the kart when it cannot be caught, so it is still chased
+		float Time;
+		const FVector AimPoint = SolveIntercept(ToTarget, KartVelocities[Target], Speeds[i], Time) ? ToTarget + KartVelocities[Target] * Time : ToTarget;
+		const FVector Desired = AimPoint.GetSafeNormal();
+		if (Desired.IsZero())
+		{
+			continue;
+		}
+
+		const FVector Current = Velocities[i].GetSafeNormal();
+		const FVector Direction = Current.IsZero() ? Desired : TurnTowards(Current, Desired, MaxTurnRates[i] * DeltaTime);
+		NewVelocities[i] = Direction * Speeds[i];
+	}
+}
+
+UWRRocketGuidanceSubsystem* UWRRocketGuidanceSubsystem::GetInstance(const UObject* WorldContext)
+{
+	if (const UWorld* World = GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::ReturnNull))
+	{
+		return World->GetSubsystem<UWRRocketGuidanceSubsystem>();
+	}
+	return nullptr;
+}
+
+bool UWRRocketGuidanceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UWRRocketGuidanceSubsystem::Deinitialize()
+{
+	Rockets.Empty();
+	GuidedRockets.Empty();
+	SnapshotKarts.Empty();
+	Super::Deinitialize();
+}
+
+TStatId UWRRocketGuidanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UWRRocketGuidanceSubsystem, STATGROUP_Tickables);
+}
+
+void UWRRocketGuidanceSubsystem::RegisterRocket(AWRHomingRocket* Rocket)
+{
+	if (Rocket)
+	{
+		Rockets.AddUnique(Rocket);
+	}
+}
+
+void UWRRocketGuidanceSubsystem::UnregisterRocket(AWRHomingRocket* Rocket)
+{
+	Rockets.RemoveSingleSwap(Rocket, EAllowShrinking::No);
+}
+
+void UWRRocketGuidanceSubsystem::Tick(float DeltaTime)
+{
+	WR_PROFILE_SCOPE(Projectiles);
+
+	if (Rockets.Num() == 0)
+	{
+		return;
+	}
+
+	const UWRRaceWorldSubsystem* RaceWorld = UWRRaceWorldSubsystem::GetInstance(this);
+	const AWRRaceManager* RaceManager = RaceWorld ? RaceWorld->GetRaceManager() : nullptr;
+	const float WorldTime = GetWorld()->GetTimeSeconds();
+
+	GuidedRockets.Reset();
+	for (int32 i = Rockets.Num() - 1; i >= 0; i--)
+	{
+		// Prewarmed or released rockets sit hidden in the actor pool
+		AWRHomingRocket* Rocket = Rockets[i];
+		if (!IsValid(Rocket) || Rocket->HasExploded() || Rocket->IsHidden())
+		{
+			Rockets.RemoveAtSwap(i, 1, EAllowShrinking::No);
+			continue;
+		}
+
+		if (Rocket->CanHome(WorldTime) && (Rocket->KeepTarget(WorldTime) || Rocket->AcquireTarget(RaceManager)))
+		{
+			GuidedRockets.Add(Rocket);
+		}
+	}
+
+	// Each targeted kart is read once, however many rockets chase it
+	SnapshotKarts.Reset();
+	Batch.KartLocations.Reset();
+	Batch.KartVelocities.Reset();
+	Batch.SetNum(GuidedRockets.Num());
+	for (int32 i = 0; i < GuidedRockets.Num(); i++)
+	{
+		AWRKart* Target = GuidedRockets[i]->GetTarget();
+		int32 KartIndex = SnapshotKarts.Find(Target);
+		if (KartIndex == INDEX_NONE)
+		{
+			KartIndex = SnapshotKarts.Add(Target);
+			Batch.KartLocations.Add(Target->GetActorLocation());
+			Batch.KartVelocities.Add(Target->GetVelocity());
+		}
+		GuidedRockets[i]->GatherGuidanceState(Batch, i, KartIndex);
+	}
+
+	Batch.Guide(DeltaTime);
+
+	for (int32 i = 0; i < GuidedRockets.Num(); i++)
+	{
+		GuidedRockets[i]->ApplyGuidanceOutputs(Batch, i);
+	}
+}
+
+#if !UE_BUILD_SHIPPING
+// 32 rockets spread over 8 karts weaving across the track, the most a full grid could have in flight
+static FAutoConsoleCommand BenchRocketGuidanceCommand(
+	TEXT("wr.Bench.RocketGuidance"),
+	TEXT("Benchmarks the batched homing rocket guidance pass for 8 to 64 rockets"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		const int32 NumTicks = 10000;
+		const int32 NumKarts = 8;
+
+		for (int32 NumRockets : { 8, 32, 64 })
+		{
+			FRandomStream Random(1234);
+			FWRRocketGuidanceBatch Batch;
+			for (int32 k = 0; k < NumKarts; k++)
+			{
+				Batch.KartLocations.Add(FVector(Random.FRandRange(0.0f, 10000.0f), Random.FRandRange(-500.0f, 500.0f), 0.0f));
+				Batch.KartVelocities.Add(FVector(Random.FRandRange(1500.0f, 3000.0f), Random.FRandRange(-300.0f, 300.0f), 0.0f));
+			}
+
+			Batch.SetNum(NumRockets);
+			for (int32 r = 0; r < NumRockets; r++)
+			{
+				Batch.Locations[r] = FVector(Random.FRandRange(-2000.0f, 8000.0f), Random.FRandRange(-500.0f, 500.0f), 50.0f);
+				Batch.Velocities[r] = FVector(800.0f, 0.0f, 0.0f);
+				Batch.Targets[r] = r % NumKarts;
+				Batch.Speeds[r] = 800.0f;
+				Batch.MaxTurnRates[r] = FMath::DegreesToRadians(120.0f);
+				Batch.MaxDistancesSq[r] = FMath::Square(20000.0f);
+			}
+
+			double Checksum = 0.0;
+			const uint64 Start = FPlatformTime::Cycles64();
+			for (int32 Tick = 0; Tick < NumTicks; Tick++)
+			{
+				Batch.Guide(1.0f / 60.0f);
+				Swap(Batch.Velocities, Batch.NewVelocities);
+				Checksum += Batch.Velocities[Tick % NumRockets].Y;
+			}
+			const uint64 Cycles = FPlatformTime::Cycles64() - Start;
+
+			const double Ns = FPlatformTime::ToMilliseconds64(Cycles) * 1.0e6 / (double)(NumTicks * NumRockets);
+			UE_LOG(LogWastelandRacers, Display, TEXT("RocketGuidance: %2d rockets, %.1f ns/rocket, %.4f ms per tick (checksum %.0f)"),
+				NumRockets, Ns, Ns * NumRockets * 1.0e-6, Checksum);
+		}
+	}));
+#endif
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WRRocketGuidanceSubsystem.generated.h"
+
+// Steering for every homing rocket in flat arrays. Rockets fill the inputs in a gather pass, Guide
+// aims each at the intercept point with its target kart and turns it towards it at a limited rate,
+// and rockets apply the new velocities afterwards.
+struct WASTELANDRACERS_API FWRRocketGuidanceBatch
+{
+	// Every targeted kart, read once per pass
+	TArray<FVector> KartLocations;
+	TArray<FVector> KartVelocities;
+
+	// Inputs; Target is a slot in the kart snapshot
+	TArray<FVector> Locations;
+	TArray<FVector> Velocities;
+	TArray<int32> Targets;
+	TArray<float> Speeds;
+	TArray<float> MaxTurnRates;
+	TArray<float> MaxDistancesSq;
+
+	// Output
+	TArray<FVector> NewVelocities;
+
+	void SetNum(int32 NumRockets);
+	int32 Num() const { return Targets.Num(); }
+
+	void Guide(float DeltaTime);
+
+	// Earliest time a rocket at the origin flying at Speed meets a target at RelativeLocation moving at
+	// TargetVelocity. False when the target outruns it.
+	static bool SolveIntercept(const FVector& RelativeLocation, const FVector& TargetVelocity, float Speed, float& OutTime);
+
+	// Current rotated towards Desired (both unit length) by at most MaxAngle radians
+	static FVector TurnTowards(const FVector& Current, const FVector& Desired, float MaxAngle);
+};
+
+// Updates all live homing rockets in one pass per tick instead of each rocket ticking itself.
+// Rockets register while in flight; targets are picked by race order when none was set, and
+// re-picked once the current one has been out of range for a while.
+UCLASS()
+class WASTELANDRACERS_API UWRRocketGuidanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UWRRocketGuidanceSubsystem* GetInstance(const UObject* WorldContext);
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterRocket(class AWRHomingRocket* Rocket);
+	void UnregisterRocket(class AWRHomingRocket* Rocket);
+
+	int32 GetNumRockets() const { return Rockets.Num(); }
+
+private:
+	UPROPERTY()
+	TArray<class AWRHomingRocket*> Rockets;
+
+	FWRRocketGuidanceBatch Batch;
+
+	// Scratch reused every tick: the rockets gathered into the batch, and the karts they target
+	TArray<class AWRHomingRocket*> GuidedRockets;
+	TArray<class AWRKart*> SnapshotKarts;
+};
@@ -1,11 +1,42 @@
 #include "WRWeaponComponent.h"
 #include "WastelandRacers/WastelandRacers.h"
 #include "WastelandRacers/Weapons/WRProjectile.h"
+#include "WastelandRacers/Core/WRGameplayProfiler.h"
+#include "WastelandRacers/Core/WRGameplayClock.h"
+#include "WastelandRacers/Core/WRActorPool.h"
+#include "WastelandRacers/Weapons/WRBulletSubsystem.h"
+#include "WastelandRacers/Replay/WRReplaySubsystem.h"
 #include "Engine/World.h"
 #include "GameFramework/Actor.h"
 #include "Components/StaticMeshComponent.h"
 #include "Kismet/KismetMathLibrary.h"
 
+FWRBallistics FWRBallistics::Get(EWeaponType WeaponType)
+{
+	FWRBallistics Ballistics;
+	switch (WeaponType)
+	{
+		case EWeaponType::MachineGun:
+			Ballistics.Speed = 2500.0f;
+			Ballistics.GravityScale = 0.1f;
+			break;
+		case EWeaponType::RocketLauncher:
+			Ballistics.Speed = 1500.0f;
+			Ballistics.GravityScale = 0.3f;
+			break;
+		case EWeaponType::Shotgun:
+			Ballistics.Speed = 1800.0f;
+			Ballistics.GravityScale = 0.5f;
+			break;
+		case EWeaponType::Flamethrower:
+			Ballistics.Speed = 800.0f;
+			Ballistics.GravityScale = 1.0f;
+			Ballistics.LifeSpan = 1.0f; // Short range
+			break;
+	}
+	return Ballistics;
+}
+
 UWRWeaponComponent::UWRWeaponComponent()
 {
 	PrimaryComponentTick.bCanEverTick = true;
@@ -16,17 +47,56 @@ void UWRWeaponComponent::BeginPlay()
 {
 	Super::BeginPlay();
 	CurrentAmmo = MaxAmmo;
+	RandomStream = FWRGameplayRandom::MakeStream(GetOwner());
+
+	// Shots come out of the pool, so spawning happens here at level load rather than mid-race
+	if (UWRActorPoolSubsystem* Pool = UWRActorPoolSubsystem::GetInstance(this))
+	{
+		Pool->Prewarm(ProjectileClass, PrewarmProjectiles);
+	}
+
+	if (UWRBulletSubsystem* Bullets = UWRBulletSubsystem::GetInstance(this))
+	{
+		Bullets->SetEffects(BulletTrailSystem, BulletImpactEffect);
+	}
+
+	// The clock drives reloads once registered, so the component tick is only a fallback
+	if (UWRGameplayClock* Clock = UWRGameplayClock::GetInstance(this))
+	{
+		FixedStepHandle = Clock->Register(EWRFixedStepPhase::Weapons, FWROnFixedStep::FDelegate::CreateUObject(this, &UWRWeaponComponent::FixedStep));
+		SetComponentTickEnabled(false);
+	}
+}
+
+void UWRWeaponComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UWRGameplayClock* Clock = UWRGameplayClock::GetInstance(this))
+	{
+		Clock->Unregister(EWRFixedStepPhase::Weapons, FixedStepHandle);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void UWRWeaponComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
+	if (!FixedStepHandle.IsValid())
+	{
+		FixedStep(DeltaTime);
+	}
+}
+
+void UWRWeaponComponent::FixedStep(float FixedDeltaTime)
+{
+	WR_PROFILE_SCOPE(Weapons);
+
 	// Handle reloading
 	if (bIsReloading)
 	{
-		float CurrentTime = GetWorld()->GetTimeSeconds();
-		if (CurrentTime - ReloadStartTime >= ReloadTime)
+		ReloadElapsed += FixedDeltaTime;
+		if (ReloadElapsed >= ReloadTime)
 		{
 			CurrentAmmo = MaxAmmo;
 			bIsReloading = false;
@@ -37,6 +107,8 @@ void UWRWeaponComponent::TickComponent(float DeltaTime, ELevelTick TickType, FAc
 
 void UWRWeaponComponent::FireWeapon()
 {
+	WR_PROFILE_SCOPE(Weapons);
+
 	if (!CanFire())
 	{
 		return;
@@ -60,6 +132,11 @@ void UWRWeaponComponent::FireWeapon()
 			break;
 	}
 
+	if (UWRReplaySubsystem* Replay = UWRReplaySubsystem::GetInstance(this))
+	{
+		Replay->RecordEvent(EWRReplayEventType::WeaponFired, GetOwner(), (int32)CurrentWeaponType, GetMuzzleLocation());
+	}
+
 	CurrentAmmo--;
 	
 	if (CurrentAmmo <= 0)
@@ -110,7 +187,7 @@ void UWRWeaponComponent::ReloadWeapon()
 	if (!bIsReloading && CurrentAmmo < MaxAmmo)
 	{
 		bIsReloading = true;
-		ReloadStartTime = GetWorld()->GetTimeSeconds();
+		ReloadElapsed = 0.0f;
 		UE_LOG(LogWastelandRacers, Log, TEXT("Reloading weapon..."));
 	}
 }
@@ -154,9 +231,9 @@ void UWRWeaponComponent::FireShotgun()
 	{
 		FVector SpreadDirection = BaseDirection;
 		SpreadDirection += FVector(
-			FMath::RandRange(-0.2f, 0.2f),
-			FMath::RandRange(-0.2f, 0.2f),
-			FMath::RandRange(-0.1f, 0.1f)
+			RandomStream.FRandRange(-0.2f, 0.2f),
+			RandomStream.FRandRange(-0.2f, 0.2f),
+			RandomStream.FRandRange(-0.1f, 0.1f)
 		);
 		SpreadDirection.Normalize();
 		
@@ -178,6 +255,17 @@ void UWRWeaponComponent::FireFlamethrower()
 
 void UWRWeaponComponent::SpawnProjectile(const FVector& StartLocation, const FVector& Direction)
 {
+	// Light rounds are simulated as data; only rockets need a full actor
+	if (CurrentWeaponType != EWeaponType::RocketLauncher && UWRBulletSubsystem::IsEnabled())
+	{
+		if (UWRBulletSubsystem* Bullets = UWRBulletSubsystem::GetInstance(this))
+		{
+			const FWRBallistics Ballistics = FWRBallistics::Get(CurrentWeaponType);
+			Bullets->FireBullet(StartLocation, Direction * Ballistics.Speed, Ballistics.GravityScale, WeaponDamage, Ballistics.LifeSpan, GetOwner());
+			return;
+		}
+	}
+
 	if (!ProjectileClass)
 	{
 		UE_LOG(LogWastelandRacers, Warning, TEXT("No projectile class set for weapon"));
@@ -190,18 +278,21 @@ void UWRWeaponComponent::SpawnProjectile(const FVector& StartLocation, const FVe
 		return;
 	}
 
-	FActorSpawnParameters SpawnParams;
-	SpawnParams.Owner = GetOwner();
-	SpawnParams.Instigator = Cast<APawn>(GetOwner());
+	const FTransform SpawnTransform(Direction.Rotation(), StartLocation);
+	APawn* Instigator = Cast<APawn>(GetOwner());
 
-	FRotator SpawnRotation = Direction.Rotation();
-	
-	AWRProjectile* Projectile = World->SpawnActor<AWRProjectile>(
-		ProjectileClass,
-		StartLocation,
-		SpawnRotation,
-		SpawnParams
-	);
+	AWRProjectile* Projectile = nullptr;
+	if (UWRActorPoolSubsystem* Pool = UWRActorPoolSubsystem::GetInstance(this))
+	{
+		Projectile = Pool->Acquire<AWRProjectile>(ProjectileClass, SpawnTransform, GetOwner(), Instigator);
+	}
+	else
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.Owner = GetOwner();
+		SpawnParams.Instigator = Instigator;
+		Projectile = World->SpawnActor<AWRProjectile>(ProjectileClass, SpawnTransform, SpawnParams);
+	}
 
 	if (Projectile)
 	{
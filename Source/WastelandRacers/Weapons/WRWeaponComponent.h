@@ -14,6 +14,16 @@ enum class EWeaponType : uint8
 	Flamethrower UMETA(DisplayName = "Flamethrower")
 };
 
+// One round of a weapon: muzzle speed in cm/s, gravity scale and lifetime in seconds
+struct FWRBallistics
+{
+	float Speed = 1200.0f;
+	float GravityScale = 0.1f;
+	float LifeSpan = 5.0f;
+
+	static FWRBallistics Get(EWeaponType WeaponType);
+};
+
 UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
 class WASTELANDRACERS_API UWRWeaponComponent : public UActorComponent
 {
@@ -24,10 +34,14 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
+	// Reload timing, run by UWRGameplayClock in the Weapons phase
+	void FixedStep(float FixedDeltaTime);
+
 	UFUNCTION(BlueprintCallable, Category = "Weapon")
 	void FireWeapon();
 
@@ -74,10 +88,26 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile")
 	TSubclassOf<class AWRProjectile> ProjectileClass;
 
+	// Projectiles added to the world's actor pool at BeginPlay; compare with wr.Pool.Stats high water marks.
+	// Only rockets need actors while the bullet subsystem is enabled.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile", meta = (ClampMin = "0"))
+	int32 PrewarmProjectiles = 5;
+
+	// Shared by every machine gun, shotgun and flamethrower round; reads the BulletPositions and BulletVelocities arrays
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile")
+	class UNiagaraSystem* BulletTrailSystem = nullptr;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile")
+	class UNiagaraSystem* BulletImpactEffect = nullptr;
+
 private:
 	float LastFireTime = 0.0f;
 	bool bIsReloading = false;
-	float ReloadStartTime = 0.0f;
+	float ReloadElapsed = 0.0f;
+	FDelegateHandle FixedStepHandle;
+
+	// Seeded from wr.RandomSeed so benchmark runs are reproducible
+	FRandomStream RandomStream;
 
 	void FireMachineGun();
 	void FireRocketLauncher();